@@ -0,0 +1,271 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * Measures the throughput and IOPS of random, fixed-size I/O to a file on
+ * the device under test, with the sync engine of posix_bdev (one pwrite or
+ * pread at a time) against io_uring and libaio at queue depths 1 to
+ * max_depth, for the engines Hermes was built with. The queues are driven
+ * with Poll, as posix_bdev's tasks drive them. Each test runs buffered and
+ * with O_DIRECT, reporting the growth of the process RSS and of the page
+ * cache; direct mode also times unaligned requests through a bounce pool.
+ * Runs without the Hermes runtime.
+ * */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <string>
+#include <hermes_shm/util/timer.h>
+#include <hermes_shm/util/config_parse.h>
+#include "hermes/hermes_types.h"
+#include "posix_bdev/io_uring_queue.h"
+#include "posix_bdev/aio_queue.h"
+#include "posix_bdev/bounce_pool.h"
+
+/** The random offsets of the I/Os */
+std::vector<size_t> MakeOffsets(size_t io_size, size_t file_size) {
+  std::vector<size_t> offs(file_size / io_size);
+  for (size_t i = 0; i < offs.size(); ++i) {
+    offs[i] = i * io_size;
+  }
+  std::mt19937_64 rng(offs.size());
+  std::shuffle(offs.begin(), offs.end(), rng);
+  return offs;
+}
+
+/** Print the rate of \a num_ios I/Os of \a io_size bytes */
+void Report(const std::string &name, bool is_write, size_t depth,
+            size_t io_size, size_t num_ios, hshm::Timer &t) {
+  HILOG(kInfo, "{} {} (depth={}, io_size={}): {} MBps, {} KIOPS",
+        name, is_write ? "write" : "read", depth, io_size,
+        (double)(num_ios * io_size) / t.GetUsec(),
+        (double)num_ios / t.GetMsec() / 1000);
+}
+
+/** A "Key: value kB" entry of a /proc file, in bytes */
+size_t ReadProcKb(const std::string &path, const std::string &key) {
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.compare(0, key.size(), key) == 0) {
+      return std::stoull(line.substr(key.size())) * 1024;
+    }
+  }
+  return 0;
+}
+
+/** Memory use of the process and the page cache */
+struct MemUsage {
+  size_t rss_;
+  size_t cached_;
+
+  MemUsage() {
+    rss_ = ReadProcKb("/proc/self/status", "VmRSS:");
+    cached_ = ReadProcKb("/proc/meminfo", "Cached:");
+  }
+
+  /** Print the growth since \a start */
+  void Report(const std::string &mode, const MemUsage &start) {
+    HILOG(kInfo, "{}: RSS grew {} MB, page cache grew {} MB", mode,
+          ((ssize_t)rss_ - (ssize_t)start.rss_) / (ssize_t)MEGABYTES(1),
+          ((ssize_t)cached_ - (ssize_t)start.cached_) /
+          (ssize_t)MEGABYTES(1));
+  }
+};
+
+/** One blocking pwrite / pread at a time, as the sync engine does */
+void SyncTest(const std::string &mode, int fd, bool is_write,
+              char *buf, size_t io_size, const std::vector<size_t> &offs) {
+  hshm::Timer t;
+  t.Resume();
+  for (size_t off : offs) {
+    ssize_t count = is_write ?
+        pwrite64(fd, buf, io_size, (off64_t)off) :
+        pread64(fd, buf, io_size, (off64_t)off);
+    if (count != (ssize_t)io_size) {
+      HELOG(kError, "Transferred {} bytes, but expected {}", count, io_size);
+    }
+  }
+  t.Pause();
+  Report(mode + " sync", is_write, 1, io_size, offs.size(), t);
+}
+
+/**
+ * Unaligned requests with O_DIRECT: each is copied through a block of the
+ * bounce pool, as posix_bdev does, instead of being transferred in place.
+ * */
+void BounceTest(int fd, bool is_write, char *buf, size_t io_size,
+                const std::vector<size_t> &offs) {
+  hermes::posix_bdev::BouncePool pool;
+  pool.Init(4096, 16);
+  char *unaligned = buf + 1;
+  size_t size = pool.AlignUp(io_size);
+  hshm::Timer t;
+  t.Resume();
+  for (size_t off : offs) {
+    char *bounce = pool.Allocate(size);
+    if (is_write) {
+      memcpy(bounce, unaligned, io_size - 1);
+    }
+    ssize_t count = is_write ?
+        pwrite64(fd, bounce, size, (off64_t)off) :
+        pread64(fd, bounce, size, (off64_t)off);
+    if (count != (ssize_t)size) {
+      HELOG(kError, "Transferred {} bytes, but expected {}", count, size);
+    }
+    if (!is_write) {
+      memcpy(unaligned, bounce, io_size - 1);
+    }
+    pool.Free(bounce, size);
+  }
+  t.Pause();
+  Report("direct bounce", is_write, 1, io_size, offs.size(), t);
+}
+
+using hermes::bdev::AsyncIo;
+
+/** Keep \a depth requests in flight on \a queue */
+template<typename QueueT>
+void AsyncTest(const std::string &name, QueueT &queue, bool is_write,
+               char *bufs, size_t io_size,
+               const std::vector<size_t> &offs, size_t depth) {
+  // Each slot is one task: it polls its I/O and starts the next
+  std::vector<AsyncIo> ios(depth);
+  std::vector<size_t> slot_off(depth, (size_t)-1);
+  size_t next = 0, done = 0;
+  hshm::Timer t;
+  t.Resume();
+  for (size_t i = 0; i < depth && next < offs.size(); ++i) {
+    slot_off[i] = offs[next++];
+  }
+  while (done < offs.size()) {
+    for (size_t i = 0; i < depth; ++i) {
+      if (slot_off[i] == (size_t)-1) {
+        continue;
+      }
+      char *buf = bufs + i * io_size;
+      if (!queue.Poll(ios[i], is_write, buf, io_size, slot_off[i])) {
+        continue;
+      }
+      if (ios[i].err_) {
+        HELOG(kError, "I/O failed: {}", strerror(-ios[i].err_));
+      }
+      ++done;
+      ios[i] = AsyncIo();
+      slot_off[i] = next < offs.size() ? offs[next++] : (size_t)-1;
+    }
+  }
+  t.Pause();
+  Report(name, is_write, depth, io_size, offs.size(), t);
+}
+
+#ifdef HERMES_IO_URING
+/** io_uring at queue depth \a depth */
+void UringTest(const std::string &mode, int fd, bool is_write, char *bufs, size_t io_size,
+               const std::vector<size_t> &offs, size_t depth,
+               bool register_bufs) {
+  hermes::posix_bdev::UringQueue ring;
+  if (!ring.Init(fd, depth)) {
+    return;
+  }
+  if (register_bufs) {
+    struct iovec iov;
+    iov.iov_base = bufs;
+    iov.iov_len = depth * io_size;
+    ring.RegisterBuffers({iov});
+  }
+  AsyncTest(mode + (register_bufs ? " io_uring(registered)" : " io_uring"),
+            ring, is_write, bufs, io_size, offs, depth);
+}
+#endif
+
+#ifdef HERMES_LIBAIO
+/** Kernel AIO at queue depth \a depth */
+void AioTest(const std::string &mode, int fd, bool is_write, char *bufs, size_t io_size,
+             const std::vector<size_t> &offs, size_t depth) {
+  hermes::posix_bdev::AioQueue aio;
+  if (!aio.Init(fd, depth)) {
+    return;
+  }
+  AsyncTest(mode + " libaio", aio, is_write, bufs, io_size, offs, depth);
+}
+#endif
+
+/** Run every engine on a file opened buffered or with O_DIRECT */
+void ModeTest(const std::string &path, bool direct, char *bufs,
+              size_t io_size, size_t file_size, size_t max_depth,
+              bool register_bufs) {
+  std::string mode = direct ? "direct" : "buffered";
+  int flags = O_CREAT | O_RDWR | O_TRUNC;
+  if (direct) {
+    flags |= O_DIRECT;
+  }
+  int fd = open(path.c_str(), flags, 0666);
+  if (fd < 0) {
+    HELOG(kError, "Could not open {} ({}): {}", path, mode, strerror(errno));
+    return;
+  }
+  if (ftruncate(fd, (off_t)file_size) < 0) {
+    HELOG(kFatal, "Could not size {}: {}", path, strerror(errno));
+  }
+  std::vector<size_t> offs = MakeOffsets(io_size, file_size);
+  MemUsage start;
+  for (bool is_write : {true, false}) {
+    SyncTest(mode, fd, is_write, bufs, io_size, offs);
+    if (direct) {
+      BounceTest(fd, is_write, bufs, io_size, offs);
+    }
+    for (size_t depth = 1; depth <= max_depth; depth *= 2) {
+#ifdef HERMES_IO_URING
+      UringTest(mode, fd, is_write, bufs, io_size, offs, depth,
+                register_bufs);
+#endif
+#ifdef HERMES_LIBAIO
+      AioTest(mode, fd, is_write, bufs, io_size, offs, depth);
+#endif
+    }
+  }
+  MemUsage().Report(mode, start);
+  // Drop the pages of the file, so the next mode starts from a clean cache
+  fsync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+  unlink(path.c_str());
+}
+
+void help() {
+  printf("USAGE: ./bdev_io_bench [path] [io_size (K/M/G)] "
+         "[file_size (K/M/G)] [max_depth] [register_bufs (0/1)]\n");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 6) {
+    help();
+    exit(1);
+  }
+  std::string path = argv[1];
+  size_t io_size = hshm::ConfigParse::ParseSize(argv[2]);
+  size_t file_size = hshm::ConfigParse::ParseSize(argv[3]);
+  size_t max_depth = std::stoull(argv[4]);
+  bool register_bufs = std::stoi(argv[5]) != 0;
+  char *bufs = reinterpret_cast<char*>(
+      aligned_alloc(4096, max_depth * io_size));
+  memset(bufs, 1, max_depth * io_size);
+  for (bool direct : {false, true}) {
+    ModeTest(path, direct, bufs, io_size, file_size, max_depth,
+             register_bufs);
+  }
+  free(bufs);
+}
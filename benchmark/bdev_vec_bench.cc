@@ -0,0 +1,171 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * Measures the system calls and throughput of writing and reading a blob
+ * placed in slabs of one size: one pwrite / pread per buffer, as PutBlob
+ * issued before, against the segments of a WriteV / ReadV task, merged and
+ * issued with pwritev / preadv as posix_bdev does. The slabs are laid out
+ * in device order, shuffled in groups of 16, or fully shuffled, as the
+ * free lists of a busy target hand them out. Runs without the Hermes
+ * runtime.
+ * */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <climits>
+#include <random>
+#include <string>
+#include <hermes_shm/util/timer.h>
+#include <hermes_shm/util/config_parse.h>
+#include "hermes/hermes_types.h"
+#include "hermes/slab_allocator.h"
+#include "bdev/io_segment.h"
+
+using hermes::BufferInfo;
+using hermes::bdev::IoRun;
+using hermes::bdev::IoSegment;
+
+/** The slabs of a blob of \a blob_size, shuffled in groups of \a group */
+std::vector<BufferInfo> MakeSlabs(size_t blob_size, size_t slab_size,
+                                  size_t group) {
+  hermes::SlabAllocator alloc;
+  std::vector<size_t> slab_sizes = {slab_size};
+  alloc.Init(hermes::TargetId(1, 1, 1), blob_size, slab_sizes);
+  std::vector<BufferInfo> bufs;
+  size_t alloc_size;
+  alloc.Allocate(blob_size, bufs, alloc_size);
+  if (group > 1) {
+    std::mt19937_64 rng(bufs.size());
+    for (size_t i = 0; i < bufs.size(); i += group) {
+      size_t end = std::min(i + group, bufs.size());
+      std::shuffle(bufs.begin() + i, bufs.begin() + end, rng);
+    }
+  } else if (group == 0) {
+    std::mt19937_64 rng(bufs.size());
+    std::shuffle(bufs.begin(), bufs.end(), rng);
+  }
+  return bufs;
+}
+
+/** Print the rate and system calls of \a reps transfers of \a blob_size */
+void Report(const std::string &name, bool is_write, size_t slab_size,
+            size_t blob_size, size_t reps, size_t syscalls, hshm::Timer &t) {
+  HILOG(kInfo, "{} {} (slab={}): {} syscalls / blob, {} MBps",
+        name, is_write ? "write" : "read", slab_size, syscalls / reps,
+        (double)(reps * blob_size) / t.GetUsec());
+}
+
+/** One pwrite / pread per buffer */
+void PerBufferTest(int fd, bool is_write, char *blob,
+                   const std::vector<BufferInfo> &bufs, size_t blob_size,
+                   size_t reps, const std::string &layout) {
+  size_t syscalls = 0;
+  hshm::Timer t;
+  t.Resume();
+  for (size_t rep = 0; rep < reps; ++rep) {
+    size_t off = 0;
+    for (const BufferInfo &buf : bufs) {
+      ssize_t count = is_write ?
+          pwrite64(fd, blob + off, buf.t_size_, (off64_t)buf.t_off_) :
+          pread64(fd, blob + off, buf.t_size_, (off64_t)buf.t_off_);
+      if (count != (ssize_t)buf.t_size_) {
+        HELOG(kError, "Transferred {} bytes, but expected {}",
+              count, buf.t_size_);
+      }
+      off += buf.t_size_;
+      ++syscalls;
+    }
+  }
+  t.Pause();
+  Report(layout + " per-buffer", is_write, bufs[0].t_size_, blob_size,
+         reps, syscalls, t);
+}
+
+/** One vectored task: segments merged into runs */
+void VectoredTest(int fd, bool is_write, char *blob,
+                  const std::vector<BufferInfo> &bufs, size_t blob_size,
+                  size_t reps, const std::string &layout) {
+  size_t syscalls = 0;
+  hshm::Timer t;
+  t.Resume();
+  for (size_t rep = 0; rep < reps; ++rep) {
+    std::vector<IoSegment> segs;
+    segs.reserve(bufs.size());
+    size_t off = 0;
+    for (const BufferInfo &buf : bufs) {
+      segs.emplace_back(blob + off, buf.t_off_, buf.t_size_);
+      off += buf.t_size_;
+    }
+    std::vector<IoRun> runs;
+    hermes::bdev::CoalesceSegments(segs, IOV_MAX, runs);
+    for (IoRun &run : runs) {
+      ssize_t count = is_write ?
+          pwritev64(fd, run.iov_.data(), (int)run.iov_.size(),
+                    (off64_t)run.off_) :
+          preadv64(fd, run.iov_.data(), (int)run.iov_.size(),
+                   (off64_t)run.off_);
+      if (count != (ssize_t)run.size_) {
+        HELOG(kError, "Transferred {} bytes, but expected {}",
+              count, run.size_);
+      }
+      ++syscalls;
+    }
+  }
+  t.Pause();
+  Report(layout + " vectored", is_write, bufs[0].t_size_, blob_size,
+         reps, syscalls, t);
+}
+
+void help() {
+  printf("USAGE: ./bdev_vec_bench [path] [blob_size (K/M/G)] [reps]\n");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    help();
+    exit(1);
+  }
+  std::string path = argv[1];
+  size_t blob_size = MEGABYTES(64);
+  size_t reps = 4;
+  if (argc > 2) {
+    blob_size = hshm::ConfigParse::ParseSize(argv[2]);
+  }
+  if (argc > 3) {
+    reps = std::stoull(argv[3]);
+  }
+  int fd = open(path.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0666);
+  if (fd < 0) {
+    HELOG(kFatal, "Could not open {}: {}", path, strerror(errno));
+  }
+  char *blob = reinterpret_cast<char*>(aligned_alloc(4096, blob_size));
+  memset(blob, 1, blob_size);
+  std::vector<std::pair<std::string, size_t>> layouts = {
+      {"contiguous", 1}, {"groups of 16", 16}, {"shuffled", 0}};
+  for (size_t slab_size = KILOBYTES(4); slab_size <= MEGABYTES(1);
+       slab_size *= 4) {
+    for (auto &layout : layouts) {
+      std::vector<BufferInfo> bufs =
+          MakeSlabs(blob_size, slab_size, layout.second);
+      for (bool is_write : {true, false}) {
+        PerBufferTest(fd, is_write, blob, bufs, blob_size, reps,
+                      layout.first);
+        VectoredTest(fd, is_write, blob, bufs, blob_size, reps,
+                     layout.first);
+      }
+    }
+  }
+  free(blob);
+  close(fd);
+  unlink(path.c_str());
+}
@@ -0,0 +1,189 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * Measures the latency of listing the blobs of a large bucket by name
+ * prefix, with the ordered name index of each lane against scanning the
+ * bucket's blobs and sorting the matches. Blobs are spread over lanes by
+ * name hash, as in the blob mdm. Runs without the Hermes runtime.
+ * */
+
+#include <string>
+#include <hermes_shm/util/timer.h>
+#include "hermes/hermes_types.h"
+#include "hermes/flat_hash_map.h"
+#include "hermes/blob_name_index.h"
+
+using hermes::BlobId;
+using hermes::BlobInfo;
+using hermes::BlobNameEntry;
+using hermes::BlobNameIndex;
+using hermes::TagId;
+
+typedef hermes::FlatHashMap<BlobId, BlobInfo> BLOB_MAP_T;
+
+/** Name of the i'th blob: a directory of 1000 files and a file */
+std::string MakeBlobName(size_t i) {
+  std::string file = std::to_string(i % 1000);
+  return "dir" + std::to_string(i / 1000) + "/file" +
+      std::string(3 - file.size(), '0') + file;
+}
+
+/** The lanes of one node's blob mdm */
+struct Lanes {
+  std::vector<BLOB_MAP_T> blob_maps_;
+  std::vector<BlobNameIndex> name_indexes_;
+
+  explicit Lanes(size_t num_lanes)
+      : blob_maps_(num_lanes), name_indexes_(num_lanes) {}
+
+  /** List as the ListBlobs task does: each lane, then merge */
+  std::vector<BlobNameEntry> List(const TagId &tag_id,
+                                  const std::string &prefix,
+                                  const std::string &start_after,
+                                  size_t limit) {
+    std::vector<BlobNameEntry> entries;
+    for (BlobNameIndex &name_index : name_indexes_) {
+      name_index.List(tag_id, prefix, start_after, limit, entries);
+    }
+    std::sort(entries.begin(), entries.end());
+    if (entries.size() > limit) {
+      entries.resize(limit);
+    }
+    return entries;
+  }
+
+  /** List by scanning every blob of the bucket */
+  std::vector<BlobNameEntry> Scan(const TagId &tag_id,
+                                  const std::string &prefix,
+                                  const std::string &start_after,
+                                  size_t limit) {
+    std::vector<BlobNameEntry> entries;
+    for (BLOB_MAP_T &blob_map : blob_maps_) {
+      for (BLOB_MAP_T::value_type &blob_part : blob_map) {
+        BlobInfo &blob_info = blob_part.second;
+        std::string_view name(blob_info.name_.data(),
+                              blob_info.name_.size());
+        if (blob_info.tag_id_ != tag_id ||
+            name.substr(0, prefix.size()) != prefix ||
+            name <= start_after) {
+          continue;
+        }
+        entries.emplace_back(std::string(name), blob_info.blob_id_);
+      }
+    }
+    std::sort(entries.begin(), entries.end());
+    if (entries.size() > limit) {
+      entries.resize(limit);
+    }
+    return entries;
+  }
+};
+
+/** Time \a reps listings of a 1000-blob directory, one page each */
+template<typename ListT>
+double TimeDirListing(size_t num_blobs, size_t reps, ListT &&list) {
+  hshm::Timer t;
+  size_t num_dirs = std::max<size_t>(num_blobs / 1000, 1);
+  for (size_t i = 0; i < reps; ++i) {
+    std::string prefix = "dir" + std::to_string(i % num_dirs) + "/";
+    t.Resume();
+    std::vector<BlobNameEntry> entries = list(prefix, "", 1000);
+    t.Pause();
+    if (entries.empty()) {
+      HELOG(kError, "Listing {} returned nothing", prefix);
+    }
+  }
+  return t.GetUsec() / reps;
+}
+
+void ListTest(size_t num_blobs, size_t num_lanes, size_t reps) {
+  TagId tag_id(1, 1, 1);
+  Lanes lanes(num_lanes);
+
+  // Create the blobs and index their names
+  hshm::Timer t_index;
+  for (size_t i = 0; i < num_blobs; ++i) {
+    std::string name = MakeBlobName(i);
+    u32 hash = std::hash<std::string>{}(name);
+    size_t lane = hash % num_lanes;
+    BlobId blob_id(1, hash, i);
+    BlobInfo &blob_info = lanes.blob_maps_[lane][blob_id];
+    blob_info.blob_id_ = blob_id;
+    blob_info.tag_id_ = tag_id;
+    blob_info.name_ = hshm::to_charbuf(name);
+    t_index.Resume();
+    lanes.name_indexes_[lane].Insert(
+        tag_id,
+        std::string_view(blob_info.name_.data(), blob_info.name_.size()),
+        blob_id);
+    t_index.Pause();
+  }
+  HILOG(kInfo, "Indexed {} blob names over {} lanes: {} nsec / insert",
+        num_blobs, num_lanes, t_index.GetNsec() / num_blobs);
+
+  // List a directory
+  double index_usec = TimeDirListing(
+      num_blobs, reps, [&](const std::string &prefix,
+                           const std::string &start_after, size_t limit) {
+        return lanes.List(tag_id, prefix, start_after, limit);
+      });
+  double scan_usec = TimeDirListing(
+      num_blobs, std::max<size_t>(reps / 100, 1),
+      [&](const std::string &prefix,
+          const std::string &start_after, size_t limit) {
+        return lanes.Scan(tag_id, prefix, start_after, limit);
+      });
+  HILOG(kInfo, "List a 1000-blob directory: index {} usec, scan {} usec",
+        index_usec, scan_usec);
+
+  // Page through the whole bucket
+  hshm::Timer t_pages;
+  size_t count = 0;
+  std::string start_after;
+  t_pages.Resume();
+  while (true) {
+    std::vector<BlobNameEntry> page =
+        lanes.List(tag_id, "", start_after, 1000);
+    count += page.size();
+    if (page.size() < 1000) {
+      break;
+    }
+    start_after = page.back().name_;
+  }
+  t_pages.Pause();
+  HILOG(kInfo, "Paged through {} blobs in {} msec", count, t_pages.GetMsec());
+}
+
+void help() {
+  printf("USAGE: ./blob_list_bench [num_blobs] [num_lanes] [reps]\n");
+}
+
+int main(int argc, char **argv) {
+  size_t num_blobs = 1000 * 1000;
+  size_t num_lanes = 16;
+  size_t reps = 1000;
+  if (argc > 1 && std::string(argv[1]) == "-h") {
+    help();
+    exit(0);
+  }
+  if (argc > 1) {
+    num_blobs = std::stoull(argv[1]);
+  }
+  if (argc > 2) {
+    num_lanes = std::stoull(argv[2]);
+  }
+  if (argc > 3) {
+    reps = std::stoull(argv[3]);
+  }
+  ListTest(num_blobs, num_lanes, reps);
+}
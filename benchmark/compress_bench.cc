@@ -0,0 +1,121 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * Measures the codecs the BORG uses when demoting blobs on a smooth
+ * double-precision field, as produced by simulations. Reports the
+ * compression ratio, codec throughput, and the effective bandwidth of a
+ * tier of the given bandwidth when buffers are compressed before
+ * being written to it. Runs without the Hermes runtime.
+ * */
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <hermes_shm/util/timer.h>
+#include "hermes/hermes_types.h"
+#include "hermes/compressor.h"
+
+using hermes::Codec;
+using hermes::CodecConv;
+using hermes::Compressor;
+
+/** Size of each buffer, as the BORG compresses one slab at a time */
+static const size_t kBufSize = MEGABYTES(1);
+
+/** A smooth field of doubles with a little noise in the low bits */
+void MakeField(std::vector<char> &data) {
+  size_t count = data.size() / sizeof(double);
+  double *field = reinterpret_cast<double*>(data.data());
+  for (size_t i = 0; i < count; ++i) {
+    double x = (double)i / 4096;
+    field[i] = 300 + 10 * sin(x) + cos(x / 7);
+    field[i] = round(field[i] * 1024) / 1024;
+  }
+}
+
+/** Compress and decompress \a size_mb megabytes in 1MB buffers */
+void CompressTest(Codec codec, size_t size_mb, double tier_mbps) {
+  std::vector<char> data(size_mb * kBufSize);
+  std::vector<char> comp(data.size());
+  std::vector<char> back(data.size());
+  std::vector<size_t> c_sizes(size_mb);
+  MakeField(data);
+
+  // Compress
+  hshm::Timer t_comp;
+  size_t c_total = 0;
+  t_comp.Resume();
+  for (size_t i = 0; i < size_mb; ++i) {
+    size_t off = i * kBufSize;
+    c_sizes[i] = Compressor::Compress(codec, data.data() + off, kBufSize,
+                                      comp.data() + off, kBufSize);
+    c_total += c_sizes[i] ? c_sizes[i] : kBufSize;
+  }
+  t_comp.Pause();
+
+  // Decompress
+  hshm::Timer t_decomp;
+  bool ok = true;
+  t_decomp.Resume();
+  for (size_t i = 0; i < size_mb; ++i) {
+    size_t off = i * kBufSize;
+    if (c_sizes[i] == 0) {
+      continue;
+    }
+    ok &= Compressor::Decompress(codec, comp.data() + off, c_sizes[i],
+                                 back.data() + off, kBufSize);
+  }
+  t_decomp.Pause();
+  for (size_t i = 0; i < size_mb; ++i) {
+    size_t off = i * kBufSize;
+    if (c_sizes[i] && memcmp(data.data() + off, back.data() + off, kBufSize)) {
+      ok = false;
+    }
+  }
+
+  // Writing ratio times less data, after compressing it
+  double ratio = (double)data.size() / c_total;
+  double comp_mbps = size_mb / t_comp.GetSec();
+  double decomp_mbps = size_mb / t_decomp.GetSec();
+  double eff_mbps = 1 / (1 / (tier_mbps * ratio) + 1 / comp_mbps);
+  HILOG(kInfo, "{}: ratio {}, compress {} MB/s, decompress {} MB/s, "
+        "effective tier bandwidth {} MB/s (raw {} MB/s), verified: {}",
+        CodecConv::to_str(codec), ratio, comp_mbps, decomp_mbps,
+        eff_mbps, tier_mbps, ok);
+}
+
+void help() {
+  printf("USAGE: ./compress_bench [codec] [size_mb] [tier_mbps]\n");
+  printf("codec: lz or shuffle_lz\n");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    help();
+    exit(1);
+  }
+  Codec codec = CodecConv::to_enum(argv[1]);
+  size_t size_mb = 256;
+  double tier_mbps = 500;
+  if (argc > 2) {
+    size_mb = std::stoull(argv[2]);
+  }
+  if (argc > 3) {
+    tier_mbps = std::stod(argv[3]);
+  }
+  if (codec != Codec::kLz && codec != Codec::kShuffleLz) {
+    help();
+    exit(1);
+  }
+  CompressTest(codec, size_mb, tier_mbps);
+}
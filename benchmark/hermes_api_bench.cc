@@ -31,6 +31,16 @@ void GatherTimes(std::string test_name, size_t io_size, MpiTimer &t) {
   }
 }
 
+/** Gather times per-process and report blobs destroyed per second */
+void GatherTeardownRate(std::string test_name, size_t num_blobs, MpiTimer &t) {
+  t.Collect();
+  if (t.rank_ == 0) {
+    double max = t.GetSec();
+    HILOG(kInfo, "{}: Time: {} sec, Blobs/sec: {}, Count: {}, Nprocs: {}\n",
+          test_name, max, num_blobs / max, num_blobs, t.nprocs_);
+  }
+}
+
 /** Each process PUTS into the same bucket, but with different blob names */
 void PutTest(int nprocs, int rank,
              int repeat, size_t blobs_per_rank, size_t blob_size) {
@@ -142,6 +152,139 @@ void PartialPutGetTest(int nprocs, int rank, int repeat,
   PartialGetTest(nprocs, rank, repeat, blobs_per_rank, blob_size, part_size);
 }
 
+/**
+ * Each process PUTs then GETs its blobs in batches of increasing size.
+ * A batch size of 1 is comparable to PutGetTest.
+ * */
+void MultiPutGetTest(int nprocs, int rank, size_t blobs_per_rank,
+                     size_t blob_size, size_t max_batch) {
+  hermes::Context ctx;
+  hermes::Bucket bkt(hshm::Formatter::format("MultiPutGet{}", rank), ctx);
+  for (size_t batch = 1; batch <= max_batch; batch *= 2) {
+    std::vector<std::string> names(batch);
+    std::vector<hermes::Blob> blobs(batch, hermes::Blob(blob_size));
+    MpiTimer put_t(MPI_COMM_WORLD);
+    put_t.Resume();
+    for (size_t i = 0; i < blobs_per_rank; i += batch) {
+      names.resize(std::min(batch, blobs_per_rank - i));
+      blobs.resize(names.size(), hermes::Blob(blob_size));
+      for (size_t j = 0; j < names.size(); ++j) {
+        names[j] = std::to_string(i + j);
+      }
+      bkt.MultiPut(names, blobs, ctx);
+    }
+    put_t.Pause();
+    GatherTimes(hshm::Formatter::format("MultiPut(batch={})", batch),
+                nprocs * blobs_per_rank * blob_size, put_t);
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    MpiTimer get_t(MPI_COMM_WORLD);
+    get_t.Resume();
+    for (size_t i = 0; i < blobs_per_rank; i += batch) {
+      names.resize(std::min(batch, blobs_per_rank - i));
+      blobs.resize(names.size(), hermes::Blob(blob_size));
+      for (size_t j = 0; j < names.size(); ++j) {
+        names[j] = std::to_string(i + j);
+      }
+      bkt.MultiGet(names, blobs, ctx);
+    }
+    get_t.Pause();
+    GatherTimes(hshm::Formatter::format("MultiGet(batch={})", batch),
+                nprocs * blobs_per_rank * blob_size, get_t);
+    MPI_Barrier(MPI_COMM_WORLD);
+  }
+}
+
+/** Bytes of the targets on this node in use */
+size_t GetUsedCapacity() {
+  std::vector<hermes::TargetStats> targets =
+      HERMES_CONF->blob_mdm_.PollTargetMetadataRoot();
+  size_t used = 0;
+  for (hermes::TargetStats &target : targets) {
+    used += target.max_cap_ - target.rem_cap_;
+  }
+  return used;
+}
+
+/**
+ * Each process PUTs checkpoints with HERMES_BLOB_DEDUP. The first
+ * dup_pct percent of the 1MB pages of each blob are identical across
+ * ranks and timesteps; the rest are unique. Reports the put throughput
+ * and the ratio of blob bytes to the target capacity they used.
+ * */
+void DedupTest(int nprocs, int rank, size_t blobs_per_rank,
+               size_t blob_size, size_t dup_pct) {
+  size_t page_size = MEGABYTES(1);
+  size_t num_pages = (blob_size + page_size - 1) / page_size;
+  size_t dup_pages = num_pages * dup_pct / 100;
+  MPI_Barrier(MPI_COMM_WORLD);
+  size_t used_start = GetUsedCapacity();
+  MpiTimer t(MPI_COMM_WORLD);
+  hermes::Context ctx;
+  ctx.flags_.SetBits(HERMES_BLOB_DEDUP);
+  hermes::Bucket bkt(hshm::Formatter::format("Dedup{}", rank), ctx);
+  hermes::Blob blob(blob_size);
+  t.Resume();
+  for (size_t i = 0; i < blobs_per_rank; ++i) {
+    for (size_t page = 0; page < num_pages; ++page) {
+      size_t seed = page;
+      if (page >= dup_pages) {
+        seed = ((rank * blobs_per_rank + i) * num_pages + page) << 20;
+      }
+      size_t off = page * page_size;
+      size_t size = std::min(page_size, blob_size - off);
+      size_t *words = reinterpret_cast<size_t*>(blob.data() + off);
+      for (size_t w = 0; w < size / sizeof(size_t); ++w) {
+        words[w] = seed + w;
+      }
+    }
+    bkt.AsyncPut(std::to_string(i), blob, ctx);
+  }
+  t.Pause();
+  GatherTimes("DedupPut", nprocs * blobs_per_rank * blob_size, t);
+  HRUN_ADMIN->FlushRoot(DomainId::GetGlobal());
+  MPI_Barrier(MPI_COMM_WORLD);
+  if (rank == 0) {
+    size_t used = GetUsedCapacity() - used_start;
+    double ratio = (double)(nprocs * blobs_per_rank * blob_size) / used;
+    HILOG(kInfo, "Dedup: {} bytes put, {} bytes of capacity used, "
+          "ratio {}", nprocs * blobs_per_rank * blob_size, used, ratio);
+  }
+}
+
+/**
+ * Latency of a small PartialGet at the tail of a blob as the blob grows.
+ * Blobs are built from part_size PartialPuts, so each spans many buffers.
+ * */
+void PartialGetLatencyTest(int nprocs, int rank, int repeat,
+                           size_t max_blob_size, size_t part_size) {
+  hermes::Context ctx;
+  hermes::Bucket bkt(hshm::Formatter::format("PartialGetLatency{}", rank),
+                     ctx);
+  hermes::Blob part(part_size);
+  hermes::Blob ret(part_size);
+  for (size_t blob_size = part_size; blob_size <= max_blob_size;
+       blob_size *= 2) {
+    std::string name = std::to_string(blob_size);
+    for (size_t off = 0; off < blob_size; off += part_size) {
+      bkt.PartialPut(name, part, off, ctx);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    MpiTimer t(MPI_COMM_WORLD);
+    t.Resume();
+    for (int j = 0; j < repeat; ++j) {
+      bkt.PartialGet(name, ret, blob_size - part_size, ctx);
+    }
+    t.Pause();
+    t.Collect();
+    if (t.rank_ == 0) {
+      HILOG(kInfo, "PartialGetLatency: BlobSize: {}, PartSize: {}, "
+            "Latency: {} usec/op, Nprocs: {}\n",
+            blob_size, part_size, t.GetUsec() / repeat, t.nprocs_);
+    }
+  }
+}
+
 /** Each process creates a set of buckets */
 void CreateBucketTest(int nprocs, int rank,
                       size_t bkts_per_rank) {
@@ -187,7 +330,8 @@ void DeleteBucketTest(int nprocs, int rank,
 
   // Create the buckets
   for (size_t i = 0; i < bkt_per_rank; ++i) {
-    hapi::Bucket bkt(hshm::Formatter::format("DeleteBucket{}", rank), ctx);
+    hapi::Bucket bkt(hshm::Formatter::format("DeleteBucket{}_{}", rank, i),
+                     ctx);
     hapi::Blob blob;
     for (size_t j = 0; j < blobs_per_bucket; ++j) {
       std::string name = std::to_string(j);
@@ -198,11 +342,84 @@ void DeleteBucketTest(int nprocs, int rank,
   // Delete the buckets
   t.Resume();
   for (size_t i = 0; i < bkt_per_rank; ++i) {
-    hapi::Bucket bkt(hshm::Formatter::format("DeleteBucket{}", rank), ctx);
+    hapi::Bucket bkt(hshm::Formatter::format("DeleteBucket{}_{}", rank, i),
+                     ctx);
     bkt.Destroy();
   }
   t.Pause();
   GatherTimes("DeleteBucket", nprocs * bkt_per_rank * blobs_per_bucket, t);
+  GatherTeardownRate("DeleteBucket",
+                     nprocs * bkt_per_rank * blobs_per_bucket, t);
+}
+
+/**
+ * Every process PUTs new blobs into one shared bucket, so every PUT grows
+ * the same bucket. Compare runs with mdm.size_flush_period_ms at 0 and
+ * above 0 across process counts to see the size updates coalesce.
+ * */
+void SharedBucketPutTest(int nprocs, int rank,
+                         size_t blobs_per_rank, size_t blob_size) {
+  MpiTimer t(MPI_COMM_WORLD);
+  hapi::Context ctx;
+  hapi::Bucket bkt("SharedBucket", ctx);
+  hapi::Blob blob(blob_size);
+  t.Resume();
+  for (size_t i = 0; i < blobs_per_rank; ++i) {
+    std::string name = std::to_string(rank * blobs_per_rank + i);
+    bkt.Put(name, blob, ctx);
+  }
+  t.Pause();
+  GatherTimes("SharedBucketPut", nprocs * blobs_per_rank, t);
+  MPI_Barrier(MPI_COMM_WORLD);
+  if (rank == 0) {
+    size_t expected = nprocs * blobs_per_rank * blob_size;
+    size_t size = bkt.GetSize();
+    if (size != expected) {
+      HELOG(kError, "Bucket size {} != expected {}", size, expected);
+    }
+  }
+}
+
+/** Each process appends to a single shared bucket */
+void AppendTest(int nprocs, int rank,
+                size_t appends_per_rank, size_t append_size,
+                size_t page_size, size_t lease_size) {
+  MpiTimer t(MPI_COMM_WORLD);
+  hapi::Context ctx;
+  hapi::Bucket bkt("AppendBucket", ctx);
+  hapi::Blob blob(append_size);
+  bkt.SetAppendLease(lease_size);
+  t.Resume();
+  for (size_t i = 0; i < appends_per_rank; ++i) {
+    bkt.Append(blob, page_size, ctx);
+  }
+  t.Pause();
+  GatherTimes(hshm::Formatter::format("Append(lease={})", lease_size),
+              nprocs * appends_per_rank * append_size, t);
+  MPI_Barrier(MPI_COMM_WORLD);
+  if (rank == 0) {
+    size_t expected = nprocs * appends_per_rank * append_size;
+    size_t size = bkt.GetSize();
+    if (size != expected) {
+      HELOG(kError, "Bucket size {} != expected {}", size, expected);
+    }
+  }
+}
+
+/** Each process clears the blobs of its own bucket */
+void ClearBucketTest(int nprocs, int rank,
+                     size_t blobs_per_rank, size_t blob_size) {
+  MpiTimer t(MPI_COMM_WORLD);
+  hapi::Context ctx;
+  hapi::Bucket bkt(hshm::Formatter::format("ClearBucket{}", rank), ctx);
+  hapi::Blob blob(blob_size);
+  for (size_t i = 0; i < blobs_per_rank; ++i) {
+    bkt.Put(std::to_string(i), blob, ctx);
+  }
+  t.Resume();
+  bkt.Clear();
+  t.Pause();
+  GatherTeardownRate("ClearBucket", nprocs * blobs_per_rank, t);
 }
 
 /** Each process deletes blobs from a single bucket */
@@ -228,12 +445,18 @@ void help() {
   printf("USAGE: ./api_bench put [blob_size (K/M/G)] [blobs_per_rank]\n");
   printf("USAGE: ./api_bench putget [blob_size (K/M/G)] [blobs_per_rank]\n");
   printf("USAGE: ./api_bench pputget [blob_size (K/M/G)] [part_size (K/M/G)] [blobs_per_rank]\n");
+  printf("USAGE: ./api_bench mputget [blob_size (K/M/G)] [blobs_per_rank] [max_batch]\n");
+  printf("USAGE: ./api_bench pget_lat [max_blob_size (K/M/G)] [part_size (K/M/G)] [repeat]\n");
+  printf("USAGE: ./api_bench dedup [blob_size (K/M/G)] [blobs_per_rank] [dup_pct]\n");
   printf("USAGE: ./api_bench create_bkt [bkts_per_rank]\n");
   printf("USAGE: ./api_bench get_bkt [bkts_per_rank]\n");
   printf("USAGE: ./api_bench create_blob_1bkt [blobs_per_rank]\n");
   printf("USAGE: ./api_bench create_blob_Nbkt [blobs_per_rank]\n");
   printf("USAGE: ./api_bench del_bkt [bkt_per_rank] [blobs_per_bkt]\n");
   printf("USAGE: ./api_bench del_blobs [blobs_per_rank]\n");
+  printf("USAGE: ./api_bench clear_bkt [blob_size (K/M/G)] [blobs_per_rank]\n");
+  printf("USAGE: ./api_bench shared_bkt_put [blob_size (K/M/G)] [blobs_per_rank]\n");
+  printf("USAGE: ./api_bench append [append_size (K/M/G)] [appends_per_rank] [page_size (K/M/G)] [lease_size (K/M/G)]\n");
   exit(1);
 }
 
@@ -274,6 +497,24 @@ int main(int argc, char **argv) {
       size_t part_size = hshm::ConfigParse::ParseSize(argv[3]);
       size_t blobs_per_rank = atoi(argv[4]);
       PartialPutGetTest(nprocs, rank, 1, blobs_per_rank, blob_size, part_size);
+    } else if (mode == "mputget") {
+      REQUIRE_ARGC(5)
+      size_t blob_size = hshm::ConfigParse::ParseSize(argv[2]);
+      size_t blobs_per_rank = atoi(argv[3]);
+      size_t max_batch = atoi(argv[4]);
+      MultiPutGetTest(nprocs, rank, blobs_per_rank, blob_size, max_batch);
+    } else if (mode == "pget_lat") {
+      REQUIRE_ARGC(5)
+      size_t max_blob_size = hshm::ConfigParse::ParseSize(argv[2]);
+      size_t part_size = hshm::ConfigParse::ParseSize(argv[3]);
+      int repeat = atoi(argv[4]);
+      PartialGetLatencyTest(nprocs, rank, repeat, max_blob_size, part_size);
+    } else if (mode == "dedup") {
+      REQUIRE_ARGC(5)
+      size_t blob_size = hshm::ConfigParse::ParseSize(argv[2]);
+      size_t blobs_per_rank = atoi(argv[3]);
+      size_t dup_pct = atoi(argv[4]);
+      DedupTest(nprocs, rank, blobs_per_rank, blob_size, dup_pct);
     } else if (mode == "create_bkt") {
       REQUIRE_ARGC(3)
       size_t bkts_per_rank = atoi(argv[2]);
@@ -291,6 +532,24 @@ int main(int argc, char **argv) {
       REQUIRE_ARGC(4)
       size_t blobs_per_rank = atoi(argv[2]);
       DeleteBlobOneBucket(nprocs, rank, blobs_per_rank);
+    } else if (mode == "clear_bkt") {
+      REQUIRE_ARGC(4)
+      size_t blob_size = hshm::ConfigParse::ParseSize(argv[2]);
+      size_t blobs_per_rank = atoi(argv[3]);
+      ClearBucketTest(nprocs, rank, blobs_per_rank, blob_size);
+    } else if (mode == "shared_bkt_put") {
+      REQUIRE_ARGC(4)
+      size_t blob_size = hshm::ConfigParse::ParseSize(argv[2]);
+      size_t blobs_per_rank = atoi(argv[3]);
+      SharedBucketPutTest(nprocs, rank, blobs_per_rank, blob_size);
+    } else if (mode == "append") {
+      REQUIRE_ARGC(6)
+      size_t append_size = hshm::ConfigParse::ParseSize(argv[2]);
+      size_t appends_per_rank = atoi(argv[3]);
+      size_t page_size = hshm::ConfigParse::ParseSize(argv[4]);
+      size_t lease_size = hshm::ConfigParse::ParseSize(argv[5]);
+      AppendTest(nprocs, rank, appends_per_rank, append_size,
+                 page_size, lease_size);
     }
   } catch (hshm::Error &err) {
     HELOG(kFatal, "Error: {}", err.what());
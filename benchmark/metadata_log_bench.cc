@@ -0,0 +1,175 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * Measures the cost of the blob metadata log and the time to reload the
+ * blob table after a restart, from the log alone and from a snapshot,
+ * as the number of blobs grows. Runs without the Hermes runtime.
+ * */
+
+#include <sys/stat.h>
+#include <string>
+#include <hermes_shm/util/timer.h>
+#include "hermes/hermes_types.h"
+#include "hermes/flat_hash_map.h"
+#include "hermes/metadata_log.h"
+
+using hermes::BlobId;
+using hermes::BlobInfo;
+using hermes::BufferInfo;
+using hermes::LogOp;
+using hermes::MetadataLog;
+using hermes::TagId;
+
+typedef hermes::FlatHashMap<BlobId, BlobInfo> BLOB_MAP_T;
+
+/** Size of a file, or 0 if it does not exist */
+size_t GetFileSize(const std::string &path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    return 0;
+  }
+  return st.st_size;
+}
+
+/** Fill a blob the way the blob mdm does after a put */
+void MakeBlob(size_t i, size_t bufs_per_blob, BlobInfo &blob_info) {
+  TagId tag_id(1, 1, 1);
+  blob_info.blob_id_ = BlobId(1, 0, i);
+  blob_info.tag_id_ = tag_id;
+  blob_info.name_ = hshm::to_charbuf("blob_" + std::to_string(i));
+  blob_info.blob_size_ = bufs_per_blob * MEGABYTES(1);
+  blob_info.max_blob_size_ = blob_info.blob_size_;
+  blob_info.score_ = 1;
+  blob_info.user_score_ = 1;
+  blob_info.mod_count_ = 1;
+  blob_info.last_flush_ = 0;
+  blob_info.access_freq_ = 0;
+  for (size_t j = 0; j < bufs_per_blob; ++j) {
+    BufferInfo buf;
+    buf.tid_ = hermes::TargetId(1, 0, 0);
+    buf.t_slab_ = 0;
+    buf.t_off_ = (i * bufs_per_blob + j) * MEGABYTES(1);
+    buf.t_size_ = MEGABYTES(1);
+    blob_info.buffers_.emplace_back(buf);
+  }
+}
+
+/** Reload the blob table from the log and snapshot, as after a restart */
+size_t Restart(MetadataLog &log, BLOB_MAP_T &blob_map) {
+  return log.Replay([&](LogOp op, cereal::BinaryInputArchive &ar) {
+    BlobId blob_id;
+    ar(blob_id);
+    if (op == LogOp::kPutBlob) {
+      BlobInfo &blob_info = blob_map[blob_id];
+      ar(blob_info);
+      blob_info.RebuildExtents();
+    } else if (op == LogOp::kDelBlob) {
+      blob_map.erase(blob_id);
+    }
+  });
+}
+
+/** Log \a num_blobs puts, then restart from the log and from a snapshot */
+void RestartTest(const std::string &dir, size_t num_blobs,
+                 size_t bufs_per_blob) {
+  std::string name = "metadata_log_bench";
+  std::string log_path = dir + "/" + name + ".log";
+  std::string snap_path = dir + "/" + name + ".snap";
+  remove(log_path.c_str());
+  remove(snap_path.c_str());
+
+  // Log every put, as the blob mdm does
+  BLOB_MAP_T blob_map;
+  hshm::Timer t_log;
+  {
+    MetadataLog log;
+    log.Init(dir, name);
+    log.Snapshot([](MetadataLog::Writer &writer) {});
+    for (size_t i = 0; i < num_blobs; ++i) {
+      BlobInfo &blob_info = blob_map[BlobId(1, 0, i)];
+      MakeBlob(i, bufs_per_blob, blob_info);
+      t_log.Resume();
+      log.Append(LogOp::kPutBlob, blob_info.blob_id_, blob_info);
+      t_log.Pause();
+    }
+  }
+  size_t log_size = GetFileSize(log_path);
+  HILOG(kInfo, "Logged {} blobs: {} bytes, {} usec / put",
+        num_blobs, log_size, t_log.GetUsec() / num_blobs);
+
+  // Restart from the log
+  hshm::Timer t_log_restart;
+  {
+    BLOB_MAP_T recovered;
+    MetadataLog log;
+    log.Init(dir, name);
+    t_log_restart.Resume();
+    size_t count = Restart(log, recovered);
+    t_log_restart.Pause();
+    HILOG(kInfo, "Restart from log: {} blobs in {} msec ({} records)",
+          recovered.size(), t_log_restart.GetMsec(), count);
+  }
+
+  // Snapshot, then restart from the snapshot
+  hshm::Timer t_snap;
+  {
+    MetadataLog log;
+    log.Init(dir, name);
+    BLOB_MAP_T scratch;
+    Restart(log, scratch);
+    t_snap.Resume();
+    log.Snapshot([&](MetadataLog::Writer &writer) {
+      for (BLOB_MAP_T::value_type &blob_part : blob_map) {
+        writer.Append(LogOp::kPutBlob, blob_part.first, blob_part.second);
+      }
+    });
+    t_snap.Pause();
+  }
+  size_t snap_size = GetFileSize(snap_path);
+  hshm::Timer t_snap_restart;
+  {
+    BLOB_MAP_T recovered;
+    MetadataLog log;
+    log.Init(dir, name);
+    t_snap_restart.Resume();
+    size_t count = Restart(log, recovered);
+    t_snap_restart.Pause();
+    HILOG(kInfo, "Snapshot: {} bytes in {} msec. Restart from snapshot: "
+          "{} blobs in {} msec ({} records)",
+          snap_size, t_snap.GetMsec(), recovered.size(),
+          t_snap_restart.GetMsec(), count);
+  }
+  remove(log_path.c_str());
+  remove(snap_path.c_str());
+}
+
+void help() {
+  printf("USAGE: ./metadata_log_bench [dir] [num_blobs] [bufs_per_blob]\n");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    help();
+    exit(1);
+  }
+  std::string dir = argv[1];
+  size_t num_blobs = 1000 * 1000;
+  size_t bufs_per_blob = 1;
+  if (argc > 2) {
+    num_blobs = std::stoull(argv[2]);
+  }
+  if (argc > 3) {
+    bufs_per_blob = std::stoull(argv[3]);
+  }
+  RestartTest(dir, num_blobs, bufs_per_blob);
+}
@@ -0,0 +1,198 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * Compares the blob metadata tables of the blob mdm (blob name -> id and
+ * id -> BlobInfo) against std::unordered_map tables keyed by serialized
+ * names. Reports resident memory per blob and lookups per second.
+ * Runs without the Hermes runtime.
+ * */
+
+#include <unistd.h>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <hermes_shm/util/timer.h>
+#include "hermes/hermes_types.h"
+#include "hermes/flat_hash_map.h"
+
+using hermes::BlobId;
+using hermes::BlobInfo;
+using hermes::TagId;
+using hermes::BlobNameKey;
+using hermes::BlobNameHash;
+
+/** Resident set size of this process in bytes */
+size_t GetRss() {
+  std::ifstream statm("/proc/self/statm");
+  size_t pages = 0, rss = 0;
+  statm >> pages >> rss;
+  return rss * sysconf(_SC_PAGESIZE);
+}
+
+/** The name of the i'th blob */
+hshm::charbuf MakeBlobName(size_t i) {
+  return hshm::to_charbuf("blob_" + std::to_string(i));
+}
+
+/** Hash of a blob name, as computed by clients to route requests */
+u32 HashName(const TagId &tag_id, const hshm::charbuf &name) {
+  return std::hash<std::string_view>{}(
+      std::string_view(name.data(), name.size())) ^ std::hash<TagId>{}(tag_id);
+}
+
+/**
+ * The blob mdm tables: the name -> id key views the name interned in the
+ * BlobInfo and carries the routing hash.
+ * */
+struct FlatMaps {
+  hermes::FlatHashMap<BlobNameKey, BlobId, BlobNameHash> blob_id_map_;
+  hermes::FlatHashMap<BlobId, BlobInfo> blob_map_;
+
+  BlobInfo& Insert(const TagId &tag_id, const hshm::charbuf &name,
+                   const BlobId &blob_id) {
+    BlobInfo &blob_info = blob_map_[blob_id];
+    blob_info.name_ = name;
+    blob_id_map_.emplace(
+        BlobNameKey(tag_id, blob_info.name_, HashName(tag_id, name)),
+        blob_id);
+    return blob_info;
+  }
+
+  bool FindName(const TagId &tag_id, const hshm::charbuf &name) {
+    return blob_id_map_.find(
+        BlobNameKey(tag_id, name, HashName(tag_id, name))) !=
+        blob_id_map_.end();
+  }
+
+  bool FindId(const BlobId &blob_id) {
+    return blob_map_.find(blob_id) != blob_map_.end();
+  }
+};
+
+/**
+ * The previous tables: the name -> id key is a serialized copy of
+ * the tag id and name, built again for every lookup.
+ * */
+struct StdMaps {
+  std::unordered_map<hshm::charbuf, BlobId> blob_id_map_;
+  std::unordered_map<BlobId, BlobInfo> blob_map_;
+
+  static hshm::charbuf GetBlobNameWithBucket(const TagId &tag_id,
+                                             const hshm::charbuf &name) {
+    hshm::charbuf new_name(sizeof(TagId) + name.size());
+    hrun::LocalSerialize srl(new_name);
+    srl << tag_id;
+    srl << name;
+    return new_name;
+  }
+
+  BlobInfo& Insert(const TagId &tag_id, const hshm::charbuf &name,
+                   const BlobId &blob_id) {
+    blob_id_map_.emplace(GetBlobNameWithBucket(tag_id, name), blob_id);
+    BlobInfo &blob_info = blob_map_[blob_id];
+    blob_info.name_ = name;
+    return blob_info;
+  }
+
+  bool FindName(const TagId &tag_id, const hshm::charbuf &name) {
+    return blob_id_map_.find(GetBlobNameWithBucket(tag_id, name)) !=
+        blob_id_map_.end();
+  }
+
+  bool FindId(const BlobId &blob_id) {
+    return blob_map_.find(blob_id) != blob_map_.end();
+  }
+};
+
+/** Fill the maps, then look up random names and ids */
+template<typename MAPS_T>
+void MapTest(const std::string &map_name,
+             size_t num_blobs, size_t num_lookups) {
+  TagId tag_id(1, 1, 1);
+  size_t rss_start = GetRss();
+  hshm::Timer t;
+  MAPS_T *maps = new MAPS_T();
+
+  // Insert
+  t.Resume();
+  for (size_t i = 0; i < num_blobs; ++i) {
+    BlobId blob_id(1, 0, i);
+    BlobInfo &blob_info = maps->Insert(tag_id, MakeBlobName(i), blob_id);
+    blob_info.blob_id_ = blob_id;
+    blob_info.tag_id_ = tag_id;
+  }
+  t.Pause();
+  size_t rss_end = GetRss();
+  HILOG(kInfo, "{}: Inserted {} blobs in {} sec, {} bytes / blob",
+        map_name, num_blobs, t.GetSec(),
+        (double)(rss_end - rss_start) / num_blobs);
+
+  // Look up by name
+  std::mt19937_64 rng(12345);
+  std::vector<hshm::charbuf> names;
+  names.reserve(1024);
+  for (size_t i = 0; i < 1024; ++i) {
+    names.emplace_back(MakeBlobName(rng() % num_blobs));
+  }
+  size_t found = 0;
+  hshm::Timer t_name;
+  t_name.Resume();
+  for (size_t i = 0; i < num_lookups; ++i) {
+    found += maps->FindName(tag_id, names[i % names.size()]);
+  }
+  t_name.Pause();
+  HILOG(kInfo, "{}: Name lookups: {} Mops/sec ({} found)",
+        map_name, num_lookups / t_name.GetUsec(), found);
+
+  // Look up by id
+  found = 0;
+  hshm::Timer t_id;
+  t_id.Resume();
+  for (size_t i = 0; i < num_lookups; ++i) {
+    found += maps->FindId(BlobId(1, 0, rng() % num_blobs));
+  }
+  t_id.Pause();
+  HILOG(kInfo, "{}: Id lookups: {} Mops/sec ({} found)",
+        map_name, num_lookups / t_id.GetUsec(), found);
+  delete maps;
+}
+
+void help() {
+  printf("USAGE: ./metadata_map_bench [map] [num_blobs] [num_lookups]\n");
+  printf("map: flat or std\n");
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    help();
+    exit(1);
+  }
+  std::string map = argv[1];
+  size_t num_blobs = 10 * 1000 * 1000;
+  size_t num_lookups = 10 * 1000 * 1000;
+  if (argc > 2) {
+    num_blobs = std::stoull(argv[2]);
+  }
+  if (argc > 3) {
+    num_lookups = std::stoull(argv[3]);
+  }
+  if (map == "flat") {
+    MapTest<FlatMaps>("flat", num_blobs, num_lookups);
+  } else if (map == "std") {
+    MapTest<StdMaps>("std", num_blobs, num_lookups);
+  } else {
+    help();
+    exit(1);
+  }
+}
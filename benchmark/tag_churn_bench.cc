@@ -0,0 +1,134 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/**
+ * Measures blob churn in a large bucket: adding blobs to a tag, deleting
+ * and recreating them in random order, and listing the members, with the
+ * BlobIdSet of TagInfo against a std::list with a linear remove.
+ * Runs without the Hermes runtime.
+ * */
+
+#include <list>
+#include <random>
+#include <string>
+#include <hermes_shm/util/timer.h>
+#include "hermes/hermes_types.h"
+
+using hermes::BlobId;
+using hermes::BlobIdSet;
+
+/** The members of a tag as a std::list, as TagInfo kept them before */
+struct BlobIdList {
+  std::list<BlobId> ids_;
+
+  bool emplace(const BlobId &blob_id) {
+    ids_.emplace_back(blob_id);
+    return true;
+  }
+  bool erase(const BlobId &blob_id) {
+    auto it = std::find(ids_.begin(), ids_.end(), blob_id);
+    if (it == ids_.end()) {
+      return false;
+    }
+    ids_.erase(it);
+    return true;
+  }
+  size_t size() const { return ids_.size(); }
+  std::list<BlobId>::const_iterator begin() const { return ids_.begin(); }
+  std::list<BlobId>::const_iterator end() const { return ids_.end(); }
+};
+
+/** Add \a num_blobs to a tag, churn \a num_churn of them, then list */
+template<typename SetT>
+void ChurnTest(const std::string &name, size_t num_blobs, size_t num_churn) {
+  std::vector<BlobId> blob_ids;
+  blob_ids.reserve(num_blobs);
+  for (size_t i = 0; i < num_blobs; ++i) {
+    blob_ids.emplace_back(1, 0, i);
+  }
+  std::mt19937_64 rng(num_blobs);
+  SetT blobs;
+
+  // Create the blobs
+  hshm::Timer t_add;
+  t_add.Resume();
+  for (BlobId &blob_id : blob_ids) {
+    blobs.emplace(blob_id);
+  }
+  t_add.Pause();
+
+  // Delete and recreate random blobs, as a rewrite workload does
+  hshm::Timer t_churn;
+  t_churn.Resume();
+  for (size_t i = 0; i < num_churn; ++i) {
+    BlobId &blob_id = blob_ids[rng() % num_blobs];
+    blobs.erase(blob_id);
+    blobs.emplace(blob_id);
+  }
+  t_churn.Pause();
+
+  // List the members, as GetContainedBlobIds does
+  hshm::Timer t_list;
+  t_list.Resume();
+  std::vector<BlobId> contained;
+  contained.reserve(blobs.size());
+  for (const BlobId &blob_id : blobs) {
+    contained.emplace_back(blob_id);
+  }
+  t_list.Pause();
+
+  // Delete every blob in random order
+  std::shuffle(blob_ids.begin(), blob_ids.end(), rng);
+  hshm::Timer t_del;
+  t_del.Resume();
+  for (BlobId &blob_id : blob_ids) {
+    blobs.erase(blob_id);
+  }
+  t_del.Pause();
+  if (contained.size() != num_blobs || blobs.size() != 0) {
+    HELOG(kError, "{}: listed {} of {} blobs, {} left after delete",
+          name, contained.size(), num_blobs, blobs.size());
+  }
+  HILOG(kInfo, "{} ({} blobs): add {} nsec / blob, churn {} nsec / op, "
+        "list {} msec, delete {} nsec / blob",
+        name, num_blobs, t_add.GetNsec() / num_blobs,
+        t_churn.GetNsec() / std::max<size_t>(num_churn, 1),
+        t_list.GetMsec(), t_del.GetNsec() / num_blobs);
+}
+
+void help() {
+  printf("USAGE: ./tag_churn_bench [num_blobs] [num_churn] [list_max]\n");
+}
+
+int main(int argc, char **argv) {
+  size_t num_blobs = 100 * 1000;
+  size_t num_churn = 100 * 1000;
+  size_t list_max = 100 * 1000;
+  if (argc > 1 && std::string(argv[1]) == "-h") {
+    help();
+    exit(0);
+  }
+  if (argc > 1) {
+    num_blobs = std::stoull(argv[1]);
+  }
+  if (argc > 2) {
+    num_churn = std::stoull(argv[2]);
+  }
+  if (argc > 3) {
+    list_max = std::stoull(argv[3]);
+  }
+  ChurnTest<BlobIdSet>("BlobIdSet", num_blobs, num_churn);
+  // The list is quadratic: only run it on buckets it can finish
+  if (num_blobs <= list_max) {
+    ChurnTest<BlobIdList>("std::list", num_blobs, num_churn);
+  }
+}
@@ -61,6 +61,8 @@ class TaskLib;
 #define TASK_FLUSH BIT_OPT(u32, 20)
 /** This task is considered a root task */
 #define TASK_IS_ROOT BIT_OPT(u32, 21)
+/** This task is background work and yields to foreground tasks */
+#define TASK_BACKGROUND BIT_OPT(u32, 22)
 /** This task is apart of remote debugging */
 #define TASK_REMOTE_DEBUG_MARK BIT_OPT(u32, 31)
 
@@ -392,6 +394,11 @@ struct Task : public hipc::ShmContainer {
     task_flags_.UnsetBits(TASK_COROUTINE);
   }
 
+  /** This task is background work */
+  HSHM_ALWAYS_INLINE bool IsBackground() {
+    return task_flags_.Any(TASK_BACKGROUND);
+  }
+
   /** This task should be dispersed across all lanes */
   HSHM_ALWAYS_INLINE bool IsLaneAll() {
     return task_flags_.Any(TASK_LANE_ALL);
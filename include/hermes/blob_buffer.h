@@ -0,0 +1,112 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HERMES_INCLUDE_HERMES_BLOB_BUFFER_H_
+#define HERMES_INCLUDE_HERMES_BLOB_BUFFER_H_
+
+#include "hermes/hermes_types.h"
+
+namespace hermes {
+
+/**
+ * Blob data stored in the runtime's shared-memory data segment.
+ * The buffer is freed when the handle is destroyed, unless ownership
+ * was handed to a task (e.g., by Bucket::PutBuffer).
+ * */
+class BlobBuffer {
+ public:
+  hipc::LPointer<char> p_;  /**< The shared-memory buffer */
+  size_t size_;             /**< Number of valid bytes in the buffer */
+
+ public:
+  /** Default constructor */
+  BlobBuffer() : size_(0) {
+    p_.ptr_ = nullptr;
+  }
+
+  /** Allocate a buffer of \a size bytes */
+  explicit BlobBuffer(size_t size)
+      : p_(HRUN_CLIENT->AllocateBufferClient(size)), size_(size) {}
+
+  /** Take ownership of an existing buffer */
+  BlobBuffer(const hipc::LPointer<char> &p, size_t size)
+      : p_(p), size_(size) {}
+
+  /** Destructor */
+  ~BlobBuffer() {
+    Free();
+  }
+
+  /** Buffers are uniquely owned */
+  BlobBuffer(const BlobBuffer &other) = delete;
+  BlobBuffer& operator=(const BlobBuffer &other) = delete;
+
+  /** Move constructor */
+  BlobBuffer(BlobBuffer &&other) noexcept
+      : p_(other.p_), size_(other.size_) {
+    other.p_.ptr_ = nullptr;
+    other.size_ = 0;
+  }
+
+  /** Move assignment */
+  BlobBuffer& operator=(BlobBuffer &&other) noexcept {
+    if (this != &other) {
+      Free();
+      p_ = other.p_;
+      size_ = other.size_;
+      other.p_.ptr_ = nullptr;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  /** Get the data pointer */
+  char* data() {
+    return p_.ptr_;
+  }
+
+  /** Get the data pointer (const) */
+  const char* data() const {
+    return p_.ptr_;
+  }
+
+  /** Get the number of valid bytes */
+  size_t size() const {
+    return size_;
+  }
+
+  /** Check if the buffer is empty */
+  bool IsNull() const {
+    return p_.ptr_ == nullptr;
+  }
+
+  /** Give up ownership of the buffer */
+  hipc::Pointer Release() {
+    hipc::Pointer shm = p_.shm_;
+    p_.ptr_ = nullptr;
+    size_ = 0;
+    return shm;
+  }
+
+  /** Free the buffer */
+  void Free() {
+    if (p_.ptr_ != nullptr) {
+      HRUN_CLIENT->FreeBuffer(p_.shm_);
+      p_.ptr_ = nullptr;
+      size_ = 0;
+    }
+  }
+};
+
+}  // namespace hermes
+
+#endif  // HERMES_INCLUDE_HERMES_BLOB_BUFFER_H_
@@ -0,0 +1,88 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HERMES_INCLUDE_HERMES_BLOB_NAME_INDEX_H_
+#define HERMES_INCLUDE_HERMES_BLOB_NAME_INDEX_H_
+
+#include <map>
+#include <string_view>
+#include "hermes/hermes_types.h"
+#include "hermes/flat_hash_map.h"
+
+namespace hermes {
+
+/**
+ * Blob names of each tag in sorted order, for prefix listing and range
+ * scans. Like the name -> id map, the index views the names interned in
+ * the BlobInfos, so a name must be erased before its BlobInfo renames or
+ * frees it. One index per lane: a listing merges the lanes' answers.
+ * */
+class BlobNameIndex {
+ public:
+  typedef std::map<std::string_view, BlobId> NAME_MAP_T;
+
+  FlatHashMap<TagId, NAME_MAP_T> tags_;
+
+ public:
+  /** Index \a name of \a blob_id in \a tag_id */
+  void Insert(const TagId &tag_id, std::string_view name,
+              const BlobId &blob_id) {
+    tags_[tag_id].emplace(name, blob_id);
+  }
+
+  /** Stop indexing \a name in \a tag_id */
+  void Erase(const TagId &tag_id, std::string_view name) {
+    auto it = tags_.find(tag_id);
+    if (it == tags_.end()) {
+      return;
+    }
+    it->second.erase(name);
+    if (it->second.empty()) {
+      tags_.erase(it);
+    }
+  }
+
+  /**
+   * Append to \a entries up to \a limit names of \a tag_id starting with
+   * \a prefix and sorting after \a start_after, in order.
+   * */
+  void List(const TagId &tag_id, std::string_view prefix,
+            std::string_view start_after, size_t limit,
+            std::vector<BlobNameEntry> &entries) const {
+    auto tag_it = tags_.find(tag_id);
+    if (tag_it == tags_.end()) {
+      return;
+    }
+    const NAME_MAP_T &names = tag_it->second;
+    auto it = names.lower_bound(prefix);
+    if (!start_after.empty() && start_after >= prefix) {
+      it = names.upper_bound(start_after);
+    }
+    for (size_t count = 0; it != names.end() && count < limit;
+         ++it, ++count) {
+      if (it->first.substr(0, prefix.size()) != prefix) {
+        break;
+      }
+      entries.emplace_back(std::string(it->first), it->second);
+    }
+  }
+
+  /** Number of names indexed in \a tag_id */
+  size_t size(const TagId &tag_id) const {
+    auto it = tags_.find(tag_id);
+    return it == tags_.end() ? 0 : it->second.size();
+  }
+};
+
+}  // namespace hermes
+
+#endif  // HERMES_INCLUDE_HERMES_BLOB_NAME_INDEX_H_
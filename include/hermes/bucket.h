@@ -14,14 +14,46 @@
 #define HRUN_TASKS_HERMES_CONF_INCLUDE_HERMES_CONF_BUCKET_H_
 
 #include "hermes/hermes_types.h"
+#include "hermes/blob_buffer.h"
 #include "hermes_mdm/hermes_mdm.h"
 #include "hermes/config_manager.h"
+#include "hermes_adapters/mapper/abstract_mapper.h"
 
 namespace hermes {
 
 #include "hrun/hrun_namespace.h"
 using hermes::blob_mdm::PutBlobTask;
 using hermes::blob_mdm::GetBlobTask;
+using hermes::blob_mdm::MultiPutBlobTask;
+using hermes::blob_mdm::MultiGetBlobTask;
+using hermes::blob_mdm::MultiGetBlobSizeTask;
+using hermes::blob_mdm::BlobIoEntry;
+
+/**
+ * A range of a bucket reserved for the appends of one bucket handle.
+ * Copies of a handle do not inherit the range, so two handles never
+ * append to the same bytes.
+ * */
+struct AppendLease {
+  size_t size_ = 0;     /**< Bytes reserved at a time (0: each append) */
+  size_t off_ = 0;      /**< Next unused byte of the range */
+  size_t end_ = 0;      /**< End of the range */
+  bitfield32_t flags_;  /**< Flags of the bucket */
+
+  /** Default constructor */
+  AppendLease() = default;
+
+  /** Copy constructor. Keeps the lease size, not the range. */
+  AppendLease(const AppendLease &other) : size_(other.size_) {}
+
+  /** Copy assignment. Keeps the lease size, not the range. */
+  AppendLease& operator=(const AppendLease &other) {
+    size_ = other.size_;
+    off_ = 0;
+    end_ = 0;
+    return *this;
+  }
+};
 
 class Bucket {
  public:
@@ -32,6 +64,7 @@ class Bucket {
   std::string name_;
   Context ctx_;
   bitfield32_t flags_;
+  AppendLease append_lease_;
 
  public:
   /**====================================
@@ -131,9 +164,13 @@ class Bucket {
   }
 
   /**
-   * Get the current size of the bucket
+   * Get the current size of the bucket. Size changes reach the bucket in
+   * batches; an \a exact read first applies those still in flight.
    * */
-  size_t GetSize() {
+  size_t GetSize(bool exact = true) {
+    if (exact) {
+      blob_mdm_->FlushSizeDeltasRoot(id_);
+    }
     return bkt_mdm_->GetSizeRoot(id_);
   }
 
@@ -148,7 +185,9 @@ class Bucket {
    * Clears the buckets contents, but doesn't destroy its metadata
    * */
   void Clear() {
+    blob_mdm_->FlushSizeDeltasRoot(id_);
     bkt_mdm_->TagClearBlobsRoot(id_);
+    append_lease_ = AppendLease(append_lease_);
   }
 
   /**
@@ -209,9 +248,25 @@ class Bucket {
   Status TagBlob(BlobId &blob_id,
                  TagId &tag_id) {
     bkt_mdm_->TagAddBlobRoot(tag_id, blob_id);
+    blob_mdm_->TagBlobRoot(id_, blob_id, tag_id);
     return Status();
   }
 
+  /**
+   * Check whether \a blob_id blob is labeled with \a tag_id TAG
+   * */
+  bool BlobHasTag(const BlobId &blob_id,
+                  const TagId &tag_id) {
+    return blob_mdm_->BlobHasTagRoot(id_, blob_id, tag_id);
+  }
+
+  /**
+   * Get the blobs of this bucket labeled with \a tag_id TAG
+   * */
+  std::vector<BlobId> GetBlobsWithTag(const TagId &tag_id) {
+    return blob_mdm_->GetBlobsWithTagRoot(id_, tag_id);
+  }
+
   /**
    * Put \a blob_name Blob into the bucket
    * */
@@ -222,13 +277,29 @@ class Bucket {
                  const Blob &blob,
                  size_t blob_off,
                  Context &ctx) {
-    BlobId blob_id = orig_blob_id;
-    bitfield32_t flags, task_flags(
-        TASK_FIRE_AND_FORGET | TASK_DATA_OWNER | TASK_LOW_LATENCY);
     // Copy data to shared memory
     LPointer<char> p = HRUN_CLIENT->AllocateBufferClient(blob.size());
     char *data = p.ptr_;
     memcpy(data, blob.data(), blob.size());
+    return ShmBasePut<PARTIAL, ASYNC>(blob_name, orig_blob_id,
+                                      p.shm_, blob.size(), blob_off, ctx);
+  }
+
+  /**
+   * Put \a blob_name Blob into the bucket. The data is already in
+   * shared memory and ownership of it is passed to the PutBlob task.
+   * */
+  template<bool PARTIAL, bool ASYNC>
+  HSHM_ALWAYS_INLINE
+  BlobId ShmBasePut(const std::string &blob_name,
+                    const BlobId &orig_blob_id,
+                    const hipc::Pointer &data,
+                    size_t data_size,
+                    size_t blob_off,
+                    Context &ctx) {
+    BlobId blob_id = orig_blob_id;
+    bitfield32_t flags, task_flags(
+        TASK_FIRE_AND_FORGET | TASK_DATA_OWNER | TASK_LOW_LATENCY);
     // Put to shared memory
     hshm::charbuf blob_name_buf = hshm::to_charbuf(blob_name);
     if constexpr (!ASYNC) {
@@ -242,8 +313,8 @@ class Bucket {
     }
     LPointer<hrunpq::TypedPushTask<PutBlobTask>> push_task;
     push_task = blob_mdm_->AsyncPutBlobRoot(id_, blob_name_buf,
-                                            blob_id, blob_off, blob.size(),
-                                            p.shm_, ctx.blob_score_,
+                                            blob_id, blob_off, data_size,
+                                            data, ctx.blob_score_,
                                             flags.bits_, ctx, task_flags.bits_);
     if constexpr (!ASYNC) {
       if (flags.Any(HERMES_GET_BLOB_ID)) {
@@ -332,6 +403,151 @@ class Bucket {
     }
   }
 
+  /**
+   * Allocate a buffer in shared memory which can be filled in place
+   * and then placed in the bucket with PutBuffer, avoiding a copy.
+   * */
+  BlobBuffer AllocateBlobBuffer(size_t size) {
+    return BlobBuffer(size);
+  }
+
+  /**
+   * Put \a buf into the bucket as \a blob_name. The buffer is owned
+   * by the runtime afterwards and \a buf is left empty.
+   * */
+  BlobId PutBuffer(const std::string &blob_name,
+                   BlobBuffer &buf,
+                   Context &ctx) {
+    size_t data_size = buf.size();
+    return ShmBasePut<false, false>(blob_name, BlobId::GetNull(),
+                                    buf.Release(), data_size, 0, ctx);
+  }
+
+  /**
+   * Put \a buf into the bucket as \a blob_name (fully asynchronous)
+   * */
+  void AsyncPutBuffer(const std::string &blob_name,
+                      BlobBuffer &buf,
+                      Context &ctx) {
+    size_t data_size = buf.size();
+    ShmBasePut<false, true>(blob_name, BlobId::GetNull(),
+                            buf.Release(), data_size, 0, ctx);
+  }
+
+  /**
+   * PartialPut \a buf into \a blob_name at \a blob_off
+   * */
+  BlobId PartialPutBuffer(const std::string &blob_name,
+                          BlobBuffer &buf,
+                          size_t blob_off,
+                          Context &ctx) {
+    size_t data_size = buf.size();
+    return ShmBasePut<true, false>(blob_name, BlobId::GetNull(),
+                                   buf.Release(), data_size, blob_off, ctx);
+  }
+
+  /**
+   * PartialPut \a buf into \a blob_name at \a blob_off (fully asynchronous)
+   * */
+  void AsyncPartialPutBuffer(const std::string &blob_name,
+                             BlobBuffer &buf,
+                             size_t blob_off,
+                             Context &ctx) {
+    size_t data_size = buf.size();
+    ShmBasePut<true, true>(blob_name, BlobId::GetNull(),
+                           buf.Release(), data_size, blob_off, ctx);
+  }
+
+  /**
+   * Group blob names by the node and lane that own their metadata.
+   * Each group can be sent to the blob mdm as a single batched task.
+   * The key is the node id in the upper 32 bits and the lane in the lower.
+   * */
+  std::unordered_map<u64, std::vector<size_t>>
+  GroupBlobNames(const std::vector<std::string> &blob_names) {
+    QueueManagerInfo &qm = HRUN_CLIENT->server_config_.queue_manager_;
+    std::unordered_map<u64, std::vector<size_t>> groups;
+    for (size_t i = 0; i < blob_names.size(); ++i) {
+      u32 hash = blob_mdm::HashBlobName(id_, hshm::to_charbuf(blob_names[i]));
+      u64 node_id = HASH_TO_NODE_ID(hash);
+      u64 lane = hash % qm.max_lanes_;
+      groups[(node_id << 32) | lane].emplace_back(i);
+    }
+    return groups;
+  }
+
+  /**
+   * Put a set of blobs into the bucket using one task per metadata lane
+   * */
+  template<bool ASYNC>
+  void BaseMultiPut(const std::vector<std::string> &blob_names,
+                    const std::vector<Blob> &blobs,
+                    Context &ctx) {
+    bitfield32_t task_flags(TASK_DATA_OWNER | TASK_LOW_LATENCY);
+    if constexpr (ASYNC) {
+      task_flags.SetBits(TASK_FIRE_AND_FORGET);
+    }
+    std::vector<LPointer<hrunpq::TypedPushTask<MultiPutBlobTask>>> push_tasks;
+    for (auto &it : GroupBlobNames(blob_names)) {
+      std::vector<size_t> &idxs = it.second;
+      // Copy data to shared memory
+      size_t data_size = 0;
+      for (size_t idx : idxs) {
+        data_size += blobs[idx].size();
+      }
+      LPointer<char> p = HRUN_CLIENT->AllocateBufferClient(data_size);
+      std::vector<BlobIoEntry> entries(idxs.size());
+      size_t data_off = 0;
+      for (size_t i = 0; i < idxs.size(); ++i) {
+        const Blob &blob = blobs[idxs[i]];
+        BlobIoEntry &entry = entries[i];
+        entry.blob_name_ = hshm::to_charbuf(blob_names[idxs[i]]);
+        entry.blob_id_ = BlobId::GetNull();
+        entry.blob_off_ = 0;
+        entry.data_off_ = data_off;
+        entry.data_size_ = blob.size();
+        memcpy(p.ptr_ + data_off, blob.data(), blob.size());
+        data_off += blob.size();
+      }
+      // Put to shared memory
+      u32 node_id = (u32)(it.first >> 32);
+      u32 lane_hash = (u32)it.first;
+      LPointer<hrunpq::TypedPushTask<MultiPutBlobTask>> push_task;
+      push_task = blob_mdm_->AsyncMultiPutBlobRoot(
+          DomainId::GetNode(node_id), lane_hash, id_, entries,
+          data_size, p.shm_, ctx.blob_score_, HERMES_BLOB_REPLACE,
+          ctx, task_flags.bits_);
+      if constexpr (!ASYNC) {
+        push_tasks.emplace_back(push_task);
+      }
+    }
+    if constexpr (!ASYNC) {
+      for (LPointer<hrunpq::TypedPushTask<MultiPutBlobTask>> &push_task :
+           push_tasks) {
+        push_task->Wait();
+        HRUN_CLIENT->DelTask(push_task);
+      }
+    }
+  }
+
+  /**
+   * Put a set of blobs into the bucket
+   * */
+  void MultiPut(const std::vector<std::string> &blob_names,
+                const std::vector<Blob> &blobs,
+                Context &ctx) {
+    BaseMultiPut<false>(blob_names, blobs, ctx);
+  }
+
+  /**
+   * Put a set of blobs into the bucket (fully asynchronous)
+   * */
+  void AsyncMultiPut(const std::vector<std::string> &blob_names,
+                     const std::vector<Blob> &blobs,
+                     Context &ctx) {
+    BaseMultiPut<true>(blob_names, blobs, ctx);
+  }
+
   /**
    * PartialPut \a blob_name Blob into the bucket
    * */
@@ -375,15 +591,68 @@ class Bucket {
   }
 
   /**
-   * Append \a blob_name Blob into the bucket (fully asynchronous)
+   * Reserve \a lease_size bytes of the bucket at a time for Append.
+   * Appends are then placed without contacting the bucket until the
+   * lease runs out. The unused end of a lease is left as a hole, so
+   * page-aligned leases suit log-style producers. 0 reserves each
+   * append exactly.
+   * */
+  void SetAppendLease(size_t lease_size) {
+    append_lease_ = AppendLease();
+    append_lease_.size_ = lease_size;
+  }
+
+  /**
+   * Reserve \a size bytes at the end of the bucket for an append
+   * and return their offset
+   * */
+  size_t ReserveAppend(size_t size) {
+    AppendLease &lease = append_lease_;
+    if (lease.size_ == 0) {
+      return bkt_mdm_->ReserveAppendRoot(id_, size, lease.flags_);
+    }
+    if (lease.end_ == 0 || lease.off_ + size > lease.end_) {
+      size_t lease_size = std::max(lease.size_, size);
+      lease.off_ = bkt_mdm_->ReserveAppendRoot(id_, lease_size, lease.flags_);
+      lease.end_ = lease.off_ + lease_size;
+    }
+    size_t off = lease.off_;
+    lease.off_ += size;
+    return off;
+  }
+
+  /**
+   * Append \a blob to the bucket (fully asynchronous). The range is
+   * reserved first, then each page is put directly to its blob, so
+   * concurrent appenders do not serialize on the bucket.
    * */
   void Append(const Blob &blob, size_t page_size, Context &ctx) {
-    LPointer<char> p = HRUN_CLIENT->AllocateBufferClient(blob.size());
-    char *data = p.ptr_;
-    memcpy(data, blob.data(), blob.size());
-    bkt_mdm_->AppendBlobRoot(
-        id_, blob.size(), p.shm_, page_size,
-        ctx.blob_score_, ctx.node_id_, ctx);
+    if (blob.size() == 0) {
+      return;
+    }
+    size_t off = ReserveAppend(blob.size());
+    Context put_ctx = ctx;
+    put_ctx.flags_.UnsetBits(HERMES_SHOULD_STAGE);
+    if (append_lease_.flags_.Any(HERMES_SHOULD_STAGE)) {
+      put_ctx.flags_.SetBits(HERMES_SHOULD_STAGE);
+    }
+    size_t cur_page = off / page_size;
+    size_t page_off = off % page_size;
+    size_t buf_off = 0;
+    while (buf_off < blob.size()) {
+      size_t data_size = std::min(page_size - page_off,
+                                  blob.size() - buf_off);
+      LPointer<char> p = HRUN_CLIENT->AllocateBufferClient(data_size);
+      memcpy(p.ptr_, blob.data() + buf_off, data_size);
+      blob_mdm_->AsyncPutBlobRoot(
+          id_, adapter::BlobPlacement::CreateBlobName(cur_page),
+          BlobId::GetNull(), page_off, data_size, p.shm_,
+          ctx.blob_score_, HERMES_BLOB_APPEND, put_ctx,
+          TASK_FIRE_AND_FORGET | TASK_DATA_OWNER | TASK_LOW_LATENCY);
+      buf_off += data_size;
+      page_off = 0;
+      ++cur_page;
+    }
   }
 
   /**
@@ -445,14 +714,27 @@ class Bucket {
                Blob &blob,
                size_t blob_off,
                Context &ctx) {
+    return AsyncShmBaseGet(blob_name, blob_id, blob.size(), blob_off, ctx);
+  }
+
+  /**
+   * Get \a blob_id Blob from the bucket into a new shared-memory
+   * buffer of \a data_size bytes (async)
+   * */
+  LPointer<hrunpq::TypedPushTask<GetBlobTask>>
+  HSHM_ALWAYS_INLINE
+  AsyncShmBaseGet(const std::string &blob_name,
+                  const BlobId &blob_id,
+                  size_t data_size,
+                  size_t blob_off,
+                  Context &ctx) {
     bitfield32_t flags;
     // Get the blob ID
     if (blob_id.IsNull()) {
       flags.SetBits(HERMES_GET_BLOB_ID);
     }
     // Get from shared memory
-    size_t data_size = blob.size();
-    LPointer data_p = HRUN_CLIENT->AllocateBufferClient(blob.size());
+    LPointer data_p = HRUN_CLIENT->AllocateBufferClient(data_size);
     LPointer<hrunpq::TypedPushTask<GetBlobTask>> push_task;
     push_task = blob_mdm_->AsyncGetBlobRoot(id_, hshm::to_charbuf(blob_name),
                                             blob_id, blob_off,
@@ -600,6 +882,188 @@ class Bucket {
     return AsyncBaseGet("", blob_id, blob, blob_off, ctx);
   }
 
+  /**
+   * Get a view of \a blob_name Blob directly in shared memory (async).
+   * Pass the returned task to GetViewComplete to obtain the view.
+   * */
+  LPointer<hrunpq::TypedPushTask<GetBlobTask>>
+  AsyncGetView(const std::string &blob_name,
+               size_t data_size,
+               size_t blob_off,
+               Context &ctx) {
+    return AsyncShmBaseGet(blob_name, BlobId::GetNull(),
+                           data_size, blob_off, ctx);
+  }
+
+  /**
+   * Get a view of \a blob_id Blob directly in shared memory (async).
+   * Pass the returned task to GetViewComplete to obtain the view.
+   * */
+  LPointer<hrunpq::TypedPushTask<GetBlobTask>>
+  AsyncGetView(const BlobId &blob_id,
+               size_t data_size,
+               size_t blob_off,
+               Context &ctx) {
+    return AsyncShmBaseGet("", blob_id, data_size, blob_off, ctx);
+  }
+
+  /**
+   * Wait for an AsyncGetView to complete. The returned buffer holds the
+   * blob's data and is freed when it goes out of scope.
+   * */
+  BlobBuffer GetViewComplete(
+      LPointer<hrunpq::TypedPushTask<GetBlobTask>> &push_task) {
+    push_task->Wait();
+    GetBlobTask *task = push_task->get();
+    LPointer<char> p;
+    p.shm_ = task->data_;
+    p.ptr_ = HRUN_CLIENT->GetDataPointer(task->data_);
+    BlobBuffer view(p, task->data_size_);
+    HRUN_CLIENT->DelTask(push_task);
+    return view;
+  }
+
+  /**
+   * Get a view of \a blob_name Blob directly in shared memory
+   * */
+  BlobBuffer GetView(const std::string &blob_name, Context &ctx) {
+    size_t data_size = blob_mdm_->GetBlobSizeRoot(
+        id_, hshm::charbuf(blob_name), BlobId::GetNull());
+    LPointer<hrunpq::TypedPushTask<GetBlobTask>> push_task =
+        AsyncGetView(blob_name, data_size, 0, ctx);
+    return GetViewComplete(push_task);
+  }
+
+  /**
+   * Get a view of \a blob_id Blob directly in shared memory
+   * */
+  BlobBuffer GetView(const BlobId &blob_id, Context &ctx) {
+    size_t data_size = blob_mdm_->GetBlobSizeRoot(
+        id_, hshm::charbuf(""), blob_id);
+    LPointer<hrunpq::TypedPushTask<GetBlobTask>> push_task =
+        AsyncGetView(blob_id, data_size, 0, ctx);
+    return GetViewComplete(push_task);
+  }
+
+  /**
+   * Get a view of \a data_size bytes of \a blob_name Blob
+   * starting at \a blob_off
+   * */
+  BlobBuffer PartialGetView(const std::string &blob_name,
+                            size_t data_size,
+                            size_t blob_off,
+                            Context &ctx) {
+    LPointer<hrunpq::TypedPushTask<GetBlobTask>> push_task =
+        AsyncGetView(blob_name, data_size, blob_off, ctx);
+    return GetViewComplete(push_task);
+  }
+
+  /**
+   * Get a set of blobs from the bucket using one task per metadata lane.
+   * Blobs with size 0 are resized to the size of the stored blob, which
+   * costs one extra request per metadata lane.
+   * */
+  void MultiGet(const std::vector<std::string> &blob_names,
+                std::vector<Blob> &blobs,
+                Context &ctx) {
+    blobs.resize(blob_names.size());
+    std::unordered_map<u64, std::vector<size_t>> groups =
+        GroupBlobNames(blob_names);
+    MultiGetSizes(blob_names, groups, blobs);
+    std::vector<LPointer<hrunpq::TypedPushTask<MultiGetBlobTask>>> push_tasks;
+    std::vector<std::vector<size_t>> batch_idxs;
+    for (auto &it : groups) {
+      std::vector<size_t> &idxs = it.second;
+      size_t data_size = 0;
+      for (size_t idx : idxs) {
+        data_size += blobs[idx].size();
+      }
+      LPointer<char> p = HRUN_CLIENT->AllocateBufferClient(data_size);
+      std::vector<BlobIoEntry> entries(idxs.size());
+      size_t data_off = 0;
+      for (size_t i = 0; i < idxs.size(); ++i) {
+        BlobIoEntry &entry = entries[i];
+        entry.blob_name_ = hshm::to_charbuf(blob_names[idxs[i]]);
+        entry.blob_id_ = BlobId::GetNull();
+        entry.blob_off_ = 0;
+        entry.data_off_ = data_off;
+        entry.data_size_ = blobs[idxs[i]].size();
+        data_off += entry.data_size_;
+      }
+      u32 node_id = (u32)(it.first >> 32);
+      u32 lane_hash = (u32)it.first;
+      push_tasks.emplace_back(blob_mdm_->AsyncMultiGetBlobRoot(
+          DomainId::GetNode(node_id), lane_hash, id_, entries,
+          data_size, p.shm_, ctx));
+      batch_idxs.emplace_back(std::move(idxs));
+    }
+    for (size_t batch = 0; batch < push_tasks.size(); ++batch) {
+      LPointer<hrunpq::TypedPushTask<MultiGetBlobTask>> &push_task =
+          push_tasks[batch];
+      push_task->Wait();
+      MultiGetBlobTask *task = push_task->get();
+      std::vector<BlobIoEntry> entries = task->GetEntries();
+      char *data = HRUN_CLIENT->GetDataPointer(task->data_);
+      std::vector<size_t> &idxs = batch_idxs[batch];
+      for (size_t i = 0; i < idxs.size(); ++i) {
+        BlobIoEntry &entry = entries[i];
+        Blob &blob = blobs[idxs[i]];
+        memcpy(blob.data(), data + entry.data_off_, entry.data_size_);
+        blob.resize(entry.data_size_);
+      }
+      HRUN_CLIENT->FreeBuffer(task->data_);
+      HRUN_CLIENT->DelTask(push_task);
+    }
+  }
+
+  /**
+   * Resize the blobs of size 0 in \a blobs to the size of the stored
+   * blob, using one task per metadata lane of \a groups
+   * */
+  void MultiGetSizes(const std::vector<std::string> &blob_names,
+                     std::unordered_map<u64, std::vector<size_t>> &groups,
+                     std::vector<Blob> &blobs) {
+    std::vector<LPointer<hrunpq::TypedPushTask<MultiGetBlobSizeTask>>>
+        push_tasks;
+    std::vector<std::vector<size_t>> batch_idxs;
+    for (auto &it : groups) {
+      std::vector<BlobIoEntry> entries;
+      std::vector<size_t> idxs;
+      for (size_t idx : it.second) {
+        if (blobs[idx].size() != 0) {
+          continue;
+        }
+        BlobIoEntry entry;
+        entry.blob_name_ = hshm::to_charbuf(blob_names[idx]);
+        entry.blob_id_ = BlobId::GetNull();
+        entry.blob_off_ = 0;
+        entry.data_off_ = 0;
+        entry.data_size_ = 0;
+        entries.emplace_back(std::move(entry));
+        idxs.emplace_back(idx);
+      }
+      if (entries.empty()) {
+        continue;
+      }
+      u32 node_id = (u32)(it.first >> 32);
+      u32 lane_hash = (u32)it.first;
+      push_tasks.emplace_back(blob_mdm_->AsyncMultiGetBlobSizeRoot(
+          DomainId::GetNode(node_id), lane_hash, id_, entries));
+      batch_idxs.emplace_back(std::move(idxs));
+    }
+    for (size_t batch = 0; batch < push_tasks.size(); ++batch) {
+      LPointer<hrunpq::TypedPushTask<MultiGetBlobSizeTask>> &push_task =
+          push_tasks[batch];
+      push_task->Wait();
+      std::vector<BlobIoEntry> entries = push_task->get()->GetEntries();
+      std::vector<size_t> &idxs = batch_idxs[batch];
+      for (size_t i = 0; i < idxs.size(); ++i) {
+        blobs[idxs[i]].resize(entries[i].data_size_);
+      }
+      HRUN_CLIENT->DelTask(push_task);
+    }
+  }
+
   /**
    * Determine if the bucket contains \a blob_id BLOB
    * */
@@ -619,10 +1083,11 @@ class Bucket {
   }
 
   /**
-   * Delete \a blob_id blob
+   * Delete \a blob_id blob and remove it from the bucket
    * */
   void DestroyBlob(const BlobId &blob_id, Context &ctx) {
     blob_mdm_->DestroyBlobRoot(id_, blob_id);
+    bkt_mdm_->TagRemoveBlobRoot(id_, blob_id);
   }
 
   /**
@@ -631,6 +1096,41 @@ class Bucket {
   std::vector<BlobId> GetContainedBlobIds() {
     return bkt_mdm_->GetContainedBlobIdsRoot(id_);
   }
+
+  /**
+   * List up to \a limit blobs whose names start with \a prefix and sort
+   * after \a start_after, in name order. Pass the last name returned as
+   * \a start_after to get the next page.
+   * */
+  std::vector<BlobNameEntry> ListBlobs(const std::string &prefix,
+                                       const std::string &start_after = "",
+                                       size_t limit = 1024) {
+    return blob_mdm_->ListBlobsRoot(id_, prefix, start_after, limit);
+  }
+
+  /**
+   * Call \a func on each blob whose name starts with \a prefix, in name
+   * order, fetching \a page_size names at a time. Stops early if \a func
+   * returns false.
+   * */
+  template<typename FuncT>
+  void ScanBlobs(const std::string &prefix, FuncT &&func,
+                 size_t page_size = 1024) {
+    std::string start_after;
+    while (true) {
+      std::vector<BlobNameEntry> page =
+          ListBlobs(prefix, start_after, page_size);
+      for (BlobNameEntry &entry : page) {
+        if (!func(entry)) {
+          return;
+        }
+      }
+      if (page.size() < page_size) {
+        return;
+      }
+      start_after = page.back().name_;
+    }
+  }
 };
 
 }  // namespace hermes
@@ -0,0 +1,274 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HERMES_INCLUDE_HERMES_COMPRESSOR_H_
+#define HERMES_INCLUDE_HERMES_COMPRESSOR_H_
+
+#include <string.h>
+#include <vector>
+#include "hermes/hermes_types.h"
+
+namespace hermes {
+
+/**
+ * Lossless codecs for buffers the BORG moves to slower tiers.
+ *
+ * kLz is a byte-oriented LZ77 in the style of LZ4: each sequence is a
+ * token (literal count in the high nibble, match length - 4 in the low
+ * nibble), extra length bytes when a nibble saturates, the literals, and
+ * a 2-byte little-endian match offset. The last sequence has no match.
+ * kShuffleLz first groups byte i of every 8-byte word together, which
+ * turns arrays of doubles or 64-bit integers into long similar runs.
+ * */
+class Compressor {
+ public:
+  static const size_t kMinMatch = 4;
+  static const size_t kLastLiterals = 5;
+  static const size_t kHashLog = 14;
+  static const size_t kMaxOffset = 65535;
+  static const size_t kWordSize = 8;
+
+ public:
+  /**
+   * Compress \a size bytes of \a src into \a dst.
+   * @return the compressed size, or 0 if the output would not be
+   * smaller than the input or would not fit in \a cap bytes.
+   * */
+  static size_t Compress(Codec codec, const char *src, size_t size,
+                         char *dst, size_t cap) {
+    cap = std::min(cap, size - (size > 0));
+    switch (codec) {
+      case Codec::kLz: {
+        return LzCompress(src, size, dst, cap);
+      }
+      case Codec::kShuffleLz: {
+        std::vector<char> tmp(size);
+        Shuffle(src, size, tmp.data());
+        return LzCompress(tmp.data(), size, dst, cap);
+      }
+      default: {
+        return 0;
+      }
+    }
+  }
+
+  /**
+   * Decompress \a c_size bytes of \a src into exactly \a size bytes
+   * of \a dst.
+   * @return false if the input is corrupt.
+   * */
+  static bool Decompress(Codec codec, const char *src, size_t c_size,
+                         char *dst, size_t size) {
+    switch (codec) {
+      case Codec::kNone: {
+        if (c_size != size) {
+          return false;
+        }
+        memcpy(dst, src, size);
+        return true;
+      }
+      case Codec::kLz: {
+        return LzDecompress(src, c_size, dst, size);
+      }
+      case Codec::kShuffleLz: {
+        std::vector<char> tmp(size);
+        if (!LzDecompress(src, c_size, tmp.data(), size)) {
+          return false;
+        }
+        Unshuffle(tmp.data(), size, dst);
+        return true;
+      }
+      default: {
+        return false;
+      }
+    }
+  }
+
+ private:
+  /** Read 4 unaligned bytes */
+  static u32 Read32(const char *p) {
+    u32 val;
+    memcpy(&val, p, sizeof(val));
+    return val;
+  }
+
+  /** Hash 4 bytes into the match table */
+  static u32 Hash(u32 seq) {
+    return (seq * 2654435761U) >> (32 - kHashLog);
+  }
+
+  /** Emit a saturated length as a run of extra bytes */
+  static bool EmitLength(size_t len, u8 *&op, const u8 *oend) {
+    while (len >= 255) {
+      if (op >= oend) { return false; }
+      *op++ = 255;
+      len -= 255;
+    }
+    if (op >= oend) { return false; }
+    *op++ = static_cast<u8>(len);
+    return true;
+  }
+
+  /** Emit one sequence: literals, then a match unless \a mlen is 0 */
+  static bool EmitSequence(const u8 *lit, size_t lit_len,
+                           size_t offset, size_t mlen,
+                           u8 *&op, const u8 *oend) {
+    if (op >= oend) { return false; }
+    u8 *token = op++;
+    size_t ml = mlen ? mlen - kMinMatch : 0;
+    *token = static_cast<u8>((std::min<size_t>(lit_len, 15) << 4) |
+                             std::min<size_t>(ml, 15));
+    if (lit_len >= 15 && !EmitLength(lit_len - 15, op, oend)) {
+      return false;
+    }
+    if ((size_t)(oend - op) < lit_len) { return false; }
+    memcpy(op, lit, lit_len);
+    op += lit_len;
+    if (mlen == 0) {
+      return true;
+    }
+    if (oend - op < 2) { return false; }
+    *op++ = static_cast<u8>(offset);
+    *op++ = static_cast<u8>(offset >> 8);
+    if (ml >= 15 && !EmitLength(ml - 15, op, oend)) {
+      return false;
+    }
+    return true;
+  }
+
+  /** LZ77 compression */
+  static size_t LzCompress(const char *src, size_t size,
+                           char *dst, size_t cap) {
+    const u8 *ip = reinterpret_cast<const u8*>(src);
+    u8 *op = reinterpret_cast<u8*>(dst);
+    const u8 *oend = op + cap;
+    size_t anchor = 0;
+    if (size > kMinMatch + kLastLiterals) {
+      // Positions + 1, so 0 means empty
+      std::vector<u32> table(1 << kHashLog, 0);
+      size_t limit = size - kLastLiterals - kMinMatch;
+      size_t i = 0;
+      while (i < limit) {
+        u32 seq = Read32(src + i);
+        u32 &slot = table[Hash(seq)];
+        size_t ref = slot;
+        slot = static_cast<u32>(i + 1);
+        if (ref == 0 || i - (ref - 1) > kMaxOffset ||
+            Read32(src + ref - 1) != seq) {
+          ++i;
+          continue;
+        }
+        ref -= 1;
+        size_t mlen = kMinMatch;
+        while (i + mlen < size - kLastLiterals &&
+               ip[ref + mlen] == ip[i + mlen]) {
+          ++mlen;
+        }
+        if (!EmitSequence(ip + anchor, i - anchor, i - ref, mlen, op, oend)) {
+          return 0;
+        }
+        i += mlen;
+        anchor = i;
+      }
+    }
+    if (!EmitSequence(ip + anchor, size - anchor, 0, 0, op, oend)) {
+      return 0;
+    }
+    return op - reinterpret_cast<u8*>(dst);
+  }
+
+  /** Read a saturated length's extra bytes */
+  static bool ReadLength(size_t &len, const u8 *&ip, const u8 *iend) {
+    u8 b;
+    do {
+      if (ip >= iend) { return false; }
+      b = *ip++;
+      len += b;
+    } while (b == 255);
+    return true;
+  }
+
+  /** LZ77 decompression, bounds-checked against both buffers */
+  static bool LzDecompress(const char *src, size_t c_size,
+                           char *dst, size_t size) {
+    const u8 *ip = reinterpret_cast<const u8*>(src);
+    const u8 *iend = ip + c_size;
+    u8 *op = reinterpret_cast<u8*>(dst);
+    u8 *ostart = op;
+    u8 *oend = op + size;
+    while (ip < iend) {
+      u8 token = *ip++;
+      size_t lit_len = token >> 4;
+      if (lit_len == 15 && !ReadLength(lit_len, ip, iend)) {
+        return false;
+      }
+      if ((size_t)(iend - ip) < lit_len || (size_t)(oend - op) < lit_len) {
+        return false;
+      }
+      memcpy(op, ip, lit_len);
+      ip += lit_len;
+      op += lit_len;
+      if (ip == iend) {
+        break;
+      }
+      if (iend - ip < 2) {
+        return false;
+      }
+      size_t offset = ip[0] | (ip[1] << 8);
+      ip += 2;
+      size_t mlen = token & 15;
+      if (mlen == 15 && !ReadLength(mlen, ip, iend)) {
+        return false;
+      }
+      mlen += kMinMatch;
+      if (offset == 0 || (size_t)(op - ostart) < offset ||
+          (size_t)(oend - op) < mlen) {
+        return false;
+      }
+      // Matches may overlap their own output
+      const u8 *match = op - offset;
+      for (size_t i = 0; i < mlen; ++i) {
+        op[i] = match[i];
+      }
+      op += mlen;
+    }
+    return op == oend;
+  }
+
+  /** Group byte i of each 8-byte word together */
+  static void Shuffle(const char *src, size_t size, char *dst) {
+    size_t words = size / kWordSize;
+    for (size_t w = 0; w < words; ++w) {
+      for (size_t b = 0; b < kWordSize; ++b) {
+        dst[b * words + w] = src[w * kWordSize + b];
+      }
+    }
+    size_t tail = words * kWordSize;
+    memcpy(dst + tail, src + tail, size - tail);
+  }
+
+  /** Inverse of Shuffle */
+  static void Unshuffle(const char *src, size_t size, char *dst) {
+    size_t words = size / kWordSize;
+    for (size_t w = 0; w < words; ++w) {
+      for (size_t b = 0; b < kWordSize; ++b) {
+        dst[w * kWordSize + b] = src[b * words + w];
+      }
+    }
+    size_t tail = words * kWordSize;
+    memcpy(dst + tail, src + tail, size - tail);
+  }
+};
+
+}  // namespace hermes
+
+#endif  // HERMES_INCLUDE_HERMES_COMPRESSOR_H_
@@ -28,6 +28,45 @@ enum class IoInterface {
   kPosix
 };
 
+/**
+ * How a posix device issues its I/O
+ * */
+enum class IoEngine {
+  kSync,     /**< pread / pwrite on the worker */
+  kIoUring,  /**< Batched, asynchronous io_uring requests */
+  kLibAio    /**< Batched, asynchronous kernel AIO requests */
+};
+
+/** A class to convert IoEngine enum values to and from strings */
+class IoEngineConv {
+ public:
+  /** A function to return string representation of \a engine */
+  static std::string to_str(IoEngine engine) {
+    switch (engine) {
+      case IoEngine::kSync: {
+        return "sync";
+      }
+      case IoEngine::kIoUring: {
+        return "io_uring";
+      }
+      case IoEngine::kLibAio: {
+        return "libaio";
+      }
+    }
+    return "invalid";
+  }
+
+  /** return enum value of \a engine */
+  static IoEngine to_enum(const std::string &engine) {
+    if (engine == "io_uring") {
+      return IoEngine::kIoUring;
+    } else if (engine == "libaio") {
+      return IoEngine::kLibAio;
+    }
+    return IoEngine::kSync;
+  }
+};
+
 /**
  * DeviceInfo shared-memory representation
  * */
@@ -54,6 +93,16 @@ struct DeviceInfo {
   bool is_shared_;
   /** BORG's minimum and maximum capacity threshold for device */
   f32 borg_min_thresh_, borg_max_thresh_;
+  /** Codec of the buffers the BORG moves into the device */
+  Codec codec_;
+  /** How posix devices issue I/O */
+  IoEngine io_engine_;
+  /** Requests in flight per lane for asynchronous I/O engines */
+  u32 io_depth_;
+  /** Register the runtime's data buffers with the I/O engine */
+  bool io_register_bufs_;
+  /** Bypass the page cache (O_DIRECT) on posix devices */
+  bool direct_io_;
 };
 
 /**
@@ -93,8 +142,16 @@ struct BorgInfo {
   int num_threads_;
   /** Interval (seconds) where blobs are checked for flushing */
   size_t flush_period_;
+  /** Max number of blobs being flushed at once per lane */
+  size_t flush_concurrency_;
+  /** Max bytes of blob data being flushed at once per lane */
+  size_t flush_max_bytes_;
   /** Interval (seconds) where blobs are checked for re-organization */
   size_t blob_reorg_period_;
+  /** Max bytes per second migrated between tiers per target */
+  size_t migrate_bandwidth_;
+  /** Max number of buffers being migrated at once per target */
+  size_t migrate_max_inflight_;
   /** Time when score is equal to 1 (seconds) */
   float recency_min_;
   /** Time when score is equal to 0 (seconds) */
@@ -134,6 +191,27 @@ struct MdmInfo {
 
   /** Number of traits in mdm trait map before collisions */
   size_t num_traits_;
+
+  /** Whether blob names are indexed in order for listing */
+  bool name_index_ = true;
+
+  /**
+   * Max time (ms) a lane holds bucket size changes before sending them to
+   * the bucket mdm. 0 sends every change as it happens.
+   * */
+  size_t size_flush_ms_ = 100;
+};
+
+/**
+ * Metadata recovery information in server config
+ * */
+struct RecoveryInfo {
+  /** Whether metadata is logged so a restart keeps persistent tiers */
+  bool enabled_;
+  /** Directory of the metadata logs and snapshots */
+  std::string path_;
+  /** Log size (bytes) past which a lane's metadata is snapshotted */
+  size_t snapshot_log_size_;
 };
 
 /**
@@ -162,6 +240,9 @@ class ServerConfig : public BaseConfig {
   /** Metadata Manager information */
   MdmInfo mdm_;
 
+  /** Metadata recovery information */
+  RecoveryInfo recovery_;
+
   /** Trait repo information */
   std::vector<std::string> trait_paths_;
 
@@ -198,6 +279,9 @@ class ServerConfig : public BaseConfig {
     if (yaml_conf["mdm"]) {
       ParseMdmInfo(yaml_conf["mdm"]);
     }
+    if (yaml_conf["recovery"]) {
+      ParseRecoveryInfo(yaml_conf["recovery"]);
+    }
     if (yaml_conf["system_view_state_update_interval_ms"]) {
       system_view_state_update_interval_ms =
           yaml_conf["system_view_state_update_interval_ms"].as<int>();
@@ -236,6 +320,28 @@ class ServerConfig : public BaseConfig {
       dev.latency_ =
           hshm::ConfigParse::ParseLatency(
               dev_info["latency"].as<std::string>());
+      dev.codec_ = Codec::kNone;
+      if (dev_info["compress"]) {
+        dev.codec_ = CodecConv::to_enum(
+            dev_info["compress"].as<std::string>());
+      }
+      dev.io_engine_ = IoEngine::kSync;
+      if (dev_info["io_engine"]) {
+        dev.io_engine_ = IoEngineConv::to_enum(
+            dev_info["io_engine"].as<std::string>());
+      }
+      dev.io_depth_ = 128;
+      if (dev_info["io_depth"]) {
+        dev.io_depth_ = dev_info["io_depth"].as<u32>();
+      }
+      dev.io_register_bufs_ = false;
+      if (dev_info["io_register_buffers"]) {
+        dev.io_register_bufs_ = dev_info["io_register_buffers"].as<bool>();
+      }
+      dev.direct_io_ = false;
+      if (dev_info["direct_io"]) {
+        dev.direct_io_ = dev_info["direct_io"].as<bool>();
+      }
       std::vector<std::string> size_vec;
       ParseVector<std::string, std::vector<std::string>>(
           dev_info["slab_sizes"], size_vec);
@@ -264,9 +370,24 @@ class ServerConfig : public BaseConfig {
     if (yaml_conf["flush_period"]) {
       borg_.flush_period_ = yaml_conf["flush_period"].as<size_t>();
     }
+    if (yaml_conf["flush_concurrency"]) {
+      borg_.flush_concurrency_ = yaml_conf["flush_concurrency"].as<size_t>();
+    }
+    if (yaml_conf["flush_max_bytes"]) {
+      borg_.flush_max_bytes_ = hshm::ConfigParse::ParseSize(
+          yaml_conf["flush_max_bytes"].as<std::string>());
+    }
     if (yaml_conf["blob_reorg_period"]) {
       borg_.blob_reorg_period_ = yaml_conf["blob_reorg_period"].as<size_t>();
     }
+    if (yaml_conf["migrate_bandwidth"]) {
+      borg_.migrate_bandwidth_ = hshm::ConfigParse::ParseSize(
+          yaml_conf["migrate_bandwidth"].as<std::string>());
+    }
+    if (yaml_conf["migrate_max_inflight"]) {
+      borg_.migrate_max_inflight_ =
+          yaml_conf["migrate_max_inflight"].as<size_t>();
+    }
     if (yaml_conf["recency_min"]) {
       borg_.recency_min_ = yaml_conf["recency_min"].as<float>();
     }
@@ -331,6 +452,27 @@ class ServerConfig : public BaseConfig {
     mdm_.num_blobs_ = yaml_conf["est_blob_count"].as<size_t>();
     mdm_.num_bkts_ = yaml_conf["est_blob_count"].as<size_t>();
     mdm_.num_traits_ = yaml_conf["est_num_traits"].as<size_t>();
+    if (yaml_conf["blob_name_index"]) {
+      mdm_.name_index_ = yaml_conf["blob_name_index"].as<bool>();
+    }
+    if (yaml_conf["size_flush_period_ms"]) {
+      mdm_.size_flush_ms_ = yaml_conf["size_flush_period_ms"].as<size_t>();
+    }
+  }
+
+  /** parse metadata recovery information from YAML config */
+  void ParseRecoveryInfo(YAML::Node yaml_conf) {
+    if (yaml_conf["enabled"]) {
+      recovery_.enabled_ = yaml_conf["enabled"].as<bool>();
+    }
+    if (yaml_conf["path"]) {
+      recovery_.path_ = hshm::ConfigParse::ExpandPath(
+          yaml_conf["path"].as<std::string>());
+    }
+    if (yaml_conf["snapshot_log_size"]) {
+      recovery_.snapshot_log_size_ = hshm::ConfigParse::ParseSize(
+          yaml_conf["snapshot_log_size"].as<std::string>());
+    }
   }
 };
 
@@ -339,6 +481,8 @@ class ServerConfig : public BaseConfig {
 namespace hermes {
 using config::ServerConfig;
 using config::DeviceInfo;
+using config::IoEngine;
+using config::IoEngineConv;
 }  // namespace hermes
 
 #endif  // HERMES_SRC_CONFIG_SERVER_H_
@@ -49,6 +49,12 @@ const inline char* kHermesServerDefaultConfigStr =
 "    # that the device is always at least 30% occupied.\n"
 "    borg_capacity_thresh: [0.0, 1.0]\n"
 "\n"
+"    # Compress the buffers the BufferOrganizer moves into this device, trading\n"
+"    # CPU for capacity and bandwidth. One of: none, lz, or shuffle_lz (lz after\n"
+"    # byte-shuffling 8-byte words, for arrays of doubles or 64-bit integers).\n"
+"    # Buckets can override this with Context::codec_.\n"
+"    compress: none\n"
+"\n"
 "  nvme:\n"
 "    mount_point: \"./\"\n"
 "    capacity: 100MB\n"
@@ -59,6 +65,27 @@ const inline char* kHermesServerDefaultConfigStr =
 "    is_shared_device: false\n"
 "    borg_capacity_thresh: [ 0.0, 1.0 ]\n"
 "\n"
+"    # How posix devices issue I/O. One of: sync (pread / pwrite on the\n"
+"    # worker), io_uring (batched and asynchronous, so a worker keeps\n"
+"    # serving other lanes during device latency), or libaio (the same with\n"
+"    # kernel AIO, for kernels without io_uring). io_uring and libaio need\n"
+"    # a build with HERMES_ENABLE_IO_URING or HERMES_ENABLE_LIBAIO; sync is\n"
+"    # used otherwise.\n"
+"    io_engine: sync\n"
+"\n"
+"    # The number of requests in flight per lane for asynchronous engines\n"
+"    io_depth: 128\n"
+"\n"
+"    # Register the shared-memory data buffers of the runtime with io_uring.\n"
+"    # Registered memory is pinned and counts against RLIMIT_MEMLOCK.\n"
+"    io_register_buffers: false\n"
+"\n"
+"    # Open the device file with O_DIRECT, so slab I/O bypasses the page\n"
+"    # cache. Slab sizes are rounded up to block_size. Requests that are not\n"
+"    # block-aligned in memory, offset, or size go through aligned bounce\n"
+"    # buffers; the rest are transferred directly from shared memory.\n"
+"    direct_io: false\n"
+"\n"
 "  ssd:\n"
 "    mount_point: \"./\"\n"
 "    capacity: 100MB\n"
@@ -87,9 +114,21 @@ const inline char* kHermesServerDefaultConfigStr =
 "  # Interval (ms) where blobs are checked for flushing\n"
 "  flush_period: 1024\n"
 "\n"
+"  # Max number of blobs being flushed at once (per lane)\n"
+"  flush_concurrency: 16\n"
+"\n"
+"  # Max bytes of blob data being flushed at once (per lane)\n"
+"  flush_max_bytes: 64MB\n"
+"\n"
 "  # Interval (ms) where blobs are checked for re-organization\n"
 "  blob_reorg_period: 1024\n"
 "\n"
+"  # Max bytes per second moved between tiers by the BORG (per target)\n"
+"  migrate_bandwidth: 256MB\n"
+"\n"
+"  # Max number of buffers being moved at once (per target)\n"
+"  migrate_max_inflight: 8\n"
+"\n"
 "  ## What does \"recently accessed\" mean?\n"
 "  # Time when score is equal to 1 (seconds)\n"
 "  recency_min: 0\n"
@@ -131,6 +170,24 @@ const inline char* kHermesServerDefaultConfigStr =
 "  est_blob_count: 100000\n"
 "  est_bucket_count: 100000\n"
 "  est_num_traits: 256\n"
+"  # Keep blob names sorted per bucket, for ListBlobs. Costs memory per blob.\n"
+"  blob_name_index: true\n"
+"  # Max time (ms) a lane batches bucket size changes before sending them.\n"
+"  # Exact size reads flush them first. 0 sends every change immediately.\n"
+"  size_flush_period_ms: 100\n"
+"\n"
+"### Define metadata recovery properties\n"
+"recovery:\n"
+"  # Log blob and bucket metadata so that a restarted runtime keeps the data\n"
+"  # buffered in its non-RAM devices, whose files are then reopened instead of\n"
+"  # truncated. Data in RAM devices is lost on restart.\n"
+"  enabled: false\n"
+"\n"
+"  # The directory holding the metadata logs and snapshots of each node\n"
+"  path: \"./\"\n"
+"\n"
+"  # Snapshot a lane's metadata once its log grows past this size\n"
+"  snapshot_log_size: 64MB\n"
 "\n"
 "# The interval in milliseconds at which to update the global system view.\n"
 "system_view_state_update_interval_ms: 1000\n"
@@ -0,0 +1,126 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HERMES_INCLUDE_HERMES_DEDUP_INDEX_H_
+#define HERMES_INCLUDE_HERMES_DEDUP_INDEX_H_
+
+#include <string_view>
+#include <unordered_map>
+#include "hermes/hermes_types.h"
+
+namespace hermes {
+
+/**
+ * Maps the fingerprint of a page to the slab holding it, with the number
+ * of blob buffers referencing that slab. Shared by all lanes of a node.
+ * A fingerprint is only a hint: callers compare the stored page before
+ * sharing it, so a collision never corrupts a blob.
+ * */
+class DedupIndex {
+ public:
+  /** A shared slab */
+  struct Entry {
+    BufferInfo buf_;  /**< The slab, with fp_ set */
+    size_t refs_;     /**< Number of blob buffers referencing it */
+  };
+
+  hshm::Mutex lock_;
+  std::unordered_map<u64, Entry> map_;
+
+ public:
+  /** Fingerprint of a page. Never 0, which marks unshared buffers. */
+  static u64 Fingerprint(const char *data, size_t size) {
+    u64 fp = std::hash<std::string_view>{}(std::string_view(data, size));
+    fp ^= size * 0x9E3779B97F4A7C15ULL;
+    return fp ? fp : 1;
+  }
+
+  /** Reference the slab holding a page of \a size bytes with print \a fp */
+  bool Acquire(u64 fp, size_t size, BufferInfo &buf) {
+    hshm::ScopedMutex lock(lock_, 0);
+    auto it = map_.find(fp);
+    if (it == map_.end() || it->second.buf_.t_size_ != size) {
+      return false;
+    }
+    it->second.refs_ += 1;
+    buf = it->second.buf_;
+    return true;
+  }
+
+  /**
+   * Share a newly written slab. Sets buf.fp_ on success. Fails if
+   * another slab already holds a page with this fingerprint.
+   * */
+  bool Insert(u64 fp, BufferInfo &buf) {
+    hshm::ScopedMutex lock(lock_, 0);
+    if (map_.find(fp) != map_.end()) {
+      return false;
+    }
+    buf.fp_ = fp;
+    map_.emplace(fp, Entry{buf, 1});
+    return true;
+  }
+
+  /** Drop a reference. Returns whether the slab should be freed. */
+  bool Release(u64 fp) {
+    hshm::ScopedMutex lock(lock_, 0);
+    auto it = map_.find(fp);
+    if (it == map_.end()) {
+      return true;
+    }
+    it->second.refs_ -= 1;
+    if (it->second.refs_ > 0) {
+      return false;
+    }
+    map_.erase(it);
+    return true;
+  }
+
+  /** Stop sharing the slab if the caller holds its only reference */
+  bool TryUnshare(u64 fp) {
+    hshm::ScopedMutex lock(lock_, 0);
+    auto it = map_.find(fp);
+    if (it == map_.end()) {
+      return true;
+    }
+    if (it->second.refs_ > 1) {
+      return false;
+    }
+    map_.erase(it);
+    return true;
+  }
+
+  /**
+   * Count a recovered blob's reference to a shared slab.
+   * Returns whether it is the first reference to the slab.
+   * */
+  bool Recover(const BufferInfo &buf) {
+    hshm::ScopedMutex lock(lock_, 0);
+    auto it = map_.find(buf.fp_);
+    if (it == map_.end()) {
+      map_.emplace(buf.fp_, Entry{buf, 1});
+      return true;
+    }
+    it->second.refs_ += 1;
+    return false;
+  }
+
+  /** Number of shared slabs */
+  size_t size() {
+    hshm::ScopedMutex lock(lock_, 0);
+    return map_.size();
+  }
+};
+
+}  // namespace hermes
+
+#endif  // HERMES_INCLUDE_HERMES_DEDUP_INDEX_H_
@@ -0,0 +1,517 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HERMES_INCLUDE_HERMES_FLAT_HASH_MAP_H_
+#define HERMES_INCLUDE_HERMES_FLAT_HASH_MAP_H_
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace hermes {
+
+namespace flat_hash {
+
+/** Control byte of a slot which has never held an entry */
+static const int8_t kEmpty = -128;
+/** Control byte of a slot whose entry was erased */
+static const int8_t kDeleted = -2;
+/** Number of control bytes scanned per probe */
+static const size_t kGroupSize = 16;
+/** Number of entries allocated at a time by the entry pool */
+static const size_t kPoolChunk = 512;
+
+/** Spread the bits of a (possibly weak) user hash */
+static inline size_t MixHash(size_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/** The 7 bits of the hash stored in the control byte */
+static inline int8_t H2(size_t hash) {
+  return static_cast<int8_t>(hash & 0x7f);
+}
+
+/** Index of the lowest set bit */
+static inline uint32_t LowestBit(uint32_t mask) {
+  return static_cast<uint32_t>(__builtin_ctz(mask));
+}
+
+/** A group of kGroupSize control bytes */
+class Group {
+ public:
+  const int8_t *ctrl_;
+
+ public:
+  explicit Group(const int8_t *ctrl) : ctrl_(ctrl) {}
+
+  /** Bitmask of the slots whose control byte is \a h2 */
+  uint32_t Match(int8_t h2) const {
+#if defined(__SSE2__)
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl_));
+    return static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kGroupSize; ++i) {
+      if (ctrl_[i] == h2) {
+        mask |= 1u << i;
+      }
+    }
+    return mask;
+#endif
+  }
+
+  /** Bitmask of the slots which have never been used */
+  uint32_t MatchEmpty() const {
+    return Match(kEmpty);
+  }
+
+  /** Bitmask of the slots which do not hold an entry */
+  uint32_t MatchFree() const {
+#if defined(__SSE2__)
+    // Empty and deleted bytes have their sign bit set; full bytes don't
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl_));
+    return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kGroupSize; ++i) {
+      if (ctrl_[i] < 0) {
+        mask |= 1u << i;
+      }
+    }
+    return mask;
+#endif
+  }
+};
+
+/**
+ * Chunked storage for map entries. Entries never move once constructed,
+ * so references remain valid across inserts, erases of other keys, and
+ * table growth. Freed entries are recycled.
+ * */
+template<typename T>
+class EntryPool {
+ public:
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+  std::vector<std::unique_ptr<Storage[]>> chunks_;
+  std::vector<T*> free_;
+  size_t tail_ = kPoolChunk;
+
+ public:
+  /** Construct an entry */
+  template<typename ...Args>
+  T* Allocate(Args&& ...args) {
+    void *mem;
+    if (!free_.empty()) {
+      mem = free_.back();
+      free_.pop_back();
+    } else {
+      if (chunks_.empty() || tail_ == kPoolChunk) {
+        chunks_.emplace_back(new Storage[kPoolChunk]);
+        tail_ = 0;
+      }
+      mem = &chunks_.back()[tail_++];
+    }
+    return new (mem) T(std::forward<Args>(args)...);
+  }
+
+  /** Destroy an entry */
+  void Free(T *entry) {
+    entry->~T();
+    free_.emplace_back(entry);
+  }
+
+  /** Release all memory. Entries must have been destroyed already. */
+  void Clear() {
+    chunks_.clear();
+    free_.clear();
+    tail_ = kPoolChunk;
+  }
+
+  /** Bytes reserved by the pool */
+  size_t GetMemoryUsage() const {
+    return chunks_.size() * kPoolChunk * sizeof(Storage) +
+        free_.capacity() * sizeof(T*);
+  }
+};
+
+}  // namespace flat_hash
+
+/**
+ * An open-addressing hash map for runtime metadata.
+ *
+ * Probing scans groups of 16 control bytes at a time (SSE2 when available),
+ * each holding 7 bits of the entry's hash, so most misses never touch an
+ * entry. The full hash is stored next to each entry pointer, which avoids
+ * re-hashing keys on growth and filters out almost all false matches before
+ * the key comparison.
+ *
+ * Entries live in a chunked pool rather than in the table itself, so
+ * references to values stay valid until that key is erased. Tasks hold
+ * BlobInfo and TagInfo references across coroutine yields, so this matters.
+ *
+ * Hash and KeyEqual may define is_transparent to allow lookups by a key view
+ * (e.g., a bucket id and name without building a charbuf). Iterators are
+ * invalidated by inserts, as with std::unordered_map.
+ * */
+template<typename K, typename V,
+         typename Hash = std::hash<K>,
+         typename KeyEqual = std::equal_to<K>>
+class FlatHashMap {
+ public:
+  typedef std::pair<const K, V> value_type;
+
+ private:
+  /** A slot in the table */
+  struct Slot {
+    size_t hash_;         /**< The mixed hash of the key */
+    value_type *entry_;   /**< The entry in the pool */
+  };
+
+  std::vector<int8_t> ctrl_;
+  std::vector<Slot> slots_;
+  size_t size_ = 0;
+  size_t tombstones_ = 0;
+  flat_hash::EntryPool<value_type> pool_;
+  Hash hash_;
+  KeyEqual eq_;
+
+ public:
+  /** Forward iterator over the full slots */
+  template<bool IS_CONST>
+  class Iterator {
+   public:
+    typedef typename std::conditional<IS_CONST,
+        const FlatHashMap, FlatHashMap>::type map_t;
+    typedef typename std::conditional<IS_CONST,
+        const value_type, value_type>::type entry_t;
+    map_t *map_;
+    size_t idx_;
+
+   public:
+    Iterator() : map_(nullptr), idx_(0) {}
+    Iterator(map_t *map, size_t idx) : map_(map), idx_(idx) {
+      SkipFree();
+    }
+
+    /** Allow converting iterator to const_iterator */
+    operator Iterator<true>() const {
+      return Iterator<true>(map_, idx_);
+    }
+
+    entry_t& operator*() const {
+      return *map_->slots_[idx_].entry_;
+    }
+    entry_t* operator->() const {
+      return map_->slots_[idx_].entry_;
+    }
+    Iterator& operator++() {
+      ++idx_;
+      SkipFree();
+      return *this;
+    }
+    bool operator==(const Iterator &other) const {
+      return idx_ == other.idx_;
+    }
+    bool operator!=(const Iterator &other) const {
+      return idx_ != other.idx_;
+    }
+
+    /** The slot of the entry, for resuming a scan with begin_from */
+    size_t slot() const {
+      return idx_;
+    }
+
+   private:
+    void SkipFree() {
+      while (idx_ < map_->slots_.size() && map_->ctrl_[idx_] < 0) {
+        ++idx_;
+      }
+    }
+  };
+  typedef Iterator<false> iterator;
+  typedef Iterator<true> const_iterator;
+
+ public:
+  /** Default constructor */
+  FlatHashMap() = default;
+
+  /** Entries are pooled; the map is move-only */
+  FlatHashMap(const FlatHashMap &other) = delete;
+  FlatHashMap& operator=(const FlatHashMap &other) = delete;
+  FlatHashMap(FlatHashMap &&other) noexcept = default;
+
+  /** Move assignment */
+  FlatHashMap& operator=(FlatHashMap &&other) noexcept {
+    if (this != &other) {
+      DestroyEntries();
+      ctrl_ = std::move(other.ctrl_);
+      slots_ = std::move(other.slots_);
+      pool_ = std::move(other.pool_);
+      size_ = other.size_;
+      tombstones_ = other.tombstones_;
+      other.size_ = 0;
+      other.tombstones_ = 0;
+    }
+    return *this;
+  }
+
+  /** Destructor */
+  ~FlatHashMap() {
+    DestroyEntries();
+  }
+
+  /** Number of entries */
+  size_t size() const {
+    return size_;
+  }
+
+  /** Whether the map has no entries */
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  /** Number of slots */
+  size_t capacity() const {
+    return slots_.size();
+  }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, slots_.size()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, slots_.size()); }
+
+  /**
+   * Iterator to the first entry stored at or after \a slot. Lets long scans
+   * resume where they stopped; entries inserted since may be skipped.
+   * */
+  iterator begin_from(size_t slot) {
+    return iterator(this, slot < slots_.size() ? slot : slots_.size());
+  }
+
+  /** Find an entry by key or by a transparent key view */
+  template<typename Q>
+  iterator find(const Q &key) {
+    return iterator(this, FindIndex(key, flat_hash::MixHash(hash_(key))));
+  }
+  template<typename Q>
+  const_iterator find(const Q &key) const {
+    return const_iterator(
+        this, FindIndex(key, flat_hash::MixHash(hash_(key))));
+  }
+
+  /** Number of entries matching \a key (0 or 1) */
+  template<typename Q>
+  size_t count(const Q &key) const {
+    return FindIndex(key, flat_hash::MixHash(hash_(key))) < slots_.size();
+  }
+
+  /** Insert an entry if \a key is not present */
+  template<typename ...Args>
+  std::pair<iterator, bool> emplace(const K &key, Args&& ...args) {
+    size_t hash = flat_hash::MixHash(hash_(key));
+    size_t idx = FindIndex(key, hash);
+    if (idx < slots_.size()) {
+      return {iterator(this, idx), false};
+    }
+    idx = InsertSlot(hash);
+    slots_[idx].entry_ = pool_.Allocate(
+        std::piecewise_construct,
+        std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    return {iterator(this, idx), true};
+  }
+
+  /** Get the value of \a key, default-constructing it if missing */
+  V& operator[](const K &key) {
+    return emplace(key).first->second;
+  }
+
+  /** Erase the entry of \a key */
+  template<typename Q>
+  size_t erase(const Q &key) {
+    size_t idx = FindIndex(key, flat_hash::MixHash(hash_(key)));
+    if (idx >= slots_.size()) {
+      return 0;
+    }
+    EraseIndex(idx);
+    return 1;
+  }
+
+  /** Erase the entry at \a it. Returns the following entry. */
+  iterator erase(iterator it) {
+    EraseIndex(it.idx_);
+    ++it;
+    return it;
+  }
+
+  /** Remove all entries */
+  void clear() {
+    DestroyEntries();
+    ctrl_.clear();
+    slots_.clear();
+    pool_.Clear();
+    size_ = 0;
+    tombstones_ = 0;
+  }
+
+  /** Make room for \a count entries without growing */
+  void reserve(size_t count) {
+    size_t cap = flat_hash::kGroupSize;
+    while (cap * 7 / 8 < count) {
+      cap *= 2;
+    }
+    if (cap > slots_.size()) {
+      Rehash(cap);
+    }
+  }
+
+  /** Bytes used by the table and its entries (excluding key/value heaps) */
+  size_t GetMemoryUsage() const {
+    return ctrl_.capacity() * sizeof(int8_t) +
+        slots_.capacity() * sizeof(Slot) +
+        pool_.GetMemoryUsage();
+  }
+
+ private:
+  /** Mask for wrapping group indices (group count is a power of 2) */
+  size_t GroupMask() const {
+    return slots_.size() / flat_hash::kGroupSize - 1;
+  }
+
+  /** Find the slot of \a key, or slots_.size() if missing */
+  template<typename Q>
+  size_t FindIndex(const Q &key, size_t hash) const {
+    if (slots_.empty()) {
+      return 0;
+    }
+    int8_t h2 = flat_hash::H2(hash);
+    size_t mask = GroupMask();
+    size_t group = (hash >> 7) & mask;
+    for (size_t probe = 1; probe <= mask + 1; ++probe) {
+      size_t base = group * flat_hash::kGroupSize;
+      flat_hash::Group grp(&ctrl_[base]);
+      uint32_t match = grp.Match(h2);
+      while (match) {
+        size_t idx = base + flat_hash::LowestBit(match);
+        const Slot &slot = slots_[idx];
+        if (slot.hash_ == hash && eq_(slot.entry_->first, key)) {
+          return idx;
+        }
+        match &= match - 1;
+      }
+      if (grp.MatchEmpty()) {
+        break;
+      }
+      // Triangular probing visits every group when the count is a power of 2
+      group = (group + probe) & mask;
+    }
+    return slots_.size();
+  }
+
+  /** Find a free slot for \a hash, growing the table if needed */
+  size_t InsertSlot(size_t hash) {
+    if (slots_.empty()) {
+      Rehash(flat_hash::kGroupSize);
+    } else if ((size_ + tombstones_ + 1) * 8 > slots_.size() * 7) {
+      if ((size_ + 1) * 16 > slots_.size() * 7) {
+        Rehash(slots_.size() * 2);
+      } else {
+        // Mostly tombstones: clean up in place
+        Rehash(slots_.size());
+      }
+    }
+    size_t idx = FindFree(hash);
+    if (ctrl_[idx] == flat_hash::kDeleted) {
+      --tombstones_;
+    }
+    ctrl_[idx] = flat_hash::H2(hash);
+    slots_[idx].hash_ = hash;
+    ++size_;
+    return idx;
+  }
+
+  /** Find the first empty or deleted slot on the probe sequence */
+  size_t FindFree(size_t hash) const {
+    size_t mask = GroupMask();
+    size_t group = (hash >> 7) & mask;
+    for (size_t probe = 1;; ++probe) {
+      size_t base = group * flat_hash::kGroupSize;
+      uint32_t free = flat_hash::Group(&ctrl_[base]).MatchFree();
+      if (free) {
+        return base + flat_hash::LowestBit(free);
+      }
+      group = (group + probe) & mask;
+    }
+  }
+
+  /** Move all entries to a table of \a new_cap slots */
+  void Rehash(size_t new_cap) {
+    std::vector<int8_t> old_ctrl(new_cap, flat_hash::kEmpty);
+    std::vector<Slot> old_slots(new_cap);
+    // Swap the fresh arrays in; the old_* vectors then hold the old table
+    old_ctrl.swap(ctrl_);
+    old_slots.swap(slots_);
+    for (size_t i = 0; i < old_slots.size(); ++i) {
+      if (old_ctrl[i] < 0) {
+        continue;
+      }
+      size_t idx = FindFree(old_slots[i].hash_);
+      ctrl_[idx] = old_ctrl[i];
+      slots_[idx] = old_slots[i];
+    }
+    tombstones_ = 0;
+  }
+
+  /** Erase the entry in slot \a idx */
+  void EraseIndex(size_t idx) {
+    pool_.Free(slots_[idx].entry_);
+    slots_[idx].entry_ = nullptr;
+    // If the group still has an empty slot, no probe sequence continues
+    // past it, so the slot can be marked empty instead of deleted.
+    size_t base = idx - idx % flat_hash::kGroupSize;
+    if (flat_hash::Group(&ctrl_[base]).MatchEmpty()) {
+      ctrl_[idx] = flat_hash::kEmpty;
+    } else {
+      ctrl_[idx] = flat_hash::kDeleted;
+      ++tombstones_;
+    }
+    --size_;
+  }
+
+  /** Destroy all live entries */
+  void DestroyEntries() {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      if (ctrl_[i] >= 0) {
+        slots_[i].entry_->~value_type();
+      }
+    }
+  }
+};
+
+}  // namespace hermes
+
+#endif  // HERMES_INCLUDE_HERMES_FLAT_HASH_MAP_H_
@@ -21,6 +21,7 @@ struct MetadataTable {
   std::vector<BlobInfo> blob_info_;
   std::vector<TargetStats> target_info_;
   std::vector<TagInfo> bkt_info_;
+  std::vector<FlushStats> flush_info_;
 };
 
 class Hermes {
@@ -51,9 +52,28 @@ class Hermes {
     table.blob_info_ = HERMES_CONF->blob_mdm_.PollBlobMetadataRoot();
     table.target_info_ = HERMES_CONF->blob_mdm_.PollTargetMetadataRoot();
     table.bkt_info_ = HERMES_CONF->bkt_mdm_.PollTagMetadataRoot();
+    table.flush_info_ = HERMES_CONF->blob_mdm_.PollFlushStatsRoot();
     return table;
   }
 
+  /**
+   * Collect a page of blob summaries matching \a query, resuming from
+   * \a cursor. Poll until cursor.done_ to visit the blobs of every node.
+   * */
+  std::vector<BlobStat> PollBlobMetadata(const BlobQuery &query,
+                                         MetadataCursor &cursor) {
+    return HERMES_CONF->blob_mdm_.PollBlobMetadataPageRoot(query, cursor);
+  }
+
+  /**
+   * Collect a page of tag summaries matching \a query, resuming from
+   * \a cursor. Poll until cursor.done_ to visit the tags of every node.
+   * */
+  std::vector<TagStat> PollTagMetadata(const TagQuery &query,
+                                       MetadataCursor &cursor) {
+    return HERMES_CONF->bkt_mdm_.PollTagMetadataPageRoot(query, cursor);
+  }
+
   /** Get or create a bucket */
   hermes::Bucket GetBucket(const std::string &path,
                            Context ctx = Context(),
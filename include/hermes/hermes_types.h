@@ -13,6 +13,10 @@
 #ifndef HRUN_TASKS_HERMES_INCLUDE_HERMES_HERMES_TYPES_H_
 #define HRUN_TASKS_HERMES_INCLUDE_HERMES_HERMES_TYPES_H_
 
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 #include "hrun/hrun_types.h"
 #include "hrun/task_registry/task_registry.h"
 #include "hrun/api/hrun_client.h"
@@ -111,11 +115,57 @@ class PlacementPolicyConv {
   }
 };
 
+/** Supported buffer compression codecs */
+enum class Codec : u8 {
+  kDefault,    /**< Use the codec of the target */
+  kNone,       /**< Store data uncompressed */
+  kLz,         /**< Built-in LZ77 codec */
+  kShuffleLz,  /**< Byte-shuffle 8-byte words, then LZ (numeric arrays) */
+};
+
+/** A class to convert codec enum value to string */
+class CodecConv {
+ public:
+  /** A function to return string representation of \a codec */
+  static std::string to_str(Codec codec) {
+    switch (codec) {
+      case Codec::kDefault: {
+        return "default";
+      }
+      case Codec::kNone: {
+        return "none";
+      }
+      case Codec::kLz: {
+        return "lz";
+      }
+      case Codec::kShuffleLz: {
+        return "shuffle_lz";
+      }
+    }
+    return "invalid";
+  }
+
+  /** return enum value of \a codec  */
+  static Codec to_enum(const std::string &codec) {
+    if (codec == "lz") {
+      return Codec::kLz;
+    } else if (codec == "shuffle_lz") {
+      return Codec::kShuffleLz;
+    } else if (codec == "default") {
+      return Codec::kDefault;
+    }
+    return Codec::kNone;
+  }
+};
+
 /** Hermes API call context */
 struct Context {
   /** Data placement engine */
   PlacementPolicy dpe_;
 
+  /** Codec for buffers the BORG moves (kDefault: use the target's) */
+  Codec codec_;
+
   /** The blob's score */
   float blob_score_;
 
@@ -130,6 +180,7 @@ struct Context {
 
   Context()
   : dpe_(PlacementPolicy::kNone),
+    codec_(Codec::kDefault),
     blob_score_(1),
     node_id_(0) {}
 };
@@ -221,12 +272,27 @@ struct BufferInfo {
   TargetId tid_;        /**< The destination target */
   size_t t_slab_;       /**< The index of the slab in the target */
   size_t t_off_;        /**< Offset in the target */
-  size_t t_size_;       /**< Size in the target */
+  size_t t_size_;       /**< Size of the blob data in the buffer */
+  Codec codec_ = Codec::kNone;  /**< Codec of the data in the target */
+  size_t c_size_ = 0;   /**< Compressed size in the target */
+  u64 fp_ = 0;          /**< Content hash if the slab is shared, else 0 */
 
   /** Serialization */
   template<typename Ar>
   void serialize(Ar &ar) {
-    ar(tid_, t_slab_, t_off_, t_size_);
+    u8 codec = static_cast<u8>(codec_);
+    ar(tid_, t_slab_, t_off_, t_size_, codec, c_size_, fp_);
+    codec_ = static_cast<Codec>(codec);
+  }
+
+  /** Whether the data is stored compressed */
+  bool IsCompressed() const {
+    return codec_ != Codec::kNone;
+  }
+
+  /** Number of bytes the buffer occupies in the target */
+  size_t GetTargetSize() const {
+    return IsCompressed() ? c_size_ : t_size_;
   }
 
   /** Default constructor */
@@ -265,6 +331,9 @@ struct BufferInfo {
     t_slab_ = other.t_slab_;
     t_off_ = other.t_off_;
     t_size_ = other.t_size_;
+    codec_ = other.codec_;
+    c_size_ = other.c_size_;
+    fp_ = other.fp_;
   }
 };
 
@@ -274,6 +343,7 @@ struct BlobInfo {
   BlobId blob_id_;  /**< Unique ID of the blob */
   hshm::charbuf name_;  /**< Name of the blob */
   std::vector<BufferInfo> buffers_;  /**< Set of buffers */
+  std::vector<size_t> buf_ends_;  /**< Prefix sum of buffer sizes */
   std::vector<TagId> tags_;  /**< Set of tags */
   size_t blob_size_;      /**< The overall size of the blob */
   size_t max_blob_size_;  /**< The amount of space current buffers support */
@@ -283,13 +353,24 @@ struct BlobInfo {
   hshm::Timepoint last_access_;  /**< Last time blob accessed */
   std::atomic<size_t> mod_count_;   /**< The number of times blob modified */
   std::atomic<size_t> last_flush_;  /**< The last mod that was flushed */
+  std::atomic<u32> writers_{0};  /**< Puts still writing to the buffers */
+  std::atomic<size_t> buf_gen_{0};  /**< Bumped as each put begins and ends */
   bitfield32_t flags_;  /**< Flags */
+  BlobInfo *dirty_prev_ = nullptr;  /**< Previous blob in the dirty list */
+  BlobInfo *dirty_next_ = nullptr;  /**< Next blob in the dirty list */
+  bool is_dirty_ = false;  /**< Whether the blob is in the dirty list */
+  double rescore_time_ = -1;  /**< When to refresh the score, or -1 */
+  u32 reorg_version_ = 0;  /**< Invalidates stale reorganize candidates */
+  Codec codec_ = Codec::kDefault;  /**< Codec when migrated (kDefault: target's) */
 
   /** Serialization */
   template<typename Ar>
   void serialize(Ar &ar) {
+    u8 codec = static_cast<u8>(codec_);
     ar(tag_id_, blob_id_, name_, buffers_, tags_, blob_size_, max_blob_size_,
-       score_, access_freq_, mod_count_, last_flush_);
+       score_, user_score_, access_freq_, mod_count_, last_flush_,
+       flags_, codec);
+    codec_ = static_cast<Codec>(codec);
   }
 
   /** Default constructor */
@@ -301,6 +382,7 @@ struct BlobInfo {
     blob_id_ = other.blob_id_;
     name_ = other.name_;
     buffers_ = other.buffers_;
+    buf_ends_ = other.buf_ends_;
     tags_ = other.tags_;
     blob_size_ = other.blob_size_;
     max_blob_size_ = other.max_blob_size_;
@@ -310,6 +392,76 @@ struct BlobInfo {
     last_access_ = other.last_access_;
     mod_count_ = other.mod_count_.load();
     last_flush_ = other.last_flush_.load();
+    flags_ = other.flags_;
+    codec_ = other.codec_;
+  }
+
+  /**
+   * Extend the extent index over buffers appended since the last update.
+   * Returns the total number of bytes covered by the buffers.
+   * */
+  size_t UpdateExtents() {
+    size_t off = buf_ends_.size() ? buf_ends_.back() : 0;
+    buf_ends_.reserve(buffers_.size());
+    for (size_t i = buf_ends_.size(); i < buffers_.size(); ++i) {
+      off += buffers_[i].t_size_;
+      buf_ends_.emplace_back(off);
+    }
+    return off;
+  }
+
+  /** Rebuild the extent index after buffers_ was modified in-place */
+  size_t RebuildExtents() {
+    buf_ends_.clear();
+    return UpdateExtents();
+  }
+
+  /** Remove all buffers and the extent index */
+  void ClearBuffers() {
+    buffers_.clear();
+    buf_ends_.clear();
+  }
+
+  /**
+   * Find the index of the buffer containing the blob offset.
+   * Returns buffers_.size() if the offset is past the last buffer.
+   * */
+  size_t FindBuffer(size_t blob_off) {
+    if (buf_ends_.size() != buffers_.size()) {
+      UpdateExtents();
+    }
+    auto it = std::upper_bound(buf_ends_.begin(), buf_ends_.end(), blob_off);
+    return it - buf_ends_.begin();
+  }
+
+  /** Get the blob offset where a buffer begins */
+  size_t GetBufferOffset(size_t buf_idx) {
+    return buf_idx == 0 ? 0 : buf_ends_[buf_idx - 1];
+  }
+
+  /** Whether the blob was modified since it was last flushed */
+  bool NeedsFlush() const {
+    return last_flush_ > 0 && mod_count_ > last_flush_;
+  }
+
+  /**
+   * Mark a put as writing to the buffers. Must be called before the put
+   * first yields, so a reorganize copying the buffers sees it.
+   * */
+  void BeginWrite() {
+    writers_.fetch_add(1);
+    buf_gen_.fetch_add(1);
+  }
+
+  /** Mark a put as done writing to the buffers */
+  void EndWrite() {
+    buf_gen_.fetch_add(1);
+    writers_.fetch_sub(1);
+  }
+
+  /** Whether a put wrote to the buffers since \a buf_gen was read */
+  bool WroteSince(size_t buf_gen) const {
+    return writers_ > 0 || buf_gen_ != buf_gen;
   }
 
   /** Update modify stats */
@@ -332,13 +484,129 @@ struct BlobInfo {
   }
 };
 
+/**
+ * Key of the blob name -> blob id map. The key does not own the name: it
+ * views the name in the request during lookups and the name interned in
+ * the blob's BlobInfo once stored. The hash is HashBlobName, which clients
+ * already compute to route the request (the task's lane_hash_).
+ * */
+struct BlobNameKey {
+  TagId tag_id_;           /**< Tag the blob is on */
+  std::string_view name_;  /**< Name of the blob */
+  u32 hash_;               /**< Hash of the tag and name */
+
+  BlobNameKey(const TagId &tag_id, std::string_view name, u32 hash)
+      : tag_id_(tag_id), name_(name), hash_(hash) {}
+
+  BlobNameKey(const TagId &tag_id, const hshm::charbuf &name, u32 hash)
+      : tag_id_(tag_id), name_(name.data(), name.size()), hash_(hash) {}
+
+  bool operator==(const BlobNameKey &other) const {
+    return tag_id_ == other.tag_id_ && name_ == other.name_;
+  }
+};
+
+/** Returns the precomputed hash of a BlobNameKey */
+struct BlobNameHash {
+  size_t operator()(const BlobNameKey &key) const {
+    return key.hash_;
+  }
+};
+
+/**
+ * The blobs of a tag: a dense vector for iteration and a position map for
+ * O(1) membership. Erasing swaps the last blob into the hole, so the order
+ * of the blobs is not preserved. Serializes as the vector alone.
+ * */
+class BlobIdSet {
+ public:
+  typedef std::vector<BlobId>::iterator iterator;
+  typedef std::vector<BlobId>::const_iterator const_iterator;
+
+  std::vector<BlobId> ids_;                   /**< The blobs, densely */
+  std::unordered_map<BlobId, size_t> pos_;   /**< Blob -> index in ids_ */
+
+ public:
+  /** Add \a blob_id. Returns false if it is already present. */
+  bool emplace(const BlobId &blob_id) {
+    auto ret = pos_.emplace(blob_id, ids_.size());
+    if (!ret.second) {
+      return false;
+    }
+    ids_.emplace_back(blob_id);
+    return true;
+  }
+
+  /** Remove \a blob_id. Returns false if it is not present. */
+  bool erase(const BlobId &blob_id) {
+    auto it = pos_.find(blob_id);
+    if (it == pos_.end()) {
+      return false;
+    }
+    size_t idx = it->second;
+    pos_.erase(it);
+    if (idx + 1 != ids_.size()) {
+      ids_[idx] = ids_.back();
+      pos_[ids_[idx]] = idx;
+    }
+    ids_.pop_back();
+    return true;
+  }
+
+  /** Whether \a blob_id is in the set */
+  bool contains(const BlobId &blob_id) const {
+    return pos_.find(blob_id) != pos_.end();
+  }
+
+  /** Make room for \a count blobs */
+  void reserve(size_t count) {
+    ids_.reserve(count);
+    pos_.reserve(count);
+  }
+
+  /** Remove all blobs */
+  void clear() {
+    ids_.clear();
+    pos_.clear();
+  }
+
+  size_t size() const { return ids_.size(); }
+  bool empty() const { return ids_.empty(); }
+  iterator begin() { return ids_.begin(); }
+  iterator end() { return ids_.end(); }
+  const_iterator begin() const { return ids_.begin(); }
+  const_iterator end() const { return ids_.end(); }
+
+  /** The blobs as a vector */
+  const std::vector<BlobId>& ids() const { return ids_; }
+
+  /** Serialize */
+  template<typename Ar>
+  void save(Ar &ar) const {
+    ar(ids_);
+  }
+
+  /** Deserialize, dropping duplicates */
+  template<typename Ar>
+  void load(Ar &ar) {
+    std::vector<BlobId> ids;
+    ar(ids);
+    clear();
+    reserve(ids.size());
+    for (BlobId &blob_id : ids) {
+      emplace(blob_id);
+    }
+  }
+};
+
 /** Data structure used to store Bucket information */
 struct TagInfo {
   TagId tag_id_;
   hshm::charbuf name_;
-  std::list<BlobId> blobs_;
+  BlobIdSet blobs_;
   std::list<Task*> traits_;
   size_t internal_size_;
+  size_t append_off_ = 0;  /**< End of the ranges reserved for appends */
   size_t page_size_;
   bitfield32_t flags_;
   bool owner_;
@@ -434,6 +702,255 @@ struct IoStat {
   }
 };
 
+/** Statistics of the BORG: blob flushing (stage-out) and tier migration */
+struct FlushStats {
+  u32 node_id_;             /**< Node the statistics are from */
+  size_t queue_depth_;      /**< Number of blobs waiting to be flushed */
+  size_t inflight_blobs_;   /**< Number of blobs being flushed */
+  size_t inflight_bytes_;   /**< Number of bytes being flushed */
+  size_t flushed_blobs_;    /**< Number of blobs flushed since startup */
+  size_t flushed_bytes_;    /**< Number of bytes flushed since startup */
+  double mbps_;             /**< Throughput of the last flush period */
+  size_t executed_migrations_;  /**< Buffers moved between tiers */
+  size_t deferred_migrations_;  /**< Moves postponed by the budget */
+  size_t migrated_bytes_;       /**< Bytes moved between tiers */
+
+  /** Default constructor */
+  FlushStats()
+      : node_id_(0), queue_depth_(0), inflight_blobs_(0), inflight_bytes_(0),
+        flushed_blobs_(0), flushed_bytes_(0), mbps_(0),
+        executed_migrations_(0), deferred_migrations_(0),
+        migrated_bytes_(0) {}
+
+  /** Accumulate the statistics of another lane */
+  void Merge(const FlushStats &other) {
+    queue_depth_ += other.queue_depth_;
+    inflight_blobs_ += other.inflight_blobs_;
+    inflight_bytes_ += other.inflight_bytes_;
+    flushed_blobs_ += other.flushed_blobs_;
+    flushed_bytes_ += other.flushed_bytes_;
+    mbps_ += other.mbps_;
+    executed_migrations_ += other.executed_migrations_;
+    deferred_migrations_ += other.deferred_migrations_;
+    migrated_bytes_ += other.migrated_bytes_;
+  }
+
+  /** Serialize */
+  template<typename Ar>
+  void serialize(Ar &ar) {
+    ar(node_id_, queue_depth_, inflight_blobs_, inflight_bytes_,
+       flushed_blobs_, flushed_bytes_, mbps_,
+       executed_migrations_, deferred_migrations_, migrated_bytes_);
+  }
+};
+
+/**
+ * Position of a paginated metadata poll. A poll walks the lanes of each
+ * node in turn, starting from node 1, and resumes from the slot of the
+ * lane's table where the previous page stopped. Entries inserted while
+ * the poll runs may be missed, and entries may be returned twice if a
+ * table grows between pages.
+ * */
+struct MetadataCursor {
+  /** Pages worth of entries a poll examines at most, matching or not */
+  static const u32 kMaxScanPages = 8;
+
+  u32 node_id_ = 1;    /**< Node being polled */
+  u32 lane_ = 0;       /**< Lane of the node being polled */
+  size_t slot_ = 0;    /**< Next slot of the lane's table */
+  bool done_ = false;  /**< Whether every node was polled */
+
+  /** Move past the end of the current lane */
+  void NextLane(u32 num_lanes, u32 num_nodes) {
+    slot_ = 0;
+    if (++lane_ < num_lanes) {
+      return;
+    }
+    lane_ = 0;
+    if (++node_id_ > num_nodes) {
+      done_ = true;
+    }
+  }
+
+  /** Serialize */
+  template<typename Ar>
+  void serialize(Ar &ar) {
+    ar(node_id_, lane_, slot_, done_);
+  }
+};
+
+/** Filters of a paginated blob metadata poll, evaluated by the server */
+struct BlobQuery {
+  TagId tag_id_;             /**< Only blobs in this tag, unless null */
+  TargetId tgt_id_;          /**< Only blobs with a buffer here, unless null */
+  float min_score_ = 0;      /**< Only blobs scored at least this */
+  bool dirty_only_ = false;  /**< Only blobs modified since their flush */
+  std::string name_prefix_;  /**< Only blobs whose names start with this */
+  u32 page_size_ = 1024;     /**< Maximum number of blobs in a page */
+
+  /** Default constructor */
+  BlobQuery() {
+    tag_id_.SetNull();
+    tgt_id_.SetNull();
+  }
+
+  /** Whether \a blob_info passes the filters */
+  bool Match(const BlobInfo &blob_info) const {
+    if (!tag_id_.IsNull() && blob_info.tag_id_ != tag_id_) {
+      return false;
+    }
+    if (blob_info.score_ < min_score_) {
+      return false;
+    }
+    if (dirty_only_ && !blob_info.NeedsFlush()) {
+      return false;
+    }
+    if (blob_info.name_.size() < name_prefix_.size() ||
+        memcmp(blob_info.name_.data(), name_prefix_.data(),
+               name_prefix_.size()) != 0) {
+      return false;
+    }
+    if (!tgt_id_.IsNull()) {
+      return std::any_of(blob_info.buffers_.begin(), blob_info.buffers_.end(),
+                         [this](const BufferInfo &buf) {
+                           return buf.tid_ == tgt_id_;
+                         });
+    }
+    return true;
+  }
+
+  /** Serialize */
+  template<typename Ar>
+  void serialize(Ar &ar) {
+    ar(tag_id_, tgt_id_, min_score_, dirty_only_, name_prefix_, page_size_);
+  }
+};
+
+/** Fixed-size summary of a blob, returned by paginated polls */
+struct BlobStat {
+  BlobId blob_id_;     /**< Unique ID of the blob */
+  TagId tag_id_;       /**< Tag the blob is on */
+  TargetId tgt_id_;    /**< Target holding most of the blob */
+  size_t blob_size_;   /**< The overall size of the blob */
+  float score_;        /**< The priority of the blob */
+  float user_score_;   /**< The user-defined priority of the blob */
+  u32 access_freq_;    /**< Number of times accessed in the epoch */
+  u32 num_buffers_;    /**< Number of buffers holding the blob */
+  size_t mod_count_;   /**< The number of times the blob was modified */
+  size_t last_flush_;  /**< The last modification that was flushed */
+
+  /** Default constructor */
+  BlobStat() = default;
+
+  /** Summarize \a blob_info */
+  explicit BlobStat(const BlobInfo &blob_info)
+      : blob_id_(blob_info.blob_id_), tag_id_(blob_info.tag_id_),
+        blob_size_(blob_info.blob_size_), score_(blob_info.score_),
+        user_score_(blob_info.user_score_),
+        access_freq_(blob_info.access_freq_.load()),
+        num_buffers_(blob_info.buffers_.size()),
+        mod_count_(blob_info.mod_count_.load()),
+        last_flush_(blob_info.last_flush_.load()) {
+    // Blobs span few targets, so a linear search beats a map here
+    std::vector<std::pair<TargetId, size_t>> tgt_sizes;
+    size_t max_size = 0;
+    tgt_id_.SetNull();
+    for (const BufferInfo &buf : blob_info.buffers_) {
+      auto it = std::find_if(tgt_sizes.begin(), tgt_sizes.end(),
+                             [&buf](const std::pair<TargetId, size_t> &tgt) {
+                               return tgt.first == buf.tid_;
+                             });
+      if (it == tgt_sizes.end()) {
+        it = tgt_sizes.emplace(tgt_sizes.end(), buf.tid_, 0);
+      }
+      it->second += buf.t_size_;
+      if (it->second > max_size) {
+        max_size = it->second;
+        tgt_id_ = buf.tid_;
+      }
+    }
+  }
+
+  /** Serialize */
+  template<typename Ar>
+  void serialize(Ar &ar) {
+    ar(blob_id_, tag_id_, tgt_id_, blob_size_, score_, user_score_,
+       access_freq_, num_buffers_, mod_count_, last_flush_);
+  }
+};
+
+/** A blob name and its id, returned by name listings */
+struct BlobNameEntry {
+  std::string name_;  /**< Name of the blob */
+  BlobId blob_id_;    /**< Unique ID of the blob */
+
+  /** Default constructor */
+  BlobNameEntry() = default;
+
+  /** Emplace constructor */
+  BlobNameEntry(std::string name, const BlobId &blob_id)
+      : name_(std::move(name)), blob_id_(blob_id) {}
+
+  /** Order by name */
+  bool operator<(const BlobNameEntry &other) const {
+    return name_ < other.name_;
+  }
+
+  /** Serialize */
+  template<typename Ar>
+  void serialize(Ar &ar) {
+    ar(name_, blob_id_);
+  }
+};
+
+/** Filters of a paginated tag metadata poll, evaluated by the server */
+struct TagQuery {
+  size_t min_size_ = 0;      /**< Only tags holding at least this many bytes */
+  std::string name_prefix_;  /**< Only tags whose names start with this */
+  u32 page_size_ = 1024;     /**< Maximum number of tags in a page */
+
+  /** Whether \a tag_info passes the filters */
+  bool Match(const TagInfo &tag_info) const {
+    if (tag_info.internal_size_ < min_size_) {
+      return false;
+    }
+    return tag_info.name_.size() >= name_prefix_.size() &&
+        memcmp(tag_info.name_.data(), name_prefix_.data(),
+               name_prefix_.size()) == 0;
+  }
+
+  /** Serialize */
+  template<typename Ar>
+  void serialize(Ar &ar) {
+    ar(min_size_, name_prefix_, page_size_);
+  }
+};
+
+/** Fixed-size summary of a tag, returned by paginated polls */
+struct TagStat {
+  TagId tag_id_;          /**< Unique ID of the tag */
+  size_t internal_size_;  /**< Bytes in the tag's blobs */
+  size_t page_size_;      /**< Page size of the bucket */
+  size_t num_blobs_;      /**< Number of blobs in the tag */
+  u32 flags_;             /**< Flags of the tag */
+  bool owner_;            /**< Whether the tag owns its blobs */
+
+  /** Default constructor */
+  TagStat() = default;
+
+  /** Summarize \a tag_info */
+  explicit TagStat(const TagInfo &tag_info)
+      : tag_id_(tag_info.tag_id_), internal_size_(tag_info.internal_size_),
+        page_size_(tag_info.page_size_), num_blobs_(tag_info.blobs_.size()),
+        flags_(tag_info.flags_.bits_), owner_(tag_info.owner_) {}
+
+  /** Serialize */
+  template<typename Ar>
+  void serialize(Ar &ar) {
+    ar(tag_id_, internal_size_, page_size_, num_blobs_, flags_, owner_);
+  }
+};
+
 /** Used for debugging concurrency issues with locks */
 enum LockOwners {
   kNone = 0,
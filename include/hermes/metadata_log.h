@@ -0,0 +1,312 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HERMES_INCLUDE_HERMES_METADATA_LOG_H_
+#define HERMES_INCLUDE_HERMES_METADATA_LOG_H_
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <functional>
+#include <sstream>
+#include <string>
+#include "hermes/hermes_types.h"
+
+namespace hermes {
+
+/** The kinds of records in a metadata log */
+enum class LogOp : u8 {
+  kHeader = 0,     /**< Generation of a log or snapshot */
+  kLanes,          /**< Number of lanes of the metadata manager */
+  kTarget,         /**< TargetId, device name and slab sizes of a target */
+  kPutBlob,        /**< BlobId and the whole BlobInfo */
+  kDelBlob,        /**< BlobId */
+  kPutTag,         /**< TagId, TagInfo, stager url and params */
+  kDelTag,         /**< TagId */
+  kTagSize,        /**< TagId and the bucket size */
+  kTagBlobs,       /**< TagId and all of its BlobIds */
+  kTagAddBlob,     /**< TagId and BlobId */
+  kTagRemoveBlob,  /**< TagId and BlobId */
+};
+
+/**
+ * Write-ahead log and snapshot of one lane of a metadata manager.
+ *
+ * A record is a LogOp and its cereal-serialized arguments, framed by a
+ * length and a checksum so a torn write at the end of the log is
+ * dropped on replay. A snapshot is a file of records rebuilding the
+ * whole lane. Both start with a generation number: a snapshot is written
+ * to a temporary file and renamed with the next generation before the
+ * log restarts, so a log older than the snapshot is never replayed.
+ * Records are not synced, so a restart of the runtime loses nothing,
+ * while a crash of the machine can lose the tail of the log.
+ * */
+class MetadataLog {
+ public:
+  /** Applies a record during replay */
+  typedef std::function<void(LogOp, cereal::BinaryInputArchive&)> ReplayFn;
+
+  /** Appends records to a snapshot */
+  class Writer {
+   public:
+    std::string data_;
+
+    template<typename ...Args>
+    void Append(LogOp op, const Args& ...args) {
+      data_ += Encode(op, args...);
+    }
+  };
+
+  std::string log_path_;
+  std::string snap_path_;
+  int fd_ = -1;
+  u64 gen_ = 0;
+  size_t log_size_ = 0;
+
+ public:
+  /** Default constructor */
+  MetadataLog() = default;
+
+  /** Move constructor, so lanes can be kept in a vector */
+  MetadataLog(MetadataLog &&other) noexcept
+      : log_path_(std::move(other.log_path_)),
+        snap_path_(std::move(other.snap_path_)),
+        fd_(other.fd_), gen_(other.gen_), log_size_(other.log_size_) {
+    other.fd_ = -1;
+  }
+
+  /** Close the log */
+  ~MetadataLog() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  /** Use the log and snapshot named \a name in \a dir */
+  void Init(const std::string &dir, const std::string &name) {
+    log_path_ = hshm::Formatter::format("{}/{}.log", dir, name);
+    snap_path_ = hshm::Formatter::format("{}/{}.snap", dir, name);
+  }
+
+  /**
+   * Apply the snapshot and then the log through \a apply.
+   * Returns the number of records applied.
+   * */
+  size_t Replay(const ReplayFn &apply) {
+    size_t count = 0;
+    u64 snap_gen = 0;
+    u64 log_gen = 0;
+    std::string snap = ReadFile(snap_path_);
+    count += ReplayRecords(snap, snap_gen, apply);
+    std::string log = ReadFile(log_path_);
+    if (ReadGeneration(log, log_gen) && log_gen == snap_gen) {
+      count += ReplayRecords(log, log_gen, apply);
+    }
+    gen_ = snap_gen;
+    return count;
+  }
+
+  /**
+   * Replace the snapshot with the records \a fill appends to a Writer,
+   * then restart the log. Returns false if the snapshot is not durable,
+   * in which case the log is left as it was.
+   * */
+  template<typename FillT>
+  bool Snapshot(FillT &&fill) {
+    Writer writer;
+    writer.Append(LogOp::kHeader, gen_ + 1);
+    fill(writer);
+    std::string tmp_path = snap_path_ + ".tmp";
+    int fd = open(tmp_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0666);
+    if (fd < 0) {
+      HELOG(kError, "Failed to create snapshot {}: {}",
+            tmp_path, strerror(errno));
+      return false;
+    }
+    bool ok = WriteAll(fd, writer.data_) && fsync(fd) == 0;
+    close(fd);
+    if (!ok || rename(tmp_path.c_str(), snap_path_.c_str()) != 0) {
+      HELOG(kError, "Failed to write snapshot {}: {}",
+            snap_path_, strerror(errno));
+      return false;
+    }
+    gen_ += 1;
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+    fd_ = open(log_path_.c_str(), O_CREAT | O_TRUNC | O_WRONLY | O_APPEND,
+               0666);
+    if (fd_ < 0) {
+      HELOG(kError, "Failed to open metadata log {}: {}",
+            log_path_, strerror(errno));
+      return false;
+    }
+    log_size_ = 0;
+    Append(LogOp::kHeader, gen_);
+    return true;
+  }
+
+  /** Append a record to the log */
+  template<typename ...Args>
+  void Append(LogOp op, const Args& ...args) {
+    if (fd_ < 0) {
+      return;
+    }
+    std::string record = Encode(op, args...);
+    if (!WriteAll(fd_, record)) {
+      HELOG(kError, "Failed to append to metadata log {}: {}",
+            log_path_, strerror(errno));
+      return;
+    }
+    log_size_ += record.size();
+  }
+
+  /** Whether the log has grown past \a max_size bytes */
+  bool NeedsSnapshot(size_t max_size) const {
+    return log_size_ >= max_size;
+  }
+
+ private:
+  /** Frame: payload length and checksum, then the op and arguments */
+  static const size_t kFrameSize = sizeof(u32) + sizeof(u64);
+
+  /** FNV-1a over a record's payload */
+  static u64 Checksum(const char *data, size_t size) {
+    u64 hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+      hash ^= (u8)data[i];
+      hash *= 0x100000001b3ULL;
+    }
+    return hash;
+  }
+
+  /** Serialize one framed record */
+  template<typename ...Args>
+  static std::string Encode(LogOp op, const Args& ...args) {
+    std::stringstream ss;
+    {
+      cereal::BinaryOutputArchive ar(ss);
+      u8 op_id = static_cast<u8>(op);
+      ar(op_id, args...);
+    }
+    std::string payload = ss.str();
+    u32 size = (u32)payload.size();
+    u64 checksum = Checksum(payload.data(), payload.size());
+    std::string record(kFrameSize, 0);
+    memcpy(record.data(), &size, sizeof(size));
+    memcpy(record.data() + sizeof(size), &checksum, sizeof(checksum));
+    record += payload;
+    return record;
+  }
+
+  /** Read the next framed payload at \a off, if it is intact */
+  static bool NextPayload(const std::string &data, size_t &off,
+                          std::string &payload) {
+    u32 size;
+    u64 checksum;
+    if (data.size() - off < kFrameSize) {
+      return false;
+    }
+    memcpy(&size, data.data() + off, sizeof(size));
+    memcpy(&checksum, data.data() + off + sizeof(size), sizeof(checksum));
+    if (data.size() - off - kFrameSize < size) {
+      return false;
+    }
+    const char *ptr = data.data() + off + kFrameSize;
+    if (Checksum(ptr, size) != checksum) {
+      return false;
+    }
+    payload.assign(ptr, size);
+    off += kFrameSize + size;
+    return true;
+  }
+
+  /** Read the generation in the header of \a data */
+  static bool ReadGeneration(const std::string &data, u64 &gen) {
+    size_t off = 0;
+    std::string payload;
+    if (!NextPayload(data, off, payload)) {
+      return false;
+    }
+    std::stringstream ss(payload);
+    cereal::BinaryInputArchive ar(ss);
+    u8 op_id;
+    ar(op_id);
+    if (static_cast<LogOp>(op_id) != LogOp::kHeader) {
+      return false;
+    }
+    ar(gen);
+    return true;
+  }
+
+  /** Apply the records of \a data, stopping at the first bad one */
+  static size_t ReplayRecords(const std::string &data, u64 &gen,
+                              const ReplayFn &apply) {
+    size_t off = 0;
+    size_t count = 0;
+    std::string payload;
+    while (NextPayload(data, off, payload)) {
+      std::stringstream ss(payload);
+      cereal::BinaryInputArchive ar(ss);
+      u8 op_id;
+      ar(op_id);
+      LogOp op = static_cast<LogOp>(op_id);
+      if (op == LogOp::kHeader) {
+        ar(gen);
+        continue;
+      }
+      try {
+        apply(op, ar);
+      } catch (cereal::Exception &e) {
+        HELOG(kError, "Dropping a malformed metadata record: {}", e.what());
+        break;
+      }
+      ++count;
+    }
+    return count;
+  }
+
+  /** Read a whole file, or nothing if it does not exist */
+  static std::string ReadFile(const std::string &path) {
+    std::string data;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return data;
+    }
+    char buf[65536];
+    ssize_t count;
+    while ((count = read(fd, buf, sizeof(buf))) > 0) {
+      data.append(buf, count);
+    }
+    close(fd);
+    return data;
+  }
+
+  /** Write all of \a data */
+  static bool WriteAll(int fd, const std::string &data) {
+    size_t off = 0;
+    while (off < data.size()) {
+      ssize_t count = write(fd, data.data() + off, data.size() - off);
+      if (count < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      off += count;
+    }
+    return true;
+  }
+};
+
+}  // namespace hermes
+
+#endif  // HERMES_INCLUDE_HERMES_METADATA_LOG_H_
@@ -13,6 +13,7 @@
 #ifndef HRUN_TASKS_HERMES_INCLUDE_HERMES_SLAB_ALLOCATOR_H_
 #define HRUN_TASKS_HERMES_INCLUDE_HERMES_SLAB_ALLOCATOR_H_
 
+#include <algorithm>
 #include "hrun/hrun_types.h"
 #include "hermes/hermes_types.h"
 
@@ -59,6 +60,24 @@ class SlabAllocator {
     }
   }
 
+  /**
+   * Round the slab sizes up to multiples of \a alignment, so every slab
+   * starts and ends on an aligned offset of the device. Sizes that round
+   * to the same value are merged.
+   * */
+  static void AlignSlabSizes(std::vector<size_t> &slab_sizes,
+                             size_t alignment) {
+    if (alignment <= 1) {
+      return;
+    }
+    for (size_t &slab_size : slab_sizes) {
+      slab_size = (slab_size + alignment - 1) / alignment * alignment;
+    }
+    std::sort(slab_sizes.begin(), slab_sizes.end());
+    slab_sizes.erase(std::unique(slab_sizes.begin(), slab_sizes.end()),
+                     slab_sizes.end());
+  }
+
   /**
    * Allocate enough slabs to ideally fit the size
    * It can allocate less than or more than the requested size
@@ -152,10 +171,67 @@ class SlabAllocator {
     for (const auto &buffer : buffers) {
       auto &slab = slab_lists_[buffer.t_slab_];
       slab.buffers_.push_back(buffer);
+      // Migrated buffers record the blob's size, not the slab size
+      BufferInfo &free_buf = slab.buffers_.back();
+      free_buf.t_size_ = slab.slab_size_;
+      free_buf.codec_ = Codec::kNone;
+      free_buf.c_size_ = 0;
+      free_buf.fp_ = 0;
       total_size += slab.slab_size_;
     }
     return total_size;
   }
+
+  /**
+   * Rebuild the allocator around the buffers still in use after a
+   * restart. The heap resumes after the last used slab, and the gaps
+   * between used slabs go to the free lists, largest slabs first.
+   * Buffers must come from an allocator with the same slab sizes.
+   * Returns the number of bytes in use.
+   * */
+  size_t Reserve(std::vector<BufferInfo> used) {
+    std::sort(used.begin(), used.end(),
+              [](const BufferInfo &a, const BufferInfo &b) {
+                return a.t_off_ < b.t_off_;
+              });
+    for (Slab &slab : slab_lists_) {
+      slab.buffers_.clear();
+    }
+    size_t off = 0;
+    size_t total_size = 0;
+    for (const BufferInfo &buf : used) {
+      size_t slab_size = slab_lists_[buf.t_slab_].slab_size_;
+      if (buf.t_off_ + slab_size <= off) {
+        continue;
+      }
+      if (buf.t_off_ > off) {
+        FreeRange(off, buf.t_off_);
+      }
+      off = buf.t_off_ + slab_size;
+      total_size += slab_size;
+    }
+    heap_ = off;
+    return total_size;
+  }
+
+ private:
+  /** Add the space in [off, end) to the free lists */
+  void FreeRange(size_t off, size_t end) {
+    for (size_t i = slab_lists_.size(); i > 0 && off < end;) {
+      Slab &slab = slab_lists_[i - 1];
+      if (slab.slab_size_ > end - off) {
+        --i;
+        continue;
+      }
+      slab.buffers_.emplace_back();
+      BufferInfo &buf = slab.buffers_.back();
+      buf.tid_ = target_id_;
+      buf.t_off_ = off;
+      buf.t_size_ = slab.slab_size_;
+      buf.t_slab_ = i - 1;
+      off += slab.slab_size_;
+    }
+  }
 };
 
 }  // namespace hermes
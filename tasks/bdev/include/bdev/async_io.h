@@ -0,0 +1,37 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HRUN_TASKS_BDEV_INCLUDE_BDEV_ASYNC_IO_H_
+#define HRUN_TASKS_BDEV_INCLUDE_BDEV_ASYNC_IO_H_
+
+#include <cstddef>
+
+namespace hermes::bdev {
+
+/**
+ * Progress of a Read or Write handed to an asynchronous I/O engine.
+ * The engine completes it from the poll of whichever task reaps it.
+ * */
+struct AsyncIo {
+  size_t done_ = 0;       /**< Bytes transferred so far */
+  int err_ = 0;           /**< Negative errno if the transfer failed */
+  bool pending_ = false;  /**< Queued in the engine and not completed */
+
+  /** Whether the engine is finished with a transfer of \a size bytes */
+  bool IsDone(size_t size) const {
+    return !pending_ && (err_ != 0 || done_ >= size);
+  }
+};
+
+}  // namespace hermes::bdev
+
+#endif  // HRUN_TASKS_BDEV_INCLUDE_BDEV_ASYNC_IO_H_
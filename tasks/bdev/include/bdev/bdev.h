@@ -7,6 +7,7 @@
 
 #include "bdev_tasks.h"
 #include "hermes/score_histogram.h"
+#include "hermes/slab_allocator.h"
 
 namespace hermes::bdev {
 
@@ -24,6 +25,11 @@ class Client : public TaskLibClient {
   float bw_score_;       /**< Relative importance of this tier */
   f32 borg_min_thresh_;  /**< Capacity percentage too low */
   f32 borg_max_thresh_;  /**< Capacity percentage too high */
+  Codec codec_;          /**< Codec of buffers migrated to this target */
+  size_t max_slab_size_;  /**< Largest buffer the target allocates */
+  std::string dev_name_;  /**< Name of the device in the server config */
+  std::vector<size_t> slab_sizes_;  /**< Slab sizes of the target */
+  bool is_persistent_;   /**< Whether data outlives the runtime */
 
  public:
   Client() : score_(0) {}
@@ -36,6 +42,20 @@ class Client : public TaskLibClient {
     score_ = 0;
     borg_min_thresh_ = dev_info.borg_min_thresh_;
     borg_max_thresh_ = dev_info.borg_max_thresh_;
+    codec_ = dev_info.codec_;
+    // Direct I/O needs block-aligned slabs. The ConstructTask carries the
+    // rounded sizes to the server's allocator.
+    if (dev_info.direct_io_) {
+      SlabAllocator::AlignSlabSizes(dev_info.slab_sizes_,
+                                    dev_info.block_size_);
+    }
+    max_slab_size_ = 0;
+    for (size_t slab_size : dev_info.slab_sizes_) {
+      max_slab_size_ = std::max(max_slab_size_, slab_size);
+    }
+    dev_name_ = dev_info.dev_name_;
+    slab_sizes_ = dev_info.slab_sizes_;
+    is_persistent_ = !dev_info.mount_dir_.empty();
   }
 
   /** Async create task state */
@@ -117,28 +137,80 @@ class Client : public TaskLibClient {
     HRUN_CLIENT->ConstructTask<FreeTask>(
         task, task_node, domain_id_, id_, score, buffers, fire_and_forget);
   }
+  /** Free the buffers of many blobs, with one score per blob */
+  HSHM_ALWAYS_INLINE
+  void AsyncFreeConstruct(FreeTask *task,
+                          const TaskNode &task_node,
+                          const std::vector<BufferInfo> &buffers,
+                          const std::vector<float> &scores,
+                          bool fire_and_forget) {
+    HRUN_CLIENT->ConstructTask<FreeTask>(
+        task, task_node, domain_id_, id_, buffers, scores, fire_and_forget);
+  }
   HRUN_TASK_NODE_PUSH_ROOT(Free);
 
-  /** Allocate buffers from the bdev */
+  /** Reserve the buffers of recovered blobs */
+  HSHM_ALWAYS_INLINE
+  void AsyncReserveConstruct(ReserveTask *task,
+                             const TaskNode &task_node,
+                             const std::vector<BufferInfo> &buffers,
+                             const std::vector<float> &scores) {
+    HRUN_CLIENT->ConstructTask<ReserveTask>(
+        task, task_node, domain_id_, id_, buffers, scores);
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(Reserve);
+
+  /**
+   * Write data to the bdev.
+   * Pass TASK_BACKGROUND in \a task_flags for I/O that should
+   * yield to foreground reads and writes (e.g., BORG migrations).
+   * */
   HSHM_ALWAYS_INLINE
   void AsyncWriteConstruct(WriteTask *task,
                            const TaskNode &task_node,
-                           const char *data, size_t off, size_t size) {
+                           const char *data, size_t off, size_t size,
+                           u32 task_flags = 0) {
     HRUN_CLIENT->ConstructTask<WriteTask>(
-        task, task_node, domain_id_, id_, data, off, size);
+        task, task_node, domain_id_, id_, data, off, size, task_flags);
   }
   HRUN_TASK_NODE_PUSH_ROOT(Write);
 
-  /** Allocate buffers from the bdev */
+  /** Read data from the bdev */
   HSHM_ALWAYS_INLINE
   void AsyncReadConstruct(ReadTask *task,
                           const TaskNode &task_node,
-                          char *data, size_t off, size_t size) {
+                          char *data, size_t off, size_t size,
+                          u32 task_flags = 0) {
     HRUN_CLIENT->ConstructTask<ReadTask>(
-        task, task_node, domain_id_, id_, data, off, size);
+        task, task_node, domain_id_, id_, data, off, size, task_flags);
   }
   HRUN_TASK_NODE_PUSH_ROOT(Read);
 
+  /**
+   * Write many segments in one task, merging the segments that are
+   * contiguous on the device into vectored writes
+   * */
+  HSHM_ALWAYS_INLINE
+  void AsyncWriteVConstruct(WriteVTask *task,
+                            const TaskNode &task_node,
+                            std::vector<IoSegment> &&segs,
+                            u32 task_flags = 0) {
+    HRUN_CLIENT->ConstructTask<WriteVTask>(
+        task, task_node, domain_id_, id_, std::move(segs), task_flags);
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(WriteV);
+
+  /** Read many segments in one task */
+  HSHM_ALWAYS_INLINE
+  void AsyncReadVConstruct(ReadVTask *task,
+                           const TaskNode &task_node,
+                           std::vector<IoSegment> &&segs,
+                           u32 task_flags = 0) {
+    HRUN_CLIENT->ConstructTask<ReadVTask>(
+        task, task_node, domain_id_, id_, std::move(segs), task_flags);
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(ReadV);
+
   /** Update blob scores */
   HSHM_ALWAYS_INLINE
   void AsyncUpdateScoreConstruct(UpdateScoreTask *task,
@@ -151,12 +223,73 @@ class Client : public TaskLibClient {
   HRUN_TASK_NODE_PUSH_ROOT(UpdateScore);
 };
 
+/** Background I/O waits until foreground I/O is idle this long */
+#define BDEV_BACKGROUND_IDLE_NS 500000
+/** Max time a background I/O waits for foreground I/O */
+#define BDEV_MAX_BACKGROUND_DEFER_NS 50000000
+
 class Server {
  public:
   ssize_t rem_cap_;       /**< Remaining capacity */
   Histogram score_hist_;  /**< Score distribution */
+  hshm::Timepoint io_start_;  /**< Origin of the I/O timestamps */
+  std::atomic<int> fg_inflight_ = 0;  /**< Foreground I/Os in progress */
+  std::atomic<size_t> fg_last_ns_ = 0;  /**< When foreground I/O last ran */
+  std::atomic<size_t> bg_deferred_ = 0;  /**< Background I/Os that waited */
+  std::atomic<size_t> bg_executed_ = 0;  /**< Background I/Os that ran */
 
  public:
+  /** Default constructor */
+  Server() {
+    io_start_.Now();
+  }
+
+  /** Nanoseconds since the bdev started. Never 0. */
+  size_t GetIoTimeNs() {
+    hshm::Timepoint now;
+    now.Now();
+    return (size_t)io_start_.GetNsecFromStart(now) + 1;
+  }
+
+  /**
+   * Begin an I/O. Background I/O waits while foreground I/O is in
+   * progress or ran in the last BDEV_BACKGROUND_IDLE_NS. The window
+   * matters for engines that finish in one call, like ram_bdev and the
+   * sync posix_bdev, whose foreground I/O is never seen in flight. A
+   * background I/O waits at most BDEV_MAX_BACKGROUND_DEFER_NS, so it
+   * cannot starve. Returns false if the task should be polled again.
+   * */
+  template<typename TaskT>
+  bool BeginIo(TaskT *task) {
+    if (!task->IsBackground()) {
+      fg_inflight_ += 1;
+      return true;
+    }
+    size_t now = GetIoTimeNs();
+    size_t fg_last = fg_last_ns_.load();
+    bool busy = fg_inflight_ > 0 ||
+        now < fg_last + BDEV_BACKGROUND_IDLE_NS;
+    if (busy) {
+      if (task->defer_ns_ == 0) {
+        task->defer_ns_ = now;
+        bg_deferred_ += 1;
+      }
+      if (now < task->defer_ns_ + BDEV_MAX_BACKGROUND_DEFER_NS) {
+        return false;
+      }
+    }
+    bg_executed_ += 1;
+    return true;
+  }
+
+  /** End an I/O started by BeginIo */
+  void EndIo(Task *task) {
+    if (!task->IsBackground()) {
+      fg_last_ns_ = GetIoTimeNs();
+      fg_inflight_ -= 1;
+    }
+  }
+
   /** Update the blob score in this tier */
   void UpdateScore(UpdateScoreTask *task, RunContext &ctx) {
     if (task->old_score_ >= 0) {
@@ -171,6 +304,8 @@ class Server {
   void StatBdev(StatBdevTask *task, RunContext &ctx) {
     task->rem_cap_ = rem_cap_;
     task->score_hist_ = score_hist_;
+    task->bg_deferred_ = bg_deferred_;
+    task->bg_executed_ = bg_executed_;
   }
   void MonitorStatBdev(u32 mode, StatBdevTask *task, RunContext &ctx) {
   }
@@ -190,13 +325,15 @@ struct TargetStats {
   double bandwidth_;    /**< the bandwidth of the device */
   double latency_;      /**< the latency of the device */
   float score_;         /**< Relative importance of this tier */
+  size_t bg_deferred_;  /**< Background I/Os that waited for foreground */
+  size_t bg_executed_;  /**< Background I/Os that ran */
 
  public:
   /** Serialize */
   template<typename Ar>
   void serialize(Ar &ar) {
     ar(tgt_id_, node_id_, max_cap_, bandwidth_,
-       latency_, score_, rem_cap_);
+       latency_, score_, rem_cap_, bg_deferred_, bg_executed_);
   }
 };
 }  // namespace hermes
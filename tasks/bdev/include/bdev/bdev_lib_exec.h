@@ -36,6 +36,18 @@ void Run(u32 method, Task *task, RunContext &rctx) override {
       UpdateScore(reinterpret_cast<UpdateScoreTask *>(task), rctx);
       break;
     }
+    case Method::kReserve: {
+      Reserve(reinterpret_cast<ReserveTask *>(task), rctx);
+      break;
+    }
+    case Method::kWriteV: {
+      WriteV(reinterpret_cast<WriteVTask *>(task), rctx);
+      break;
+    }
+    case Method::kReadV: {
+      ReadV(reinterpret_cast<ReadVTask *>(task), rctx);
+      break;
+    }
   }
 }
 /** Execute a task */
@@ -73,6 +85,18 @@ void Monitor(u32 mode, Task *task, RunContext &rctx) override {
       MonitorUpdateScore(mode, reinterpret_cast<UpdateScoreTask *>(task), rctx);
       break;
     }
+    case Method::kReserve: {
+      MonitorReserve(mode, reinterpret_cast<ReserveTask *>(task), rctx);
+      break;
+    }
+    case Method::kWriteV: {
+      MonitorWriteV(mode, reinterpret_cast<WriteVTask *>(task), rctx);
+      break;
+    }
+    case Method::kReadV: {
+      MonitorReadV(mode, reinterpret_cast<ReadVTask *>(task), rctx);
+      break;
+    }
   }
 }
 /** Delete a task */
@@ -110,6 +134,18 @@ void Del(u32 method, Task *task) override {
       HRUN_CLIENT->DelTask<UpdateScoreTask>(reinterpret_cast<UpdateScoreTask *>(task));
       break;
     }
+    case Method::kReserve: {
+      HRUN_CLIENT->DelTask<ReserveTask>(reinterpret_cast<ReserveTask *>(task));
+      break;
+    }
+    case Method::kWriteV: {
+      HRUN_CLIENT->DelTask<WriteVTask>(reinterpret_cast<WriteVTask *>(task));
+      break;
+    }
+    case Method::kReadV: {
+      HRUN_CLIENT->DelTask<ReadVTask>(reinterpret_cast<ReadVTask *>(task));
+      break;
+    }
   }
 }
 /** Duplicate a task */
@@ -147,6 +183,18 @@ void Dup(u32 method, Task *orig_task, std::vector<LPointer<Task>> &dups) overrid
       hrun::CALL_DUPLICATE(reinterpret_cast<UpdateScoreTask*>(orig_task), dups);
       break;
     }
+    case Method::kReserve: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<ReserveTask*>(orig_task), dups);
+      break;
+    }
+    case Method::kWriteV: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<WriteVTask*>(orig_task), dups);
+      break;
+    }
+    case Method::kReadV: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<ReadVTask*>(orig_task), dups);
+      break;
+    }
   }
 }
 /** Register the duplicate output with the origin task */
@@ -184,6 +232,18 @@ void DupEnd(u32 method, u32 replica, Task *orig_task, Task *dup_task) override {
       hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<UpdateScoreTask*>(orig_task), reinterpret_cast<UpdateScoreTask*>(dup_task));
       break;
     }
+    case Method::kReserve: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<ReserveTask*>(orig_task), reinterpret_cast<ReserveTask*>(dup_task));
+      break;
+    }
+    case Method::kWriteV: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<WriteVTask*>(orig_task), reinterpret_cast<WriteVTask*>(dup_task));
+      break;
+    }
+    case Method::kReadV: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<ReadVTask*>(orig_task), reinterpret_cast<ReadVTask*>(dup_task));
+      break;
+    }
   }
 }
 /** Ensure there is space to store replicated outputs */
@@ -221,6 +281,18 @@ void ReplicateStart(u32 method, u32 count, Task *task) override {
       hrun::CALL_REPLICA_START(count, reinterpret_cast<UpdateScoreTask*>(task));
       break;
     }
+    case Method::kReserve: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<ReserveTask*>(task));
+      break;
+    }
+    case Method::kWriteV: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<WriteVTask*>(task));
+      break;
+    }
+    case Method::kReadV: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<ReadVTask*>(task));
+      break;
+    }
   }
 }
 /** Determine success and handle failures */
@@ -258,6 +330,18 @@ void ReplicateEnd(u32 method, Task *task) override {
       hrun::CALL_REPLICA_END(reinterpret_cast<UpdateScoreTask*>(task));
       break;
     }
+    case Method::kReserve: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<ReserveTask*>(task));
+      break;
+    }
+    case Method::kWriteV: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<WriteVTask*>(task));
+      break;
+    }
+    case Method::kReadV: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<ReadVTask*>(task));
+      break;
+    }
   }
 }
 /** Serialize a task when initially pushing into remote */
@@ -295,6 +379,18 @@ std::vector<DataTransfer> SaveStart(u32 method, BinaryOutputArchive<true> &ar, T
       ar << *reinterpret_cast<UpdateScoreTask*>(task);
       break;
     }
+    case Method::kReserve: {
+      ar << *reinterpret_cast<ReserveTask*>(task);
+      break;
+    }
+    case Method::kWriteV: {
+      ar << *reinterpret_cast<WriteVTask*>(task);
+      break;
+    }
+    case Method::kReadV: {
+      ar << *reinterpret_cast<ReadVTask*>(task);
+      break;
+    }
   }
   return ar.Get();
 }
@@ -342,6 +438,21 @@ TaskPointer LoadStart(u32 method, BinaryInputArchive<true> &ar) override {
       ar >> *reinterpret_cast<UpdateScoreTask*>(task_ptr.ptr_);
       break;
     }
+    case Method::kReserve: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<ReserveTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<ReserveTask*>(task_ptr.ptr_);
+      break;
+    }
+    case Method::kWriteV: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<WriteVTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<WriteVTask*>(task_ptr.ptr_);
+      break;
+    }
+    case Method::kReadV: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<ReadVTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<ReadVTask*>(task_ptr.ptr_);
+      break;
+    }
   }
   return task_ptr;
 }
@@ -380,6 +491,18 @@ std::vector<DataTransfer> SaveEnd(u32 method, BinaryOutputArchive<false> &ar, Ta
       ar << *reinterpret_cast<UpdateScoreTask*>(task);
       break;
     }
+    case Method::kReserve: {
+      ar << *reinterpret_cast<ReserveTask*>(task);
+      break;
+    }
+    case Method::kWriteV: {
+      ar << *reinterpret_cast<WriteVTask*>(task);
+      break;
+    }
+    case Method::kReadV: {
+      ar << *reinterpret_cast<ReadVTask*>(task);
+      break;
+    }
   }
   return ar.Get();
 }
@@ -418,6 +541,18 @@ void LoadEnd(u32 replica, u32 method, BinaryInputArchive<false> &ar, Task *task)
       ar.Deserialize(replica, *reinterpret_cast<UpdateScoreTask*>(task));
       break;
     }
+    case Method::kReserve: {
+      ar.Deserialize(replica, *reinterpret_cast<ReserveTask*>(task));
+      break;
+    }
+    case Method::kWriteV: {
+      ar.Deserialize(replica, *reinterpret_cast<WriteVTask*>(task));
+      break;
+    }
+    case Method::kReadV: {
+      ar.Deserialize(replica, *reinterpret_cast<ReadVTask*>(task));
+      break;
+    }
   }
 }
 /** Get the grouping of the task */
@@ -447,6 +582,15 @@ u32 GetGroup(u32 method, Task *task, hshm::charbuf &group) override {
     case Method::kUpdateScore: {
       return reinterpret_cast<UpdateScoreTask*>(task)->GetGroup(group);
     }
+    case Method::kReserve: {
+      return reinterpret_cast<ReserveTask*>(task)->GetGroup(group);
+    }
+    case Method::kWriteV: {
+      return reinterpret_cast<WriteVTask*>(task)->GetGroup(group);
+    }
+    case Method::kReadV: {
+      return reinterpret_cast<ReadVTask*>(task)->GetGroup(group);
+    }
   }
   return -1;
 }
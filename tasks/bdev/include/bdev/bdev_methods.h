@@ -9,6 +9,9 @@ struct Method : public TaskMethod {
   TASK_METHOD_T kFree = kLast + 3;
   TASK_METHOD_T kStatBdev = kLast + 4;
   TASK_METHOD_T kUpdateScore = kLast + 5;
+  TASK_METHOD_T kReserve = kLast + 6;
+  TASK_METHOD_T kWriteV = kLast + 7;
+  TASK_METHOD_T kReadV = kLast + 8;
 };
 
 #endif  // HRUN_BDEV_METHODS_H_
\ No newline at end of file
@@ -15,11 +15,19 @@ using ::hermes::bdev::ConstructTask;
 using ::hermes::bdev::DestructTask;
 using ::hermes::bdev::AllocateTask;
 using ::hermes::bdev::FreeTask;
+using ::hermes::bdev::ReserveTask;
 using ::hermes::bdev::ReadTask;
 using ::hermes::bdev::WriteTask;
+using ::hermes::bdev::ReadVTask;
+using ::hermes::bdev::WriteVTask;
 using ::hermes::bdev::StatBdevTask;
 using ::hermes::bdev::UpdateScoreTask;
 
+/** The state of bdev I/O */
+using ::hermes::bdev::AsyncIo;
+using ::hermes::bdev::IoSegment;
+using ::hermes::bdev::IoRun;
+
 /** Create admin requests */
 using ::hermes::bdev::Client;
 
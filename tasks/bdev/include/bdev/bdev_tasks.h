@@ -5,7 +5,6 @@
 #ifndef HRUN_TASKS_BDEV_INCLUDE_BDEV_BDEV_TASKS_H_
 #define HRUN_TASKS_BDEV_INCLUDE_BDEV_BDEV_TASKS_H_
 
-// #include <libaio.h>
 #include "hrun/api/hrun_client.h"
 #include "hrun/task_registry/task_lib.h"
 #include "hrun_admin/hrun_admin.h"
@@ -14,6 +13,8 @@
 #include "hermes/config_server.h"
 #include "proc_queue/proc_queue.h"
 #include "hermes/score_histogram.h"
+#include "bdev/async_io.h"
+#include "bdev/io_segment.h"
 
 namespace hermes::bdev {
 
@@ -120,6 +121,7 @@ struct AllocateTask : public Task, TaskFlags<TF_LOCAL> {
 struct FreeTask : public Task, TaskFlags<TF_LOCAL> {
   IN std::vector<BufferInfo> buffers_;
   IN float score_;
+  IN std::vector<float> scores_;  /**< Blob score of each buffer, if batched */
 
   /** SHM default constructor */
   HSHM_ALWAYS_INLINE explicit
@@ -151,6 +153,61 @@ struct FreeTask : public Task, TaskFlags<TF_LOCAL> {
     score_ = score;
   }
 
+  /** Emplace constructor for freeing the buffers of many blobs at once */
+  HSHM_ALWAYS_INLINE explicit
+  FreeTask(hipc::Allocator *alloc,
+           const TaskNode &task_node,
+           const DomainId &domain_id,
+           const TaskStateId &state_id,
+           const std::vector<BufferInfo> &buffers,
+           const std::vector<float> &scores,
+           bool fire_and_forget)
+      : FreeTask(alloc, task_node, domain_id, state_id,
+                 0, buffers, fire_and_forget) {
+    scores_ = scores;
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    return TASK_UNORDERED;
+  }
+};
+
+/**
+ * Mark the buffers of recovered blobs as allocated, rebuilding the
+ * free lists around them. Must run before any Allocate.
+ * */
+struct ReserveTask : public Task, TaskFlags<TF_LOCAL> {
+  IN std::vector<BufferInfo> buffers_;
+  IN std::vector<float> scores_;  /**< Score of each buffer's blob */
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  ReserveTask(hipc::Allocator *alloc) : Task(alloc) {}
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  ReserveTask(hipc::Allocator *alloc,
+              const TaskNode &task_node,
+              const DomainId &domain_id,
+              const TaskStateId &state_id,
+              const std::vector<BufferInfo> &buffers,
+              const std::vector<float> &scores) : Task(alloc) {
+    // Initialize task
+    task_node_ = task_node;
+    lane_hash_ = 0;
+    prio_ = TaskPrio::kLowLatency;
+    task_state_ = state_id;
+    method_ = Method::kReserve;
+    task_flags_.SetBits(0);
+    domain_id_ = domain_id;
+
+    // Reserve params
+    buffers_ = buffers;
+    scores_ = scores;
+  }
+
   /** Create group */
   HSHM_ALWAYS_INLINE
   u32 GetGroup(hshm::charbuf &group) {
@@ -166,7 +223,8 @@ struct WriteTask : public Task, TaskFlags<TF_LOCAL> {
   IN size_t disk_off_;    /**< Offset on disk */
   IN size_t size_;        /**< Size in buf */
   TEMP int phase_ = 0;
-  // TEMP io_context_t ctx_ = 0;
+  TEMP size_t defer_ns_ = 0;  /**< When first deferred, 0 if never */
+  TEMP IoRun run_;            /**< The transfer, once begun */
 
   /** SHM default constructor */
   HSHM_ALWAYS_INLINE explicit
@@ -180,19 +238,20 @@ struct WriteTask : public Task, TaskFlags<TF_LOCAL> {
             const TaskStateId &state_id,
             const char *buf,
             size_t disk_off,
-            size_t size) : Task(alloc) {
+            size_t size,
+            u32 task_flags) : Task(alloc) {
     // Initialize task
     static int counter = 0;
     task_node_ = task_node;
     lane_hash_ = ++counter;
-    if (size < KILOBYTES(8)) {
+    if (size < KILOBYTES(8) && !(task_flags & TASK_BACKGROUND)) {
       prio_ = TaskPrio::kLowLatency;
     } else {
       prio_ = TaskPrio::kHighLatency;
     }
     task_state_ = state_id;
     method_ = Method::kWrite;
-    task_flags_.SetBits(TASK_UNORDERED | TASK_REMOTE_DEBUG_MARK);
+    task_flags_.SetBits(task_flags | TASK_UNORDERED | TASK_REMOTE_DEBUG_MARK);
     domain_id_ = domain_id;
     counter += 1;
 
@@ -217,7 +276,8 @@ struct ReadTask : public Task, TaskFlags<TF_LOCAL> {
   IN size_t disk_off_;   /**< Offset on disk */
   IN size_t size_;       /**< Size in disk buf */
   TEMP int phase_ = 0;
-  // TEMP io_context_t ctx_ = 0;
+  TEMP size_t defer_ns_ = 0;  /**< When first deferred, 0 if never */
+  TEMP IoRun run_;            /**< The transfer, once begun */
 
   /** SHM default constructor */
   HSHM_ALWAYS_INLINE explicit
@@ -231,20 +291,21 @@ struct ReadTask : public Task, TaskFlags<TF_LOCAL> {
            const TaskStateId &state_id,
            char *buf,
            size_t disk_off,
-           size_t size) : Task(alloc) {
+           size_t size,
+           u32 task_flags) : Task(alloc) {
     static int counter = 0;
     // Initialize task
     task_node_ = task_node;
     lane_hash_ = counter;
     ++counter;
-    if (size < KILOBYTES(8)) {
+    if (size < KILOBYTES(8) && !(task_flags & TASK_BACKGROUND)) {
       prio_ = TaskPrio::kLowLatency;
     } else {
       prio_ = TaskPrio::kHighLatency;
     }
     task_state_ = state_id;
     method_ = Method::kRead;
-    task_flags_.SetBits(TASK_UNORDERED | TASK_REMOTE_DEBUG_MARK);
+    task_flags_.SetBits(task_flags | TASK_UNORDERED | TASK_REMOTE_DEBUG_MARK);
     domain_id_ = domain_id;
 
     // Free params
@@ -260,10 +321,114 @@ struct ReadTask : public Task, TaskFlags<TF_LOCAL> {
   }
 };
 
+/**
+ * Write many segments in one task. Segments that are contiguous on the
+ * device are merged into one vectored write.
+ * */
+struct WriteVTask : public Task, TaskFlags<TF_LOCAL> {
+  IN std::vector<IoSegment> segs_;  /**< The data and where it goes */
+  TEMP int phase_ = 0;
+  TEMP size_t defer_ns_ = 0;      /**< When first deferred, 0 if never */
+  TEMP std::vector<IoRun> runs_;  /**< The coalesced segments */
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  WriteVTask(hipc::Allocator *alloc) : Task(alloc) {}
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  WriteVTask(hipc::Allocator *alloc,
+             const TaskNode &task_node,
+             const DomainId &domain_id,
+             const TaskStateId &state_id,
+             std::vector<IoSegment> &&segs,
+             u32 task_flags) : Task(alloc) {
+    // Initialize task
+    static int counter = 0;
+    task_node_ = task_node;
+    lane_hash_ = ++counter;
+    size_t size = 0;
+    for (const IoSegment &seg : segs) {
+      size += seg.size_;
+    }
+    if (size < KILOBYTES(8) && !(task_flags & TASK_BACKGROUND)) {
+      prio_ = TaskPrio::kLowLatency;
+    } else {
+      prio_ = TaskPrio::kHighLatency;
+    }
+    task_state_ = state_id;
+    method_ = Method::kWriteV;
+    task_flags_.SetBits(task_flags | TASK_UNORDERED | TASK_REMOTE_DEBUG_MARK);
+    domain_id_ = domain_id;
+
+    // Write params
+    segs_ = std::move(segs);
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    return TASK_UNORDERED;
+  }
+};
+
+/**
+ * Read many segments in one task. Segments that are contiguous on the
+ * device are merged into one vectored read.
+ * */
+struct ReadVTask : public Task, TaskFlags<TF_LOCAL> {
+  IN std::vector<IoSegment> segs_;  /**< Where the data goes in memory */
+  TEMP int phase_ = 0;
+  TEMP size_t defer_ns_ = 0;      /**< When first deferred, 0 if never */
+  TEMP std::vector<IoRun> runs_;  /**< The coalesced segments */
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  ReadVTask(hipc::Allocator *alloc) : Task(alloc) {}
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  ReadVTask(hipc::Allocator *alloc,
+            const TaskNode &task_node,
+            const DomainId &domain_id,
+            const TaskStateId &state_id,
+            std::vector<IoSegment> &&segs,
+            u32 task_flags) : Task(alloc) {
+    // Initialize task
+    static int counter = 0;
+    task_node_ = task_node;
+    lane_hash_ = ++counter;
+    size_t size = 0;
+    for (const IoSegment &seg : segs) {
+      size += seg.size_;
+    }
+    if (size < KILOBYTES(8) && !(task_flags & TASK_BACKGROUND)) {
+      prio_ = TaskPrio::kLowLatency;
+    } else {
+      prio_ = TaskPrio::kHighLatency;
+    }
+    task_state_ = state_id;
+    method_ = Method::kReadV;
+    task_flags_.SetBits(task_flags | TASK_UNORDERED | TASK_REMOTE_DEBUG_MARK);
+    domain_id_ = domain_id;
+
+    // Read params
+    segs_ = std::move(segs);
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    return TASK_UNORDERED;
+  }
+};
+
 /** A task to monitor bdev statistics */
 struct StatBdevTask : public Task, TaskFlags<TF_LOCAL> {
   OUT size_t rem_cap_;  /**< Remaining capacity of the target */
   OUT Histogram score_hist_;  /**< Score distribution */
+  OUT size_t bg_deferred_;  /**< Background I/Os that waited */
+  OUT size_t bg_executed_;  /**< Background I/Os that ran */
 
   /** SHM default constructor */
   HSHM_ALWAYS_INLINE explicit
@@ -290,6 +455,8 @@ struct StatBdevTask : public Task, TaskFlags<TF_LOCAL> {
     // Custom
     rem_cap_ = rem_cap;
     score_hist_.Resize(10);
+    bg_deferred_ = 0;
+    bg_executed_ = 0;
   }
 
   /** Create group */
@@ -0,0 +1,134 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HRUN_TASKS_BDEV_INCLUDE_BDEV_IO_SEGMENT_H_
+#define HRUN_TASKS_BDEV_INCLUDE_BDEV_IO_SEGMENT_H_
+
+#include <sys/uio.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "bdev/async_io.h"
+
+namespace hermes::bdev {
+
+/** \a size_ bytes of memory at \a buf_, placed at \a off_ on the device */
+struct IoSegment {
+  char *buf_;    /**< Data in memory */
+  size_t off_;   /**< Offset on the device */
+  size_t size_;  /**< Size of the segment */
+
+  /** Default constructor */
+  IoSegment() = default;
+
+  /** Emplace constructor */
+  IoSegment(char *buf, size_t off, size_t size)
+      : buf_(buf), off_(off), size_(size) {}
+};
+
+/**
+ * Segments that are contiguous on the device, transferred by one
+ * vectored request (pwritev / preadv, or one vectored SQE or iocb).
+ * */
+struct IoRun {
+  size_t off_ = 0;                 /**< Offset on the device */
+  size_t size_ = 0;                /**< Bytes in the run */
+  std::vector<struct iovec> iov_;  /**< The memory of the run, in order */
+  AsyncIo io_;                     /**< Progress in an asynchronous engine */
+  char *bounce_ = nullptr;         /**< Aligned copy for direct I/O */
+  int phase_ = 0;                  /**< Progress of the run */
+  /** Default constructor */
+  IoRun() = default;
+
+  /** A run of the \a size bytes of \a buf, placed at \a off */
+  IoRun(char *buf, size_t off, size_t size) : off_(off), size_(size) {
+    struct iovec iov;
+    iov.iov_base = buf;
+    iov.iov_len = size;
+    iov_.emplace_back(iov);
+  }
+};
+
+/**
+ * Sort \a segs by device offset and merge the segments that are
+ * contiguous both in memory and on the device. Segments that are only
+ * contiguous on the device are grouped into runs of at most \a max_iov.
+ * */
+static inline void CoalesceSegments(std::vector<IoSegment> &segs,
+                                    size_t max_iov,
+                                    std::vector<IoRun> &runs) {
+  std::sort(segs.begin(), segs.end(),
+            [](const IoSegment &a, const IoSegment &b) {
+              return a.off_ < b.off_;
+            });
+  size_t count = 0;
+  for (IoSegment &seg : segs) {
+    if (seg.size_ == 0) {
+      continue;
+    }
+    if (count > 0) {
+      IoSegment &last = segs[count - 1];
+      if (last.off_ + last.size_ == seg.off_ &&
+          last.buf_ + last.size_ == seg.buf_) {
+        last.size_ += seg.size_;
+        continue;
+      }
+    }
+    segs[count++] = seg;
+  }
+  segs.resize(count);
+  for (IoSegment &seg : segs) {
+    if (runs.empty() || runs.back().off_ + runs.back().size_ != seg.off_ ||
+        runs.back().iov_.size() >= max_iov) {
+      runs.emplace_back();
+      runs.back().off_ = seg.off_;
+    }
+    IoRun &run = runs.back();
+    struct iovec iov;
+    iov.iov_base = seg.buf_;
+    iov.iov_len = seg.size_;
+    run.iov_.emplace_back(iov);
+    run.size_ += seg.size_;
+  }
+}
+
+/** Drop the first \a count bytes of \a iov, after a short transfer */
+static inline void AdvanceIov(std::vector<struct iovec> &iov, size_t count) {
+  size_t skip = 0;
+  while (skip < iov.size() && count >= iov[skip].iov_len) {
+    count -= iov[skip].iov_len;
+    ++skip;
+  }
+  iov.erase(iov.begin(), iov.begin() + skip);
+  if (!iov.empty()) {
+    iov[0].iov_base = reinterpret_cast<char*>(iov[0].iov_base) + count;
+    iov[0].iov_len -= count;
+  }
+}
+
+/**
+ * Advance the \a iov of a \a size-byte transfer past the bytes \a io has
+ * transferred, so a short transfer can be requeued.
+ * */
+static inline void SkipTransferred(const AsyncIo &io,
+                                   std::vector<struct iovec> &iov,
+                                   size_t size) {
+  size_t left = 0;
+  for (const struct iovec &vec : iov) {
+    left += vec.iov_len;
+  }
+  AdvanceIov(iov, io.done_ - (size - left));
+}
+
+}  // namespace hermes::bdev
+
+#endif  // HRUN_TASKS_BDEV_INCLUDE_BDEV_IO_SEGMENT_H_
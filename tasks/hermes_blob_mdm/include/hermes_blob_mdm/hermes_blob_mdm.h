@@ -165,6 +165,63 @@ class Client : public TaskLibClient {
   }
   HRUN_TASK_NODE_PUSH_ROOT(GetBlob);
 
+  /**
+   * Put a batch of blobs stored contiguously in \a data. All entries
+   * must hash to the node in \a domain_id and to \a lane_hash.
+   * */
+  void AsyncMultiPutBlobConstruct(
+      MultiPutBlobTask *task,
+      const TaskNode &task_node,
+      const DomainId &domain_id,
+      u32 lane_hash,
+      TagId tag_id,
+      const std::vector<BlobIoEntry> &entries,
+      size_t data_size,
+      const hipc::Pointer &data, float score,
+      u32 flags,
+      Context ctx = Context(),
+      u32 task_flags = TASK_FIRE_AND_FORGET | TASK_DATA_OWNER | TASK_LOW_LATENCY) {
+    HRUN_CLIENT->ConstructTask<MultiPutBlobTask>(
+        task, task_node, domain_id, id_, lane_hash,
+        tag_id, entries, data_size, data, score, flags, ctx, task_flags);
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(MultiPutBlob);
+
+  /**
+   * Get a batch of blobs into the contiguous buffer \a data. All entries
+   * must hash to the node in \a domain_id and to \a lane_hash.
+   * */
+  void AsyncMultiGetBlobConstruct(MultiGetBlobTask *task,
+                                  const TaskNode &task_node,
+                                  const DomainId &domain_id,
+                                  u32 lane_hash,
+                                  const TagId &tag_id,
+                                  const std::vector<BlobIoEntry> &entries,
+                                  size_t data_size,
+                                  const hipc::Pointer &data,
+                                  Context ctx = Context(),
+                                  u32 flags = 0) {
+    HRUN_CLIENT->ConstructTask<MultiGetBlobTask>(
+        task, task_node, domain_id, id_, lane_hash,
+        tag_id, entries, data_size, data, ctx, flags);
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(MultiGetBlob);
+
+  /**
+   * Get the sizes of a batch of blobs. All entries must hash to the
+   * node in \a domain_id and to \a lane_hash.
+   * */
+  void AsyncMultiGetBlobSizeConstruct(MultiGetBlobSizeTask *task,
+                                      const TaskNode &task_node,
+                                      const DomainId &domain_id,
+                                      u32 lane_hash,
+                                      const TagId &tag_id,
+                                      const std::vector<BlobIoEntry> &entries) {
+    HRUN_CLIENT->ConstructTask<MultiGetBlobSizeTask>(
+        task, task_node, domain_id, id_, lane_hash, tag_id, entries);
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(MultiGetBlobSize);
+
   /**
    * Reorganize a blob
    *
@@ -238,6 +295,56 @@ class Client : public TaskLibClient {
   }
   HRUN_TASK_NODE_PUSH_ROOT(BlobHasTag);
 
+  /**
+   * Find the blobs labeled with \a tag. If \a tag_id is not null,
+   * only the blobs in that bucket are returned.
+   * */
+  void AsyncGetBlobsWithTagConstruct(GetBlobsWithTagTask *task,
+                                     const TaskNode &task_node,
+                                     const TagId &tag_id,
+                                     const TagId &tag) {
+    HRUN_CLIENT->ConstructTask<GetBlobsWithTagTask>(
+        task, task_node, id_, tag_id, tag);
+  }
+  std::vector<BlobId> GetBlobsWithTagRoot(const TagId &tag_id,
+                                          const TagId &tag) {
+    LPointer<hrunpq::TypedPushTask<GetBlobsWithTagTask>> push_task =
+        AsyncGetBlobsWithTagRoot(tag_id, tag);
+    push_task->Wait();
+    GetBlobsWithTagTask *task = push_task->get();
+    std::vector<BlobId> blob_ids = task->DeserializeBlobIds();
+    HRUN_CLIENT->DelTask(push_task);
+    return blob_ids;
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(GetBlobsWithTag);
+
+  /**
+   * List up to \a limit blobs of \a tag_id whose names start with
+   * \a prefix and sort after \a start_after, in name order
+   * */
+  void AsyncListBlobsConstruct(ListBlobsTask *task,
+                               const TaskNode &task_node,
+                               const TagId &tag_id,
+                               const std::string &prefix,
+                               const std::string &start_after,
+                               size_t limit) {
+    HRUN_CLIENT->ConstructTask<ListBlobsTask>(
+        task, task_node, id_, tag_id, prefix, start_after, limit);
+  }
+  std::vector<BlobNameEntry> ListBlobsRoot(const TagId &tag_id,
+                                           const std::string &prefix,
+                                           const std::string &start_after,
+                                           size_t limit) {
+    LPointer<hrunpq::TypedPushTask<ListBlobsTask>> push_task =
+        AsyncListBlobsRoot(tag_id, prefix, start_after, limit);
+    push_task->Wait();
+    ListBlobsTask *task = push_task->get();
+    std::vector<BlobNameEntry> entries = task->DeserializeEntries();
+    HRUN_CLIENT->DelTask(push_task);
+    return entries;
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(ListBlobs);
+
   /**
    * Get \a blob_name BLOB from \a bkt_id bucket
    * */
@@ -424,6 +531,41 @@ class Client : public TaskLibClient {
   }
   HRUN_TASK_NODE_PUSH_ROOT(DestroyBlob);
 
+  /**
+   * Destroy the \a blob_ids blobs of \a tag_id. The blobs must be in
+   * the same lane of the same node, as grouped by the bucket mdm.
+   * */
+  void AsyncDestroyBlobsConstruct(DestroyBlobsTask *task,
+                                  const TaskNode &task_node,
+                                  const TagId &tag_id,
+                                  const std::vector<BlobId> &blob_ids,
+                                  bool update_size = true) {
+    HRUN_CLIENT->ConstructTask<DestroyBlobsTask>(
+        task, task_node, DomainId::GetNode(blob_ids[0].node_id_),
+        id_, tag_id, blob_ids, update_size);
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(DestroyBlobs);
+
+  /**
+   * Send the bucket size changes held by the lanes of \a domain_id to the
+   * bucket mdm and wait for them to apply. Only those of \a tag_id are
+   * sent, unless it is null.
+   * */
+  void AsyncFlushSizeDeltasConstruct(FlushSizeDeltasTask *task,
+                                     const TaskNode &task_node,
+                                     const DomainId &domain_id,
+                                     const TagId &tag_id) {
+    HRUN_CLIENT->ConstructTask<FlushSizeDeltasTask>(
+        task, task_node, domain_id, id_, tag_id);
+  }
+  void FlushSizeDeltasRoot(const TagId &tag_id) {
+    LPointer<hrunpq::TypedPushTask<FlushSizeDeltasTask>> push_task =
+        AsyncFlushSizeDeltasRoot(DomainId::GetGlobal(), tag_id);
+    push_task->Wait();
+    HRUN_CLIENT->DelTask(push_task);
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(FlushSizeDeltas);
+
   /** Initialize automatic flushing */
   void AsyncFlushDataConstruct(FlushDataTask *task,
                                const TaskNode &task_node,
@@ -453,6 +595,31 @@ class Client : public TaskLibClient {
   }
   HRUN_TASK_NODE_PUSH_ROOT(PollBlobMetadata);
 
+  /**
+   * Get a page of blob summaries matching \a query, starting at \a cursor.
+   * The cursor is advanced past the page; poll until cursor.done_.
+   * Pages can be short, or empty, when few blobs match.
+   * */
+  void AsyncPollBlobMetadataPageConstruct(PollBlobMetadataPageTask *task,
+                                          const TaskNode &task_node,
+                                          const BlobQuery &query,
+                                          const MetadataCursor &cursor) {
+    HRUN_CLIENT->ConstructTask<PollBlobMetadataPageTask>(
+        task, task_node, id_, query, cursor);
+  }
+  std::vector<BlobStat> PollBlobMetadataPageRoot(const BlobQuery &query,
+                                                 MetadataCursor &cursor) {
+    LPointer<hrunpq::TypedPushTask<PollBlobMetadataPageTask>> push_task =
+        AsyncPollBlobMetadataPageRoot(query, cursor);
+    push_task->Wait();
+    PollBlobMetadataPageTask *task = push_task->get();
+    std::vector<BlobStat> page = task->DeserializePage();
+    cursor = task->cursor_;
+    HRUN_CLIENT->DelTask(push_task);
+    return page;
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(PollBlobMetadataPage);
+
   /**
   * Get all target metadata
   * */
@@ -472,6 +639,25 @@ class Client : public TaskLibClient {
     return target_mdms;
   }
   HRUN_TASK_NODE_PUSH_ROOT(PollTargetMetadata);
+
+  /**
+  * Get the flush pipeline statistics of each node
+  * */
+  void AsyncPollFlushStatsConstruct(PollFlushStatsTask *task,
+                                    const TaskNode &task_node) {
+    HRUN_CLIENT->ConstructTask<PollFlushStatsTask>(
+        task, task_node, id_);
+  }
+  std::vector<FlushStats> PollFlushStatsRoot() {
+    LPointer<hrunpq::TypedPushTask<PollFlushStatsTask>> push_task =
+        AsyncPollFlushStatsRoot();
+    push_task->Wait();
+    PollFlushStatsTask *task = push_task->get();
+    std::vector<FlushStats> flush_stats = task->DeserializeFlushStats();
+    HRUN_CLIENT->DelTask(push_task);
+    return flush_stats;
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(PollFlushStats);
 };
 
 }  // namespace hrun
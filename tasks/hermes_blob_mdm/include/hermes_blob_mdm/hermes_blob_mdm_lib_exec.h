@@ -84,6 +84,42 @@ void Run(u32 method, Task *task, RunContext &rctx) override {
       PollTargetMetadata(reinterpret_cast<PollTargetMetadataTask *>(task), rctx);
       break;
     }
+    case Method::kMultiPutBlob: {
+      MultiPutBlob(reinterpret_cast<MultiPutBlobTask *>(task), rctx);
+      break;
+    }
+    case Method::kMultiGetBlob: {
+      MultiGetBlob(reinterpret_cast<MultiGetBlobTask *>(task), rctx);
+      break;
+    }
+    case Method::kPollFlushStats: {
+      PollFlushStats(reinterpret_cast<PollFlushStatsTask *>(task), rctx);
+      break;
+    }
+    case Method::kPollBlobMetadataPage: {
+      PollBlobMetadataPage(reinterpret_cast<PollBlobMetadataPageTask *>(task), rctx);
+      break;
+    }
+    case Method::kGetBlobsWithTag: {
+      GetBlobsWithTag(reinterpret_cast<GetBlobsWithTagTask *>(task), rctx);
+      break;
+    }
+    case Method::kListBlobs: {
+      ListBlobs(reinterpret_cast<ListBlobsTask *>(task), rctx);
+      break;
+    }
+    case Method::kDestroyBlobs: {
+      DestroyBlobs(reinterpret_cast<DestroyBlobsTask *>(task), rctx);
+      break;
+    }
+    case Method::kFlushSizeDeltas: {
+      FlushSizeDeltas(reinterpret_cast<FlushSizeDeltasTask *>(task), rctx);
+      break;
+    }
+    case Method::kMultiGetBlobSize: {
+      MultiGetBlobSize(reinterpret_cast<MultiGetBlobSizeTask *>(task), rctx);
+      break;
+    }
   }
 }
 /** Execute a task */
@@ -169,6 +205,42 @@ void Monitor(u32 mode, Task *task, RunContext &rctx) override {
       MonitorPollTargetMetadata(mode, reinterpret_cast<PollTargetMetadataTask *>(task), rctx);
       break;
     }
+    case Method::kMultiPutBlob: {
+      MonitorMultiPutBlob(mode, reinterpret_cast<MultiPutBlobTask *>(task), rctx);
+      break;
+    }
+    case Method::kMultiGetBlob: {
+      MonitorMultiGetBlob(mode, reinterpret_cast<MultiGetBlobTask *>(task), rctx);
+      break;
+    }
+    case Method::kPollFlushStats: {
+      MonitorPollFlushStats(mode, reinterpret_cast<PollFlushStatsTask *>(task), rctx);
+      break;
+    }
+    case Method::kPollBlobMetadataPage: {
+      MonitorPollBlobMetadataPage(mode, reinterpret_cast<PollBlobMetadataPageTask *>(task), rctx);
+      break;
+    }
+    case Method::kGetBlobsWithTag: {
+      MonitorGetBlobsWithTag(mode, reinterpret_cast<GetBlobsWithTagTask *>(task), rctx);
+      break;
+    }
+    case Method::kListBlobs: {
+      MonitorListBlobs(mode, reinterpret_cast<ListBlobsTask *>(task), rctx);
+      break;
+    }
+    case Method::kDestroyBlobs: {
+      MonitorDestroyBlobs(mode, reinterpret_cast<DestroyBlobsTask *>(task), rctx);
+      break;
+    }
+    case Method::kFlushSizeDeltas: {
+      MonitorFlushSizeDeltas(mode, reinterpret_cast<FlushSizeDeltasTask *>(task), rctx);
+      break;
+    }
+    case Method::kMultiGetBlobSize: {
+      MonitorMultiGetBlobSize(mode, reinterpret_cast<MultiGetBlobSizeTask *>(task), rctx);
+      break;
+    }
   }
 }
 /** Delete a task */
@@ -254,6 +326,42 @@ void Del(u32 method, Task *task) override {
       HRUN_CLIENT->DelTask<PollTargetMetadataTask>(reinterpret_cast<PollTargetMetadataTask *>(task));
       break;
     }
+    case Method::kMultiPutBlob: {
+      HRUN_CLIENT->DelTask<MultiPutBlobTask>(reinterpret_cast<MultiPutBlobTask *>(task));
+      break;
+    }
+    case Method::kMultiGetBlob: {
+      HRUN_CLIENT->DelTask<MultiGetBlobTask>(reinterpret_cast<MultiGetBlobTask *>(task));
+      break;
+    }
+    case Method::kPollFlushStats: {
+      HRUN_CLIENT->DelTask<PollFlushStatsTask>(reinterpret_cast<PollFlushStatsTask *>(task));
+      break;
+    }
+    case Method::kPollBlobMetadataPage: {
+      HRUN_CLIENT->DelTask<PollBlobMetadataPageTask>(reinterpret_cast<PollBlobMetadataPageTask *>(task));
+      break;
+    }
+    case Method::kGetBlobsWithTag: {
+      HRUN_CLIENT->DelTask<GetBlobsWithTagTask>(reinterpret_cast<GetBlobsWithTagTask *>(task));
+      break;
+    }
+    case Method::kListBlobs: {
+      HRUN_CLIENT->DelTask<ListBlobsTask>(reinterpret_cast<ListBlobsTask *>(task));
+      break;
+    }
+    case Method::kDestroyBlobs: {
+      HRUN_CLIENT->DelTask<DestroyBlobsTask>(reinterpret_cast<DestroyBlobsTask *>(task));
+      break;
+    }
+    case Method::kFlushSizeDeltas: {
+      HRUN_CLIENT->DelTask<FlushSizeDeltasTask>(reinterpret_cast<FlushSizeDeltasTask *>(task));
+      break;
+    }
+    case Method::kMultiGetBlobSize: {
+      HRUN_CLIENT->DelTask<MultiGetBlobSizeTask>(reinterpret_cast<MultiGetBlobSizeTask *>(task));
+      break;
+    }
   }
 }
 /** Duplicate a task */
@@ -339,6 +447,42 @@ void Dup(u32 method, Task *orig_task, std::vector<LPointer<Task>> &dups) overrid
       hrun::CALL_DUPLICATE(reinterpret_cast<PollTargetMetadataTask*>(orig_task), dups);
       break;
     }
+    case Method::kMultiPutBlob: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<MultiPutBlobTask*>(orig_task), dups);
+      break;
+    }
+    case Method::kMultiGetBlob: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<MultiGetBlobTask*>(orig_task), dups);
+      break;
+    }
+    case Method::kPollFlushStats: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<PollFlushStatsTask*>(orig_task), dups);
+      break;
+    }
+    case Method::kPollBlobMetadataPage: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<PollBlobMetadataPageTask*>(orig_task), dups);
+      break;
+    }
+    case Method::kGetBlobsWithTag: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<GetBlobsWithTagTask*>(orig_task), dups);
+      break;
+    }
+    case Method::kListBlobs: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<ListBlobsTask*>(orig_task), dups);
+      break;
+    }
+    case Method::kDestroyBlobs: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<DestroyBlobsTask*>(orig_task), dups);
+      break;
+    }
+    case Method::kFlushSizeDeltas: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<FlushSizeDeltasTask*>(orig_task), dups);
+      break;
+    }
+    case Method::kMultiGetBlobSize: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<MultiGetBlobSizeTask*>(orig_task), dups);
+      break;
+    }
   }
 }
 /** Register the duplicate output with the origin task */
@@ -424,6 +568,42 @@ void DupEnd(u32 method, u32 replica, Task *orig_task, Task *dup_task) override {
       hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<PollTargetMetadataTask*>(orig_task), reinterpret_cast<PollTargetMetadataTask*>(dup_task));
       break;
     }
+    case Method::kMultiPutBlob: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<MultiPutBlobTask*>(orig_task), reinterpret_cast<MultiPutBlobTask*>(dup_task));
+      break;
+    }
+    case Method::kMultiGetBlob: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<MultiGetBlobTask*>(orig_task), reinterpret_cast<MultiGetBlobTask*>(dup_task));
+      break;
+    }
+    case Method::kPollFlushStats: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<PollFlushStatsTask*>(orig_task), reinterpret_cast<PollFlushStatsTask*>(dup_task));
+      break;
+    }
+    case Method::kPollBlobMetadataPage: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<PollBlobMetadataPageTask*>(orig_task), reinterpret_cast<PollBlobMetadataPageTask*>(dup_task));
+      break;
+    }
+    case Method::kGetBlobsWithTag: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<GetBlobsWithTagTask*>(orig_task), reinterpret_cast<GetBlobsWithTagTask*>(dup_task));
+      break;
+    }
+    case Method::kListBlobs: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<ListBlobsTask*>(orig_task), reinterpret_cast<ListBlobsTask*>(dup_task));
+      break;
+    }
+    case Method::kDestroyBlobs: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<DestroyBlobsTask*>(orig_task), reinterpret_cast<DestroyBlobsTask*>(dup_task));
+      break;
+    }
+    case Method::kFlushSizeDeltas: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<FlushSizeDeltasTask*>(orig_task), reinterpret_cast<FlushSizeDeltasTask*>(dup_task));
+      break;
+    }
+    case Method::kMultiGetBlobSize: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<MultiGetBlobSizeTask*>(orig_task), reinterpret_cast<MultiGetBlobSizeTask*>(dup_task));
+      break;
+    }
   }
 }
 /** Ensure there is space to store replicated outputs */
@@ -509,6 +689,42 @@ void ReplicateStart(u32 method, u32 count, Task *task) override {
       hrun::CALL_REPLICA_START(count, reinterpret_cast<PollTargetMetadataTask*>(task));
       break;
     }
+    case Method::kMultiPutBlob: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<MultiPutBlobTask*>(task));
+      break;
+    }
+    case Method::kMultiGetBlob: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<MultiGetBlobTask*>(task));
+      break;
+    }
+    case Method::kPollFlushStats: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<PollFlushStatsTask*>(task));
+      break;
+    }
+    case Method::kPollBlobMetadataPage: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<PollBlobMetadataPageTask*>(task));
+      break;
+    }
+    case Method::kGetBlobsWithTag: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<GetBlobsWithTagTask*>(task));
+      break;
+    }
+    case Method::kListBlobs: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<ListBlobsTask*>(task));
+      break;
+    }
+    case Method::kDestroyBlobs: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<DestroyBlobsTask*>(task));
+      break;
+    }
+    case Method::kFlushSizeDeltas: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<FlushSizeDeltasTask*>(task));
+      break;
+    }
+    case Method::kMultiGetBlobSize: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<MultiGetBlobSizeTask*>(task));
+      break;
+    }
   }
 }
 /** Determine success and handle failures */
@@ -594,6 +810,42 @@ void ReplicateEnd(u32 method, Task *task) override {
       hrun::CALL_REPLICA_END(reinterpret_cast<PollTargetMetadataTask*>(task));
       break;
     }
+    case Method::kMultiPutBlob: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<MultiPutBlobTask*>(task));
+      break;
+    }
+    case Method::kMultiGetBlob: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<MultiGetBlobTask*>(task));
+      break;
+    }
+    case Method::kPollFlushStats: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<PollFlushStatsTask*>(task));
+      break;
+    }
+    case Method::kPollBlobMetadataPage: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<PollBlobMetadataPageTask*>(task));
+      break;
+    }
+    case Method::kGetBlobsWithTag: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<GetBlobsWithTagTask*>(task));
+      break;
+    }
+    case Method::kListBlobs: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<ListBlobsTask*>(task));
+      break;
+    }
+    case Method::kDestroyBlobs: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<DestroyBlobsTask*>(task));
+      break;
+    }
+    case Method::kFlushSizeDeltas: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<FlushSizeDeltasTask*>(task));
+      break;
+    }
+    case Method::kMultiGetBlobSize: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<MultiGetBlobSizeTask*>(task));
+      break;
+    }
   }
 }
 /** Serialize a task when initially pushing into remote */
@@ -679,6 +931,42 @@ std::vector<DataTransfer> SaveStart(u32 method, BinaryOutputArchive<true> &ar, T
       ar << *reinterpret_cast<PollTargetMetadataTask*>(task);
       break;
     }
+    case Method::kMultiPutBlob: {
+      ar << *reinterpret_cast<MultiPutBlobTask*>(task);
+      break;
+    }
+    case Method::kMultiGetBlob: {
+      ar << *reinterpret_cast<MultiGetBlobTask*>(task);
+      break;
+    }
+    case Method::kPollFlushStats: {
+      ar << *reinterpret_cast<PollFlushStatsTask*>(task);
+      break;
+    }
+    case Method::kPollBlobMetadataPage: {
+      ar << *reinterpret_cast<PollBlobMetadataPageTask*>(task);
+      break;
+    }
+    case Method::kGetBlobsWithTag: {
+      ar << *reinterpret_cast<GetBlobsWithTagTask*>(task);
+      break;
+    }
+    case Method::kListBlobs: {
+      ar << *reinterpret_cast<ListBlobsTask*>(task);
+      break;
+    }
+    case Method::kDestroyBlobs: {
+      ar << *reinterpret_cast<DestroyBlobsTask*>(task);
+      break;
+    }
+    case Method::kFlushSizeDeltas: {
+      ar << *reinterpret_cast<FlushSizeDeltasTask*>(task);
+      break;
+    }
+    case Method::kMultiGetBlobSize: {
+      ar << *reinterpret_cast<MultiGetBlobSizeTask*>(task);
+      break;
+    }
   }
   return ar.Get();
 }
@@ -786,6 +1074,51 @@ TaskPointer LoadStart(u32 method, BinaryInputArchive<true> &ar) override {
       ar >> *reinterpret_cast<PollTargetMetadataTask*>(task_ptr.ptr_);
       break;
     }
+    case Method::kMultiPutBlob: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<MultiPutBlobTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<MultiPutBlobTask*>(task_ptr.ptr_);
+      break;
+    }
+    case Method::kMultiGetBlob: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<MultiGetBlobTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<MultiGetBlobTask*>(task_ptr.ptr_);
+      break;
+    }
+    case Method::kPollFlushStats: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<PollFlushStatsTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<PollFlushStatsTask*>(task_ptr.ptr_);
+      break;
+    }
+    case Method::kPollBlobMetadataPage: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<PollBlobMetadataPageTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<PollBlobMetadataPageTask*>(task_ptr.ptr_);
+      break;
+    }
+    case Method::kGetBlobsWithTag: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<GetBlobsWithTagTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<GetBlobsWithTagTask*>(task_ptr.ptr_);
+      break;
+    }
+    case Method::kListBlobs: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<ListBlobsTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<ListBlobsTask*>(task_ptr.ptr_);
+      break;
+    }
+    case Method::kDestroyBlobs: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<DestroyBlobsTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<DestroyBlobsTask*>(task_ptr.ptr_);
+      break;
+    }
+    case Method::kFlushSizeDeltas: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<FlushSizeDeltasTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<FlushSizeDeltasTask*>(task_ptr.ptr_);
+      break;
+    }
+    case Method::kMultiGetBlobSize: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<MultiGetBlobSizeTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<MultiGetBlobSizeTask*>(task_ptr.ptr_);
+      break;
+    }
   }
   return task_ptr;
 }
@@ -872,6 +1205,42 @@ std::vector<DataTransfer> SaveEnd(u32 method, BinaryOutputArchive<false> &ar, Ta
       ar << *reinterpret_cast<PollTargetMetadataTask*>(task);
       break;
     }
+    case Method::kMultiPutBlob: {
+      ar << *reinterpret_cast<MultiPutBlobTask*>(task);
+      break;
+    }
+    case Method::kMultiGetBlob: {
+      ar << *reinterpret_cast<MultiGetBlobTask*>(task);
+      break;
+    }
+    case Method::kPollFlushStats: {
+      ar << *reinterpret_cast<PollFlushStatsTask*>(task);
+      break;
+    }
+    case Method::kPollBlobMetadataPage: {
+      ar << *reinterpret_cast<PollBlobMetadataPageTask*>(task);
+      break;
+    }
+    case Method::kGetBlobsWithTag: {
+      ar << *reinterpret_cast<GetBlobsWithTagTask*>(task);
+      break;
+    }
+    case Method::kListBlobs: {
+      ar << *reinterpret_cast<ListBlobsTask*>(task);
+      break;
+    }
+    case Method::kDestroyBlobs: {
+      ar << *reinterpret_cast<DestroyBlobsTask*>(task);
+      break;
+    }
+    case Method::kFlushSizeDeltas: {
+      ar << *reinterpret_cast<FlushSizeDeltasTask*>(task);
+      break;
+    }
+    case Method::kMultiGetBlobSize: {
+      ar << *reinterpret_cast<MultiGetBlobSizeTask*>(task);
+      break;
+    }
   }
   return ar.Get();
 }
@@ -958,6 +1327,42 @@ void LoadEnd(u32 replica, u32 method, BinaryInputArchive<false> &ar, Task *task)
       ar.Deserialize(replica, *reinterpret_cast<PollTargetMetadataTask*>(task));
       break;
     }
+    case Method::kMultiPutBlob: {
+      ar.Deserialize(replica, *reinterpret_cast<MultiPutBlobTask*>(task));
+      break;
+    }
+    case Method::kMultiGetBlob: {
+      ar.Deserialize(replica, *reinterpret_cast<MultiGetBlobTask*>(task));
+      break;
+    }
+    case Method::kPollFlushStats: {
+      ar.Deserialize(replica, *reinterpret_cast<PollFlushStatsTask*>(task));
+      break;
+    }
+    case Method::kPollBlobMetadataPage: {
+      ar.Deserialize(replica, *reinterpret_cast<PollBlobMetadataPageTask*>(task));
+      break;
+    }
+    case Method::kGetBlobsWithTag: {
+      ar.Deserialize(replica, *reinterpret_cast<GetBlobsWithTagTask*>(task));
+      break;
+    }
+    case Method::kListBlobs: {
+      ar.Deserialize(replica, *reinterpret_cast<ListBlobsTask*>(task));
+      break;
+    }
+    case Method::kDestroyBlobs: {
+      ar.Deserialize(replica, *reinterpret_cast<DestroyBlobsTask*>(task));
+      break;
+    }
+    case Method::kFlushSizeDeltas: {
+      ar.Deserialize(replica, *reinterpret_cast<FlushSizeDeltasTask*>(task));
+      break;
+    }
+    case Method::kMultiGetBlobSize: {
+      ar.Deserialize(replica, *reinterpret_cast<MultiGetBlobSizeTask*>(task));
+      break;
+    }
   }
 }
 /** Get the grouping of the task */
@@ -1023,6 +1428,33 @@ u32 GetGroup(u32 method, Task *task, hshm::charbuf &group) override {
     case Method::kPollTargetMetadata: {
       return reinterpret_cast<PollTargetMetadataTask*>(task)->GetGroup(group);
     }
+    case Method::kMultiPutBlob: {
+      return reinterpret_cast<MultiPutBlobTask*>(task)->GetGroup(group);
+    }
+    case Method::kMultiGetBlob: {
+      return reinterpret_cast<MultiGetBlobTask*>(task)->GetGroup(group);
+    }
+    case Method::kPollFlushStats: {
+      return reinterpret_cast<PollFlushStatsTask*>(task)->GetGroup(group);
+    }
+    case Method::kPollBlobMetadataPage: {
+      return reinterpret_cast<PollBlobMetadataPageTask*>(task)->GetGroup(group);
+    }
+    case Method::kGetBlobsWithTag: {
+      return reinterpret_cast<GetBlobsWithTagTask*>(task)->GetGroup(group);
+    }
+    case Method::kListBlobs: {
+      return reinterpret_cast<ListBlobsTask*>(task)->GetGroup(group);
+    }
+    case Method::kDestroyBlobs: {
+      return reinterpret_cast<DestroyBlobsTask*>(task)->GetGroup(group);
+    }
+    case Method::kFlushSizeDeltas: {
+      return reinterpret_cast<FlushSizeDeltasTask*>(task)->GetGroup(group);
+    }
+    case Method::kMultiGetBlobSize: {
+      return reinterpret_cast<MultiGetBlobSizeTask*>(task)->GetGroup(group);
+    }
   }
   return -1;
 }
@@ -21,6 +21,15 @@ struct Method : public TaskMethod {
   TASK_METHOD_T kFlushData = kLast + 17;
   TASK_METHOD_T kPollBlobMetadata = kLast + 18;
   TASK_METHOD_T kPollTargetMetadata = kLast + 19;
+  TASK_METHOD_T kMultiPutBlob = kLast + 20;
+  TASK_METHOD_T kMultiGetBlob = kLast + 21;
+  TASK_METHOD_T kPollFlushStats = kLast + 22;
+  TASK_METHOD_T kPollBlobMetadataPage = kLast + 23;
+  TASK_METHOD_T kGetBlobsWithTag = kLast + 24;
+  TASK_METHOD_T kListBlobs = kLast + 25;
+  TASK_METHOD_T kDestroyBlobs = kLast + 26;
+  TASK_METHOD_T kFlushSizeDeltas = kLast + 27;
+  TASK_METHOD_T kMultiGetBlobSize = kLast + 28;
 };
 
 #endif  // HRUN_HERMES_BLOB_MDM_METHODS_H_
\ No newline at end of file
@@ -235,6 +235,8 @@ class PutBlobPhase {
 #define HERMES_GET_BLOB_ID BIT_OPT(u32, 7)
 #define HERMES_HAS_DERIVED BIT_OPT(u32, 8)
 #define HERMES_USER_SCORE_STATIONARY BIT_OPT(u32, 9)
+#define HERMES_BLOB_BACKGROUND BIT_OPT(u32, 10)
+#define HERMES_BLOB_DEDUP BIT_OPT(u32, 11)
 
 /** A task to put data in a blob */
 struct PutBlobTask : public Task, TaskFlags<TF_SRL_ASYM_START | TF_SRL_SYM_END> {
@@ -246,6 +248,7 @@ struct PutBlobTask : public Task, TaskFlags<TF_SRL_ASYM_START | TF_SRL_SYM_END>
   IN float score_;
   IN bitfield32_t flags_;
   IN BlobId blob_id_;
+  IN int codec_;
 
   /** SHM default constructor */
   HSHM_ALWAYS_INLINE explicit
@@ -291,6 +294,7 @@ struct PutBlobTask : public Task, TaskFlags<TF_SRL_ASYM_START | TF_SRL_SYM_END>
     data_ = data;
     score_ = score;
     flags_ = bitfield32_t(flags | ctx.flags_.bits_);
+    codec_ = static_cast<int>(ctx.codec_);
     // HILOG(kInfo, "Creating PUT {} of size {}", task_node_, data_size_);
   }
 
@@ -311,7 +315,8 @@ struct PutBlobTask : public Task, TaskFlags<TF_SRL_ASYM_START | TF_SRL_SYM_END>
                       data_size_, domain_id_);
     task_serialize<Ar>(ar);
     ar & xfer;
-    ar(tag_id_, blob_name_, blob_id_, blob_off_, data_size_, score_, flags_);
+    ar(tag_id_, blob_name_, blob_id_, blob_off_, data_size_, score_, flags_,
+       codec_);
   }
 
   /** Deserialize message call */
@@ -321,7 +326,8 @@ struct PutBlobTask : public Task, TaskFlags<TF_SRL_ASYM_START | TF_SRL_SYM_END>
     task_serialize<Ar>(ar);
     ar & xfer;
     data_ = HERMES_MEMORY_MANAGER->Convert<void, hipc::Pointer>(xfer.data_);
-    ar(tag_id_, blob_name_, blob_id_, blob_off_, data_size_, score_, flags_);
+    ar(tag_id_, blob_name_, blob_id_, blob_off_, data_size_, score_, flags_,
+       codec_);
   }
 
   /** (De)serialize message return */
@@ -464,6 +470,320 @@ struct GetBlobTask : public Task, TaskFlags<TF_SRL_ASYM_START | TF_SRL_SYM_END>
   }
 };
 
+/** A single blob operation within a batched put or get */
+struct BlobIoEntry {
+  hshm::charbuf blob_name_;  /**< Name of the blob */
+  BlobId blob_id_;      /**< Id of the blob (output) */
+  size_t blob_off_;     /**< Offset in the blob */
+  size_t data_off_;     /**< Offset of this entry in the batch buffer */
+  size_t data_size_;    /**< Size of the data (actual size for gets) */
+
+  /** Serialization */
+  template<typename Ar>
+  void serialize(Ar &ar) {
+    ar(blob_name_, blob_id_, blob_off_, data_off_, data_size_);
+  }
+};
+
+/** Serialize the entries of a batched blob task */
+static inline void SerializeBlobIoEntries(hipc::string &srl,
+                                          const std::vector<BlobIoEntry> &entries) {
+  std::stringstream ss;
+  cereal::BinaryOutputArchive ar(ss);
+  ar << entries;
+  srl = ss.str();
+}
+
+/** Deserialize the entries of a batched blob task */
+static inline std::vector<BlobIoEntry>
+DeserializeBlobIoEntries(const hipc::string &srl) {
+  std::vector<BlobIoEntry> entries;
+  std::stringstream ss(srl.str());
+  cereal::BinaryInputArchive ar(ss);
+  ar >> entries;
+  return entries;
+}
+
+/**
+ * A task to put data in a batch of blobs. All entries must hash
+ * to the same node and lane as the task.
+ * */
+struct MultiPutBlobTask : public Task, TaskFlags<TF_SRL_ASYM_START | TF_SRL_SYM_END> {
+  IN TagId tag_id_;
+  INOUT hipc::ShmArchive<hipc::string> entries_;
+  IN size_t data_size_;
+  IN hipc::Pointer data_;
+  IN float score_;
+  IN bitfield32_t flags_;
+  IN int codec_;
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  MultiPutBlobTask(hipc::Allocator *alloc) : Task(alloc) {}
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  MultiPutBlobTask(hipc::Allocator *alloc,
+                   const TaskNode &task_node,
+                   const DomainId &domain_id,
+                   const TaskStateId &state_id,
+                   u32 lane_hash,
+                   const TagId &tag_id,
+                   const std::vector<BlobIoEntry> &entries,
+                   size_t data_size,
+                   const hipc::Pointer &data,
+                   float score,
+                   u32 flags,
+                   const Context &ctx,
+                   u32 task_flags) : Task(alloc) {
+    // Initialize task
+    task_node_ = task_node;
+    lane_hash_ = lane_hash;
+    prio_ = TaskPrio::kLowLatency;
+    task_state_ = state_id;
+    method_ = Method::kMultiPutBlob;
+    task_flags_ = bitfield32_t(task_flags);
+    task_flags_.SetBits(TASK_COROUTINE);
+    domain_id_ = domain_id;
+
+    // Custom params
+    tag_id_ = tag_id;
+    HSHM_MAKE_AR0(entries_, alloc);
+    SerializeBlobIoEntries(*entries_, entries);
+    data_size_ = data_size;
+    data_ = data;
+    score_ = score;
+    flags_ = bitfield32_t(flags | ctx.flags_.bits_);
+    codec_ = static_cast<int>(ctx.codec_);
+  }
+
+  /** Destructor */
+  ~MultiPutBlobTask() {
+    HSHM_DESTROY_AR(entries_);
+    if (IsDataOwner()) {
+      HRUN_CLIENT->FreeBuffer(data_);
+    }
+  }
+
+  /** Get the batch entries */
+  std::vector<BlobIoEntry> GetEntries() {
+    return DeserializeBlobIoEntries(*entries_);
+  }
+
+  /** Set the batch entries */
+  void SetEntries(const std::vector<BlobIoEntry> &entries) {
+    SerializeBlobIoEntries(*entries_, entries);
+  }
+
+  /** (De)serialize message call */
+  template<typename Ar>
+  void SaveStart(Ar &ar) {
+    DataTransfer xfer(DT_RECEIVER_READ,
+                      HERMES_MEMORY_MANAGER->Convert<char>(data_),
+                      data_size_, domain_id_);
+    task_serialize<Ar>(ar);
+    ar & xfer;
+    ar(tag_id_, entries_, data_size_, score_, flags_, codec_);
+  }
+
+  /** Deserialize message call */
+  template<typename Ar>
+  void LoadStart(Ar &ar) {
+    DataTransfer xfer;
+    task_serialize<Ar>(ar);
+    ar & xfer;
+    data_ = HERMES_MEMORY_MANAGER->Convert<void, hipc::Pointer>(xfer.data_);
+    ar(tag_id_, entries_, data_size_, score_, flags_, codec_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void SerializeEnd(u32 replica, Ar &ar) {
+    if (flags_.Any(HERMES_GET_BLOB_ID)) {
+      ar(entries_);
+    }
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    hrun::LocalSerialize srl(group);
+    srl << std::string("blob_op");
+    srl << tag_id_;
+    return 0;
+  }
+};
+
+/** A task to get data from a batch of blobs */
+struct MultiGetBlobTask : public Task, TaskFlags<TF_SRL_ASYM_START | TF_SRL_SYM_END> {
+  IN TagId tag_id_;
+  INOUT hipc::ShmArchive<hipc::string> entries_;
+  IN size_t data_size_;
+  IN hipc::Pointer data_;
+  IN bitfield32_t flags_;
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  MultiGetBlobTask(hipc::Allocator *alloc) : Task(alloc) {}
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  MultiGetBlobTask(hipc::Allocator *alloc,
+                   const TaskNode &task_node,
+                   const DomainId &domain_id,
+                   const TaskStateId &state_id,
+                   u32 lane_hash,
+                   const TagId &tag_id,
+                   const std::vector<BlobIoEntry> &entries,
+                   size_t data_size,
+                   const hipc::Pointer &data,
+                   const Context &ctx,
+                   u32 flags) : Task(alloc) {
+    // Initialize task
+    task_node_ = task_node;
+    lane_hash_ = lane_hash;
+    prio_ = TaskPrio::kLowLatency;
+    task_state_ = state_id;
+    method_ = Method::kMultiGetBlob;
+    task_flags_.SetBits(TASK_LOW_LATENCY | TASK_COROUTINE);
+    domain_id_ = domain_id;
+
+    // Custom params
+    tag_id_ = tag_id;
+    HSHM_MAKE_AR0(entries_, alloc);
+    SerializeBlobIoEntries(*entries_, entries);
+    data_size_ = data_size;
+    data_ = data;
+    flags_ = bitfield32_t(flags | ctx.flags_.bits_);
+  }
+
+  /** Destructor */
+  ~MultiGetBlobTask() {
+    HSHM_DESTROY_AR(entries_);
+  }
+
+  /** Get the batch entries */
+  std::vector<BlobIoEntry> GetEntries() {
+    return DeserializeBlobIoEntries(*entries_);
+  }
+
+  /** Set the batch entries */
+  void SetEntries(const std::vector<BlobIoEntry> &entries) {
+    SerializeBlobIoEntries(*entries_, entries);
+  }
+
+  /** (De)serialize message call */
+  template<typename Ar>
+  void SaveStart(Ar &ar) {
+    DataTransfer xfer(DT_RECEIVER_WRITE,
+                      HERMES_MEMORY_MANAGER->Convert<char>(data_),
+                      data_size_, domain_id_);
+    task_serialize<Ar>(ar);
+    ar & xfer;
+    ar(tag_id_, entries_, data_size_, flags_);
+  }
+
+  /** Deserialize message call */
+  template<typename Ar>
+  void LoadStart(Ar &ar) {
+    DataTransfer xfer;
+    task_serialize<Ar>(ar);
+    ar & xfer;
+    data_ = HERMES_MEMORY_MANAGER->Convert<void, hipc::Pointer>(xfer.data_);
+    ar(tag_id_, entries_, data_size_, flags_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void SerializeEnd(u32 replica, Ar &ar) {
+    ar(entries_);
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    hrun::LocalSerialize srl(group);
+    srl << std::string("blob_op");
+    srl << tag_id_;
+    return 0;
+  }
+};
+
+/**
+ * A task to get the sizes of a batch of blobs, returned in the
+ * data_size_ of each entry. All entries must hash to the same node
+ * and lane as the task.
+ * */
+struct MultiGetBlobSizeTask : public Task, TaskFlags<TF_SRL_SYM> {
+  IN TagId tag_id_;
+  INOUT hipc::ShmArchive<hipc::string> entries_;
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  MultiGetBlobSizeTask(hipc::Allocator *alloc) : Task(alloc) {}
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  MultiGetBlobSizeTask(hipc::Allocator *alloc,
+                       const TaskNode &task_node,
+                       const DomainId &domain_id,
+                       const TaskStateId &state_id,
+                       u32 lane_hash,
+                       const TagId &tag_id,
+                       const std::vector<BlobIoEntry> &entries) : Task(alloc) {
+    // Initialize task
+    task_node_ = task_node;
+    lane_hash_ = lane_hash;
+    prio_ = TaskPrio::kLowLatency;
+    task_state_ = state_id;
+    method_ = Method::kMultiGetBlobSize;
+    task_flags_.SetBits(TASK_LOW_LATENCY);
+    domain_id_ = domain_id;
+
+    // Custom params
+    tag_id_ = tag_id;
+    HSHM_MAKE_AR0(entries_, alloc);
+    SerializeBlobIoEntries(*entries_, entries);
+  }
+
+  /** Destructor */
+  ~MultiGetBlobSizeTask() {
+    HSHM_DESTROY_AR(entries_);
+  }
+
+  /** Get the batch entries */
+  std::vector<BlobIoEntry> GetEntries() {
+    return DeserializeBlobIoEntries(*entries_);
+  }
+
+  /** Set the batch entries */
+  void SetEntries(const std::vector<BlobIoEntry> &entries) {
+    SerializeBlobIoEntries(*entries_, entries);
+  }
+
+  /** (De)serialize message call */
+  template<typename Ar>
+  void SerializeStart(Ar &ar) {
+    task_serialize<Ar>(ar);
+    ar(tag_id_, entries_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void SerializeEnd(u32 replica, Ar &ar) {
+    ar(entries_);
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    hrun::LocalSerialize srl(group);
+    srl << std::string("blob_op");
+    srl << tag_id_;
+    return 0;
+  }
+};
+
 /** A task to tag a blob */
 struct TagBlobTask : public Task, TaskFlags<TF_SRL_SYM> {
   IN TagId tag_id_;
@@ -567,17 +887,296 @@ struct BlobHasTagTask : public Task, TaskFlags<TF_SRL_SYM> {
 
   /** (De)serialize message return */
   template<typename Ar>
-  void SerializeEnd(u32 replica, Ar &ar) {
-    ar(has_tag_);
+  void SerializeEnd(u32 replica, Ar &ar) {
+    ar(has_tag_);
+  }
+
+   /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    hrun::LocalSerialize srl(group);
+    srl << std::string("blob_op");
+    srl << tag_id_;
+    return 0;
+  }
+};
+
+/**
+ * Find the blobs labeled with \a tag, across all lanes of all nodes.
+ * If \a tag_id is not null, only blobs in that bucket are returned.
+ * */
+struct GetBlobsWithTagTask : public Task, TaskFlags<TF_SRL_SYM_START | TF_SRL_ASYM_END | TF_REPLICA> {
+  IN TagId tag_id_;
+  IN TagId tag_;
+  TEMP hipc::ShmArchive<hipc::string> my_blob_ids_;
+  TEMP hipc::ShmArchive<hipc::vector<hipc::string>> blob_ids_;
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  GetBlobsWithTagTask(hipc::Allocator *alloc) : Task(alloc) {
+    HSHM_MAKE_AR0(blob_ids_, alloc)
+  }
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  GetBlobsWithTagTask(hipc::Allocator *alloc,
+                      const TaskNode &task_node,
+                      const TaskStateId &state_id,
+                      const TagId &tag_id,
+                      const TagId &tag) : Task(alloc) {
+    // Initialize task
+    task_node_ = task_node;
+    lane_hash_ = 0;
+    prio_ = TaskPrio::kLowLatency;
+    task_state_ = state_id;
+    method_ = Method::kGetBlobsWithTag;
+    task_flags_.SetBits(TASK_LANE_ALL);
+    domain_id_ = DomainId::GetGlobal();
+
+    // Custom params
+    tag_id_ = tag_id;
+    tag_ = tag;
+    HSHM_MAKE_AR0(blob_ids_, alloc)
+    HSHM_MAKE_AR0(my_blob_ids_, alloc)
+  }
+
+  /** Serialize blob ids */
+  void SerializeBlobIds(const std::vector<BlobId> &blob_ids) {
+    std::stringstream ss;
+    cereal::BinaryOutputArchive ar(ss);
+    ar << blob_ids;
+    (*my_blob_ids_) = ss.str();
+  }
+
+  /** Deserialize blob ids */
+  void DeserializeBlobIds(const std::string &srl,
+                          std::vector<BlobId> &blob_ids) {
+    std::vector<BlobId> tmp_blob_ids;
+    std::stringstream ss(srl);
+    cereal::BinaryInputArchive ar(ss);
+    ar >> tmp_blob_ids;
+    blob_ids.insert(blob_ids.end(), tmp_blob_ids.begin(), tmp_blob_ids.end());
+  }
+
+  /** Get combined output of all replicas */
+  std::vector<BlobId> MergeBlobIds() {
+    std::vector<BlobId> blob_ids;
+    for (const hipc::string &srl : *blob_ids_) {
+      DeserializeBlobIds(srl.str(), blob_ids);
+    }
+    return blob_ids;
+  }
+
+  /** Deserialize final query output */
+  std::vector<BlobId> DeserializeBlobIds() {
+    std::vector<BlobId> blob_ids;
+    DeserializeBlobIds(my_blob_ids_->str(), blob_ids);
+    return blob_ids;
+  }
+
+  /** Destructor */
+  ~GetBlobsWithTagTask() {
+    HSHM_DESTROY_AR(blob_ids_)
+    HSHM_DESTROY_AR(my_blob_ids_)
+  }
+
+  /** Duplicate message */
+  void Dup(hipc::Allocator *alloc, GetBlobsWithTagTask &other) {
+    task_dup(other);
+    tag_id_ = other.tag_id_;
+    tag_ = other.tag_;
+    HSHM_MAKE_AR(blob_ids_, alloc, *other.blob_ids_)
+    HSHM_MAKE_AR(my_blob_ids_, alloc, *other.my_blob_ids_)
+  }
+
+  /** Process duplicate message output */
+  void DupEnd(u32 replica, GetBlobsWithTagTask &dup_task) {
+    (*blob_ids_)[replica] = (*dup_task.my_blob_ids_);
+  }
+
+  /** (De)serialize message call */
+  template<typename Ar>
+  void SerializeStart(Ar &ar) {
+    task_serialize<Ar>(ar);
+    ar(tag_id_, tag_, my_blob_ids_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void SaveEnd(Ar &ar) {
+    ar(my_blob_ids_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void LoadEnd(u32 replica, Ar &ar) {
+    ar(my_blob_ids_);
+    DupEnd(replica, *this);
+  }
+
+  /** Begin replication */
+  void ReplicateStart(u32 count) {
+    blob_ids_->resize(count);
+  }
+
+  /** Finalize replication */
+  void ReplicateEnd() {
+    std::vector<BlobId> blob_ids = MergeBlobIds();
+    SerializeBlobIds(blob_ids);
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    return TASK_UNORDERED;
+  }
+};
+
+/**
+ * List up to \a limit blobs of \a tag_id whose names start with \a prefix
+ * and sort after \a start_after, in name order, across all lanes of all
+ * nodes
+ * */
+struct ListBlobsTask : public Task, TaskFlags<TF_SRL_SYM_START | TF_SRL_ASYM_END | TF_REPLICA> {
+  IN TagId tag_id_;
+  IN hipc::ShmArchive<hipc::string> prefix_;
+  IN hipc::ShmArchive<hipc::string> start_after_;
+  IN size_t limit_;
+  TEMP hipc::ShmArchive<hipc::string> my_entries_;
+  TEMP hipc::ShmArchive<hipc::vector<hipc::string>> entries_;
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  ListBlobsTask(hipc::Allocator *alloc) : Task(alloc) {
+    HSHM_MAKE_AR0(entries_, alloc)
+  }
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  ListBlobsTask(hipc::Allocator *alloc,
+                const TaskNode &task_node,
+                const TaskStateId &state_id,
+                const TagId &tag_id,
+                const std::string &prefix,
+                const std::string &start_after,
+                size_t limit) : Task(alloc) {
+    // Initialize task
+    task_node_ = task_node;
+    lane_hash_ = 0;
+    prio_ = TaskPrio::kLowLatency;
+    task_state_ = state_id;
+    method_ = Method::kListBlobs;
+    task_flags_.SetBits(TASK_LANE_ALL);
+    domain_id_ = DomainId::GetGlobal();
+
+    // Custom params
+    tag_id_ = tag_id;
+    HSHM_MAKE_AR(prefix_, alloc, prefix)
+    HSHM_MAKE_AR(start_after_, alloc, start_after)
+    limit_ = limit;
+    HSHM_MAKE_AR0(entries_, alloc)
+    HSHM_MAKE_AR0(my_entries_, alloc)
+  }
+
+  /** Serialize listed blobs */
+  void SerializeEntries(const std::vector<BlobNameEntry> &entries) {
+    std::stringstream ss;
+    cereal::BinaryOutputArchive ar(ss);
+    ar << entries;
+    (*my_entries_) = ss.str();
+  }
+
+  /** Deserialize listed blobs */
+  void DeserializeEntries(const std::string &srl,
+                          std::vector<BlobNameEntry> &entries) {
+    std::vector<BlobNameEntry> tmp_entries;
+    std::stringstream ss(srl);
+    cereal::BinaryInputArchive ar(ss);
+    ar >> tmp_entries;
+    for (BlobNameEntry &entry : tmp_entries) {
+      entries.emplace_back(std::move(entry));
+    }
+  }
+
+  /** Get the first limit_ entries of all replicas, in name order */
+  std::vector<BlobNameEntry> MergeEntries() {
+    std::vector<BlobNameEntry> entries;
+    for (const hipc::string &srl : *entries_) {
+      DeserializeEntries(srl.str(), entries);
+    }
+    std::sort(entries.begin(), entries.end());
+    if (entries.size() > limit_) {
+      entries.resize(limit_);
+    }
+    return entries;
+  }
+
+  /** Deserialize final query output */
+  std::vector<BlobNameEntry> DeserializeEntries() {
+    std::vector<BlobNameEntry> entries;
+    DeserializeEntries(my_entries_->str(), entries);
+    return entries;
+  }
+
+  /** Destructor */
+  ~ListBlobsTask() {
+    HSHM_DESTROY_AR(prefix_)
+    HSHM_DESTROY_AR(start_after_)
+    HSHM_DESTROY_AR(entries_)
+    HSHM_DESTROY_AR(my_entries_)
+  }
+
+  /** Duplicate message */
+  void Dup(hipc::Allocator *alloc, ListBlobsTask &other) {
+    task_dup(other);
+    tag_id_ = other.tag_id_;
+    HSHM_MAKE_AR(prefix_, alloc, *other.prefix_)
+    HSHM_MAKE_AR(start_after_, alloc, *other.start_after_)
+    limit_ = other.limit_;
+    HSHM_MAKE_AR(entries_, alloc, *other.entries_)
+    HSHM_MAKE_AR(my_entries_, alloc, *other.my_entries_)
+  }
+
+  /** Process duplicate message output */
+  void DupEnd(u32 replica, ListBlobsTask &dup_task) {
+    (*entries_)[replica] = (*dup_task.my_entries_);
+  }
+
+  /** (De)serialize message call */
+  template<typename Ar>
+  void SerializeStart(Ar &ar) {
+    task_serialize<Ar>(ar);
+    ar(tag_id_, prefix_, start_after_, limit_, my_entries_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void SaveEnd(Ar &ar) {
+    ar(my_entries_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void LoadEnd(u32 replica, Ar &ar) {
+    ar(my_entries_);
+    DupEnd(replica, *this);
   }
 
-   /** Create group */
+  /** Begin replication */
+  void ReplicateStart(u32 count) {
+    entries_->resize(count);
+  }
+
+  /** Finalize replication */
+  void ReplicateEnd() {
+    std::vector<BlobNameEntry> entries = MergeEntries();
+    SerializeEntries(entries);
+  }
+
+  /** Create group */
   HSHM_ALWAYS_INLINE
   u32 GetGroup(hshm::charbuf &group) {
-    hrun::LocalSerialize srl(group);
-    srl << std::string("blob_op");
-    srl << tag_id_;
-    return 0;
+    return TASK_UNORDERED;
   }
 };
 
@@ -1075,13 +1674,78 @@ struct DestroyBlobTask : public Task, TaskFlags<TF_SRL_SYM> {
   }
 };
 
-/** Phases of the destroy blob task */
-struct ReorganizeBlobPhase {
-  TASK_METHOD_T kGet = 0;
-  TASK_METHOD_T kWaitGet = 1;
-  TASK_METHOD_T kPut = 2;
+/**
+ * A task to destroy many blobs of a tag at once. The blobs must live in
+ * the same lane of the same node. Buffers are freed with one vectored
+ * free per target and the tag size is updated once.
+ * */
+struct DestroyBlobsTask : public Task, TaskFlags<TF_SRL_SYM> {
+  IN TagId tag_id_;
+  IN hipc::ShmArchive<hipc::vector<BlobId>> blob_ids_;
+  IN bool update_size_;
+  TEMP int phase_ = DestroyBlobPhase::kFreeBuffers;
+  TEMP hipc::ShmArchive<std::vector<bdev::FreeTask *>> free_tasks_;
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  DestroyBlobsTask(hipc::Allocator *alloc) : Task(alloc) {}
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  DestroyBlobsTask(hipc::Allocator *alloc,
+                   const TaskNode &task_node,
+                   const DomainId &domain_id,
+                   const TaskStateId &state_id,
+                   const TagId &tag_id,
+                   const std::vector<BlobId> &blob_ids,
+                   bool update_size) : Task(alloc) {
+    // Initialize task
+    task_node_ = task_node;
+    lane_hash_ = blob_ids.empty() ? 0 : blob_ids[0].hash_;
+    prio_ = TaskPrio::kLowLatency;
+    task_state_ = state_id;
+    method_ = Method::kDestroyBlobs;
+    task_flags_.SetBits(TASK_LOW_LATENCY);
+    domain_id_ = domain_id;
+
+    // Custom params
+    tag_id_ = tag_id;
+    HSHM_MAKE_AR0(blob_ids_, alloc);
+    blob_ids_->reserve(blob_ids.size());
+    for (const BlobId &blob_id : blob_ids) {
+      blob_ids_->emplace_back(blob_id);
+    }
+    update_size_ = update_size;
+  }
+
+  /** Destructor */
+  ~DestroyBlobsTask() {
+    HSHM_DESTROY_AR(blob_ids_)
+  }
+
+  /** (De)serialize message call */
+  template<typename Ar>
+  void SerializeStart(Ar &ar) {
+    task_serialize<Ar>(ar);
+    ar(tag_id_, blob_ids_, update_size_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void SerializeEnd(u32 replica, Ar &ar) {
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    hrun::LocalSerialize srl(group);
+    srl << std::string("blob_op");
+    srl << tag_id_;
+    return 0;
+  }
 };
 
+/** Phases of the destroy blob task */
 /** A task to reorganize a blob's composition in the hierarchy */
 struct ReorganizeBlobTask : public Task, TaskFlags<TF_SRL_SYM> {
   IN hipc::ShmArchive<hipc::charbuf> blob_name_;
@@ -1089,12 +1753,7 @@ struct ReorganizeBlobTask : public Task, TaskFlags<TF_SRL_SYM> {
   IN float score_;
   IN u32 node_id_;
   IN bool is_user_score_;
-  TEMP int phase_ = ReorganizeBlobPhase::kGet;
-  TEMP hipc::Pointer data_;
-  TEMP size_t data_size_;
-  TEMP GetBlobTask *get_task_;
-  TEMP PutBlobTask *put_task_;
-  TEMP TagId tag_id_;
+  IN TagId tag_id_;
 
   /** SHM default constructor */
   HSHM_ALWAYS_INLINE explicit
@@ -1119,7 +1778,7 @@ struct ReorganizeBlobTask : public Task, TaskFlags<TF_SRL_SYM> {
     prio_ = TaskPrio::kLowLatency;
     task_state_ = state_id;
     method_ = Method::kReorganizeBlob;
-    task_flags_.SetBits(task_flags);
+    task_flags_.SetBits(task_flags | TASK_COROUTINE);
     domain_id_ = domain_id;
 
     // Custom params
@@ -1457,6 +2116,292 @@ struct PollTargetMetadataTask : public Task, TaskFlags<TF_SRL_SYM_START | TF_SRL
   }
 };
 
+/** A task to collect the statistics of the flush pipeline */
+struct PollFlushStatsTask : public Task, TaskFlags<TF_SRL_SYM_START | TF_SRL_ASYM_START | TF_REPLICA> {
+  OUT hipc::ShmArchive<hipc::string> my_flush_stats_;
+  TEMP hipc::ShmArchive<hipc::vector<hipc::string>> flush_stats_;
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  PollFlushStatsTask(hipc::Allocator *alloc) : Task(alloc) {
+    HSHM_MAKE_AR0(flush_stats_, alloc)
+  }
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  PollFlushStatsTask(hipc::Allocator *alloc,
+                     const TaskNode &task_node,
+                     const TaskStateId &state_id) : Task(alloc) {
+    // Initialize task
+    task_node_ = task_node;
+    lane_hash_ = 0;
+    prio_ = TaskPrio::kLowLatency;
+    task_state_ = state_id;
+    method_ = Method::kPollFlushStats;
+    task_flags_.SetBits(TASK_COROUTINE);
+    domain_id_ = DomainId::GetGlobal();
+
+    // Custom params
+    HSHM_MAKE_AR0(my_flush_stats_, alloc)
+    HSHM_MAKE_AR0(flush_stats_, alloc)
+  }
+
+  /** Serialize flush stats */
+  void SerializeFlushStats(const std::vector<FlushStats> &flush_stats) {
+    std::stringstream ss;
+    cereal::BinaryOutputArchive ar(ss);
+    ar << flush_stats;
+    (*my_flush_stats_) = ss.str();
+  }
+
+  /** Deserialize flush stats */
+  void DeserializeFlushStats(const std::string &srl,
+                             std::vector<FlushStats> &flush_stats) {
+    std::vector<FlushStats> tmp_flush_stats;
+    std::stringstream ss(srl);
+    cereal::BinaryInputArchive ar(ss);
+    ar >> tmp_flush_stats;
+    for (FlushStats &stats : tmp_flush_stats) {
+      flush_stats.emplace_back(stats);
+    }
+  }
+
+  /** Get combined output of all replicas */
+  std::vector<FlushStats> MergeFlushStats() {
+    std::vector<FlushStats> flush_stats;
+    for (const hipc::string &srl : *flush_stats_) {
+      DeserializeFlushStats(srl.str(), flush_stats);
+    }
+    return flush_stats;
+  }
+
+  /** Deserialize final query output */
+  std::vector<FlushStats> DeserializeFlushStats() {
+    std::vector<FlushStats> flush_stats;
+    DeserializeFlushStats(my_flush_stats_->str(), flush_stats);
+    return flush_stats;
+  }
+
+  /** Destructor */
+  ~PollFlushStatsTask() {
+    HSHM_DESTROY_AR(my_flush_stats_)
+    HSHM_DESTROY_AR(flush_stats_)
+  }
+
+  /** Duplicate message */
+  void Dup(hipc::Allocator *alloc, PollFlushStatsTask &other) {}
+
+  /** Process duplicate message output */
+  void DupEnd(u32 replica, PollFlushStatsTask &dup_task) {
+    (*flush_stats_)[replica] = (*dup_task.my_flush_stats_);
+  }
+
+  /** (De)serialize message call */
+  template<typename Ar>
+  void SerializeStart(Ar &ar) {
+    task_serialize<Ar>(ar);
+    ar(my_flush_stats_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void SaveEnd(Ar &ar) {
+    ar(my_flush_stats_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void LoadEnd(u32 replica, Ar &ar) {
+    ar(my_flush_stats_);
+    DupEnd(replica, *this);
+  }
+
+  /** Begin replication */
+  void ReplicateStart(u32 count) {
+    flush_stats_->resize(count);
+  }
+
+  /** Finalize replication */
+  void ReplicateEnd() {
+    std::vector<FlushStats> flush_stats = MergeFlushStats();
+    SerializeFlushStats(flush_stats);
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    return TASK_UNORDERED;
+  }
+};
+
+/**
+ * Collect a page of blob summaries from one lane of one node,
+ * starting at \a cursor and filtered by \a query
+ * */
+struct PollBlobMetadataPageTask : public Task, TaskFlags<TF_SRL_SYM> {
+  IN hipc::ShmArchive<hipc::string> query_;
+  INOUT MetadataCursor cursor_;
+  OUT hipc::ShmArchive<hipc::string> page_;
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  PollBlobMetadataPageTask(hipc::Allocator *alloc) : Task(alloc) {}
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  PollBlobMetadataPageTask(hipc::Allocator *alloc,
+                           const TaskNode &task_node,
+                           const TaskStateId &state_id,
+                           const BlobQuery &query,
+                           const MetadataCursor &cursor) : Task(alloc) {
+    // Initialize task
+    task_node_ = task_node;
+    lane_hash_ = cursor.lane_;
+    prio_ = TaskPrio::kLowLatency;
+    task_state_ = state_id;
+    method_ = Method::kPollBlobMetadataPage;
+    task_flags_.SetBits(0);
+    domain_id_ = DomainId::GetNode(cursor.node_id_);
+
+    // Custom params
+    std::stringstream ss;
+    {
+      cereal::BinaryOutputArchive ar(ss);
+      ar << query;
+    }
+    HSHM_MAKE_AR(query_, alloc, ss.str())
+    cursor_ = cursor;
+    HSHM_MAKE_AR0(page_, alloc)
+  }
+
+  /** Deserialize the filters */
+  BlobQuery GetQuery() {
+    BlobQuery query;
+    std::stringstream ss(query_->str());
+    cereal::BinaryInputArchive ar(ss);
+    ar >> query;
+    return query;
+  }
+
+  /** Serialize the page */
+  void SerializePage(const std::vector<BlobStat> &page) {
+    std::stringstream ss;
+    {
+      cereal::BinaryOutputArchive ar(ss);
+      ar << page;
+    }
+    (*page_) = ss.str();
+  }
+
+  /** Deserialize the page */
+  std::vector<BlobStat> DeserializePage() {
+    std::vector<BlobStat> page;
+    std::stringstream ss(page_->str());
+    cereal::BinaryInputArchive ar(ss);
+    ar >> page;
+    return page;
+  }
+
+  /** Destructor */
+  ~PollBlobMetadataPageTask() {
+    HSHM_DESTROY_AR(query_)
+    HSHM_DESTROY_AR(page_)
+  }
+
+  /** (De)serialize message call */
+  template<typename Ar>
+  void SerializeStart(Ar &ar) {
+    task_serialize<Ar>(ar);
+    ar(query_, cursor_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void SerializeEnd(u32 replica, Ar &ar) {
+    ar(cursor_, page_);
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    return TASK_UNORDERED;
+  }
+};
+
+/**
+ * A task to send the bucket size changes that lanes are holding to the
+ * bucket mdm, and wait for them to apply. Runs on every lane.
+ * */
+struct FlushSizeDeltasTask : public Task, TaskFlags<TF_SRL_SYM_START | TF_SRL_ASYM_END | TF_REPLICA> {
+  IN TagId tag_id_;  /**< Only flush this tag, unless null */
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  FlushSizeDeltasTask(hipc::Allocator *alloc) : Task(alloc) {}
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  FlushSizeDeltasTask(hipc::Allocator *alloc,
+                      const TaskNode &task_node,
+                      const DomainId &domain_id,
+                      const TaskStateId &state_id,
+                      const TagId &tag_id) : Task(alloc) {
+    // Initialize task
+    task_node_ = task_node;
+    lane_hash_ = 0;
+    prio_ = TaskPrio::kLowLatency;
+    task_state_ = state_id;
+    method_ = Method::kFlushSizeDeltas;
+    task_flags_.SetBits(TASK_LANE_ALL | TASK_COROUTINE);
+    domain_id_ = domain_id;
+
+    // Custom params
+    tag_id_ = tag_id;
+  }
+
+  /** Duplicate message */
+  void Dup(hipc::Allocator *alloc, FlushSizeDeltasTask &other) {
+    task_dup(other);
+    tag_id_ = other.tag_id_;
+  }
+
+  /** Process duplicate message output */
+  void DupEnd(u32 replica, FlushSizeDeltasTask &dup_task) {
+  }
+
+  /** (De)serialize message call */
+  template<typename Ar>
+  void SerializeStart(Ar &ar) {
+    task_serialize<Ar>(ar);
+    ar(tag_id_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void SaveEnd(Ar &ar) {
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void LoadEnd(u32 replica, Ar &ar) {
+    DupEnd(replica, *this);
+  }
+
+  /** Begin replication */
+  void ReplicateStart(u32 count) {
+  }
+
+  /** Finalize replication */
+  void ReplicateEnd() {
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    return TASK_UNORDERED;
+  }
+};
+
 }  // namespace hermes::blob_mdm
 
 #endif //HRUN_TASKS_HERMES_BLOB_MDM_INCLUDE_HERMES_BLOB_MDM_HERMES_BLOB_MDM_TASKS_H_
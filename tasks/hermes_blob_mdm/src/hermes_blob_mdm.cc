@@ -12,13 +12,302 @@
 #include "data_stager/data_stager.h"
 #include "hermes_data_op/hermes_data_op.h"
 #include "hermes/score_histogram.h"
+#include "hermes/flat_hash_map.h"
+#include "hermes/compressor.h"
+#include "hermes/dedup_index.h"
+#include "hermes/metadata_log.h"
+#include "hermes/blob_name_index.h"
+#include <queue>
+#include <unordered_set>
 
 namespace hermes::blob_mdm {
 
 /** Type name simplification for the various map types */
-typedef std::unordered_map<hshm::charbuf, BlobId> BLOB_ID_MAP_T;
-typedef std::unordered_map<BlobId, BlobInfo> BLOB_MAP_T;
+typedef FlatHashMap<BlobNameKey, BlobId, BlobNameHash> BLOB_ID_MAP_T;
+typedef FlatHashMap<BlobId, BlobInfo> BLOB_MAP_T;
+typedef FlatHashMap<TagId, std::unordered_set<BlobId>> TAG_INDEX_T;
 typedef hipc::mpsc_queue<IoStat> IO_PATTERN_LOG_T;
+/** The segments of blob I/O, grouped by target */
+typedef std::unordered_map<TargetId, std::vector<bdev::IoSegment>> TARGET_IO_T;
+
+/** Max number of blobs staged out per flush period */
+static const size_t kMaxFlushBatch = 256;
+/** Max number of blob scores refreshed per flush period */
+static const size_t kMaxScoreBatch = 4096;
+/** Number of refreshes over which an unaccessed blob's score decays */
+static const size_t kScoreSteps = 10;
+/** Granularity at which HERMES_BLOB_DEDUP puts share slabs */
+static const size_t kDedupPageSize = MEGABYTES(1);
+
+/**
+ * Blobs modified since their last flush, in the order they became dirty.
+ * The links are stored in BlobInfo, so updates never allocate.
+ * */
+class DirtyBlobList {
+ public:
+  BlobInfo *head_ = nullptr;
+  BlobInfo *tail_ = nullptr;
+  size_t size_ = 0;
+
+ public:
+  /** Append a blob, unless it is already in the list */
+  void Push(BlobInfo &blob_info) {
+    if (blob_info.is_dirty_) {
+      return;
+    }
+    blob_info.is_dirty_ = true;
+    blob_info.dirty_prev_ = tail_;
+    blob_info.dirty_next_ = nullptr;
+    if (tail_) {
+      tail_->dirty_next_ = &blob_info;
+    } else {
+      head_ = &blob_info;
+    }
+    tail_ = &blob_info;
+    ++size_;
+  }
+
+  /** Remove a blob, if it is in the list */
+  void Remove(BlobInfo &blob_info) {
+    if (!blob_info.is_dirty_) {
+      return;
+    }
+    if (blob_info.dirty_prev_) {
+      blob_info.dirty_prev_->dirty_next_ = blob_info.dirty_next_;
+    } else {
+      head_ = blob_info.dirty_next_;
+    }
+    if (blob_info.dirty_next_) {
+      blob_info.dirty_next_->dirty_prev_ = blob_info.dirty_prev_;
+    } else {
+      tail_ = blob_info.dirty_prev_;
+    }
+    blob_info.dirty_prev_ = nullptr;
+    blob_info.dirty_next_ = nullptr;
+    blob_info.is_dirty_ = false;
+    --size_;
+  }
+
+  /** Remove and return the oldest dirty blob */
+  BlobInfo* Pop() {
+    BlobInfo *blob_info = head_;
+    if (blob_info) {
+      Remove(*blob_info);
+    }
+    return blob_info;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+};
+
+/**
+ * Tracks which blob scores may have changed, so the BORG never rescans
+ * cold blobs. An unaccessed blob's score only decays with the time since
+ * its last access, so it is refreshed in steps until the decay ends and
+ * then left alone; an access schedules an immediate refresh. Blobs that
+ * should change tier are queued per destination target: promotions
+ * highest score first, demotions lowest score first. Entries are
+ * invalidated lazily through BlobInfo::rescore_time_ and reorg_version_.
+ * */
+class ScoreIndex {
+ public:
+  /** A blob whose score should be refreshed at time_ */
+  struct RescoreEntry {
+    double time_;
+    BlobId blob_id_;
+
+    bool operator>(const RescoreEntry &other) const {
+      return time_ > other.time_;
+    }
+  };
+
+  /** A blob that should move to another target */
+  struct ReorgEntry {
+    float score_;
+    BlobId blob_id_;
+    u32 version_;
+  };
+
+  /** Orders the hottest candidate first */
+  struct HottestFirst {
+    bool operator()(const ReorgEntry &a, const ReorgEntry &b) const {
+      return a.score_ < b.score_;
+    }
+  };
+
+  /** Orders the coldest candidate first */
+  struct ColdestFirst {
+    bool operator()(const ReorgEntry &a, const ReorgEntry &b) const {
+      return a.score_ > b.score_;
+    }
+  };
+
+  std::priority_queue<RescoreEntry, std::vector<RescoreEntry>,
+                      std::greater<RescoreEntry>> rescore_;
+  std::vector<std::priority_queue<ReorgEntry, std::vector<ReorgEntry>,
+                                  HottestFirst>> promote_;
+  std::vector<std::priority_queue<ReorgEntry, std::vector<ReorgEntry>,
+                                  ColdestFirst>> demote_;
+
+ public:
+  /** Allocate the candidate queues of \a num_targets targets */
+  void Resize(size_t num_targets) {
+    promote_.resize(num_targets);
+    demote_.resize(num_targets);
+  }
+
+  /** Refresh the blob's score at \a time, unless it is due sooner */
+  void Schedule(BlobInfo &blob_info, double time) {
+    if (blob_info.rescore_time_ >= 0 && blob_info.rescore_time_ <= time) {
+      return;
+    }
+    blob_info.rescore_time_ = time;
+    rescore_.push(RescoreEntry{time, blob_info.blob_id_});
+  }
+
+  /** Pop an entry due at or before \a now */
+  bool PopDue(double now, RescoreEntry &entry) {
+    if (rescore_.empty() || rescore_.top().time_ > now) {
+      return false;
+    }
+    entry = rescore_.top();
+    rescore_.pop();
+    return true;
+  }
+
+  /**
+   * Queue the blob to move. Promotions are queued on the destination at
+   * \a tgt_idx and demotions on the source, so the source's capacity
+   * can decide when they run.
+   * */
+  void PushReorg(size_t tgt_idx, bool promote, const BlobInfo &blob_info) {
+    ReorgEntry entry{blob_info.score_, blob_info.blob_id_,
+                     blob_info.reorg_version_};
+    if (promote) {
+      promote_[tgt_idx].push(entry);
+    } else {
+      demote_[tgt_idx].push(entry);
+    }
+  }
+
+  /** Pop the best candidate queued on the target at \a tgt_idx */
+  bool PopReorg(size_t tgt_idx, bool promote, ReorgEntry &entry) {
+    if (promote) {
+      if (promote_[tgt_idx].empty()) {
+        return false;
+      }
+      entry = promote_[tgt_idx].top();
+      promote_[tgt_idx].pop();
+    } else {
+      if (demote_[tgt_idx].empty()) {
+        return false;
+      }
+      entry = demote_[tgt_idx].top();
+      demote_[tgt_idx].pop();
+    }
+    return true;
+  }
+
+  /** The number of demotions queued on the target at \a tgt_idx */
+  size_t DemoteCount(size_t tgt_idx) const {
+    return demote_[tgt_idx].size();
+  }
+
+  /** Drop the demotions queued on \a tgt_idx that \a is_live rejects */
+  template<typename IsLive>
+  void PruneDemote(size_t tgt_idx, IsLive is_live) {
+    std::vector<ReorgEntry> live;
+    live.reserve(demote_[tgt_idx].size());
+    while (!demote_[tgt_idx].empty()) {
+      if (is_live(demote_[tgt_idx].top())) {
+        live.emplace_back(demote_[tgt_idx].top());
+      }
+      demote_[tgt_idx].pop();
+    }
+    for (ReorgEntry &entry : live) {
+      demote_[tgt_idx].push(entry);
+    }
+  }
+};
+
+/**
+ * Token bucket limiting the rate at which the BORG moves data to or
+ * from a target. Tokens are bytes, refilled at the configured bandwidth
+ * with at most one second of burst. Shared by all lanes.
+ * */
+class MigrationBudget {
+ public:
+  hshm::Mutex lock_;
+  double tokens_ = 0;
+  size_t inflight_ = 0;
+  hshm::Timepoint last_refill_;
+
+ public:
+  /** Start with a full bucket */
+  MigrationBudget() {
+    last_refill_.Now();
+    tokens_ = (double)HERMES_SERVER_CONF.borg_.migrate_bandwidth_;
+  }
+
+  /**
+   * Reserve \a size bytes for a migration. Fails if too many migrations
+   * are in flight or the bucket has too few tokens. A buffer larger than
+   * the bucket may go once the bucket is full.
+   * */
+  bool TryAcquire(size_t size) {
+    BorgInfo &borg = HERMES_SERVER_CONF.borg_;
+    hshm::ScopedMutex lock(lock_, 0);
+    if (inflight_ >= borg.migrate_max_inflight_) {
+      return false;
+    }
+    if (borg.migrate_bandwidth_ > 0) {
+      double max_tokens = (double)borg.migrate_bandwidth_;
+      hshm::Timepoint now;
+      now.Now();
+      tokens_ += last_refill_.GetSecFromStart(now) * max_tokens;
+      tokens_ = std::min(tokens_, max_tokens);
+      last_refill_ = now;
+      if (tokens_ < (double)size && tokens_ < max_tokens) {
+        return false;
+      }
+      tokens_ -= (double)size;
+    }
+    inflight_ += 1;
+    return true;
+  }
+
+  /** Finish a migration. Unused tokens are refunded if \a refund is set. */
+  void Release(size_t size, bool refund) {
+    hshm::ScopedMutex lock(lock_, 0);
+    inflight_ -= 1;
+    if (refund) {
+      tokens_ += (double)size;
+    }
+  }
+};
+
+/** A recovered blob whose data was lost with a RAM or changed device */
+struct LostBlob {
+  TagId tag_id_;
+  BlobId blob_id_;
+  ssize_t size_diff_;  /**< Change in the size of its bucket */
+};
+
+/**
+ * Bucket size changes a lane has not yet sent to the bucket mdm. Puts
+ * into a hot bucket add here instead of each sending an UpdateSize to the
+ * bucket's lane; the sums are sent once per flush period.
+ * */
+struct SizeDeltas {
+  FlatHashMap<TagId, ssize_t> deltas_;
+  hshm::Timepoint last_flush_;
+};
 
 class Server : public TaskLib {
  public:
@@ -32,6 +321,13 @@ class Server : public TaskLib {
    * ===================================*/
   std::vector<BLOB_ID_MAP_T> blob_id_map_;
   std::vector<BLOB_MAP_T> blob_map_;
+  std::vector<TAG_INDEX_T> tag_index_;  /**< Blobs labeled with each tag */
+  std::vector<BlobNameIndex> name_index_;  /**< Per lane, if enabled */
+  std::vector<DirtyBlobList> dirty_list_;
+  std::vector<FlushStats> flush_stats_;
+  std::vector<ScoreIndex> score_index_;
+  std::vector<SizeDeltas> size_deltas_;
+  hshm::Timepoint start_time_;
   std::atomic<u64> id_alloc_;
 
   /**====================================
@@ -48,12 +344,21 @@ class Server : public TaskLib {
   std::vector<bdev::Client> targets_;
   bdev::Client *fallback_target_;
   std::unordered_map<TargetId, TargetInfo*> target_map_;
+  std::unordered_map<TargetId, std::unique_ptr<MigrationBudget>>
+      migrate_budget_;
+  DedupIndex dedup_index_;
   Client blob_mdm_;
   bucket_mdm::Client bkt_mdm_;
   data_stager::Client stager_mdm_;
   data_op::Client op_mdm_;
   LPointer<FlushDataTask> flush_task_;
 
+  /**====================================
+   * Metadata recovery
+   * ===================================*/
+  std::vector<MetadataLog> mdm_logs_;  /**< Per lane, if recovery is enabled */
+  std::vector<LostBlob> lost_blobs_;
+
  public:
   Server() = default;
 
@@ -64,6 +369,15 @@ class Server : public TaskLib {
     // Initialize blob maps
     blob_id_map_.resize(HRUN_QM_RUNTIME->max_lanes_);
     blob_map_.resize(HRUN_QM_RUNTIME->max_lanes_);
+    tag_index_.resize(HRUN_QM_RUNTIME->max_lanes_);
+    if (HERMES_SERVER_CONF.mdm_.name_index_) {
+      name_index_.resize(HRUN_QM_RUNTIME->max_lanes_);
+    }
+    dirty_list_.resize(HRUN_QM_RUNTIME->max_lanes_);
+    flush_stats_.resize(HRUN_QM_RUNTIME->max_lanes_);
+    score_index_.resize(HRUN_QM_RUNTIME->max_lanes_);
+    size_deltas_.resize(HRUN_QM_RUNTIME->max_lanes_);
+    start_time_.Now();
     // Initialize targets
     target_tasks_.reserve(HERMES_SERVER_CONF.devices_.size());
     for (DeviceInfo &dev : HERMES_SERVER_CONF.devices_) {
@@ -103,10 +417,18 @@ class Server : public TaskLib {
     }
     for (bdev::Client &client : targets_) {
       target_map_.emplace(client.id_, &client);
+      migrate_budget_.emplace(client.id_,
+                              std::make_unique<MigrationBudget>());
       HILOG(kInfo, "(node {}) Target {} has bw {} and score {}", HRUN_CLIENT->node_id_,
             client.id_, client.bandwidth_, client.bw_score_);
     }
     fallback_target_ = &targets_.back();
+    for (ScoreIndex &score_index : score_index_) {
+      score_index.Resize(targets_.size());
+    }
+    if (HERMES_SERVER_CONF.recovery_.enabled_) {
+      RecoverBlobs(task);
+    }
     blob_mdm_.Init(id_, HRUN_ADMIN->queue_id_);
     HILOG(kInfo, "(node {}) Created Blob MDM", HRUN_CLIENT->node_id_);
     task->SetModuleComplete();
@@ -114,6 +436,232 @@ class Server : public TaskLib {
   void MonitorConstruct(u32 mode, ConstructTask *task, RunContext &rctx) {
   }
 
+  /** The target of this run that replaces a logged target, if any */
+  TargetInfo* FindRecoveredTarget(const std::string &dev_name,
+                                  const std::vector<size_t> &slab_sizes) {
+    for (bdev::Client &target : targets_) {
+      if (target.dev_name_ == dev_name && target.is_persistent_ &&
+          target.slab_sizes_ == slab_sizes) {
+        return &target;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * Reload the blobs logged before a restart. Buffers are mapped to this
+   * run's targets by device name. Blobs with data on a RAM device or on a
+   * device whose slabs changed are dropped, and removed from their
+   * buckets in the first flush period. The targets then reserve the
+   * buffers of the remaining blobs. Every lane is snapshotted afterwards
+   * so that its log only refers to this run's targets.
+   * */
+  void RecoverBlobs(ConstructTask *task) {
+    RecoveryInfo &recovery = HERMES_SERVER_CONF.recovery_;
+    u32 num_lanes = blob_map_.size();
+    hshm::Timer t;
+    t.Resume();
+
+    // Replay the log of each lane
+    std::vector<std::unordered_map<TargetId, TargetInfo*>> tgt_remaps(
+        num_lanes);
+    size_t num_records = 0;
+    bool same_lanes = true;
+    mdm_logs_.resize(num_lanes);
+    for (u32 lane = 0; lane < num_lanes; ++lane) {
+      BLOB_MAP_T &blob_map = blob_map_[lane];
+      std::unordered_map<TargetId, TargetInfo*> &tgt_remap = tgt_remaps[lane];
+      MetadataLog &log = mdm_logs_[lane];
+      log.Init(recovery.path_, hshm::Formatter::format(
+          "blob_mdm.{}.{}", node_id_, lane));
+      num_records += log.Replay(
+          [&](LogOp op, cereal::BinaryInputArchive &ar) {
+            switch (op) {
+              case LogOp::kLanes: {
+                u32 logged_lanes;
+                ar(logged_lanes);
+                same_lanes &= logged_lanes == num_lanes;
+                break;
+              }
+              case LogOp::kTarget: {
+                TargetId tid;
+                std::string dev_name;
+                std::vector<size_t> slab_sizes;
+                ar(tid, dev_name, slab_sizes);
+                tgt_remap[tid] = FindRecoveredTarget(dev_name, slab_sizes);
+                break;
+              }
+              case LogOp::kPutBlob: {
+                BlobId blob_id;
+                ar(blob_id);
+                ar(blob_map[blob_id]);
+                break;
+              }
+              case LogOp::kDelBlob: {
+                BlobId blob_id;
+                ar(blob_id);
+                blob_map.erase(blob_id);
+                break;
+              }
+              default: {
+                break;
+              }
+            }
+          });
+    }
+    if (!same_lanes) {
+      // Blobs would be looked up in the wrong lanes
+      HELOG(kError, "(node {}) Not recovering blobs: the number of lanes "
+            "changed to {}", node_id_, num_lanes);
+      for (BLOB_MAP_T &blob_map : blob_map_) {
+        blob_map.clear();
+      }
+    }
+
+    // Keep the blobs whose buffers are all on recovered targets
+    hshm::Timepoint now;
+    now.Now();
+    std::unordered_map<TargetId, std::vector<BufferInfo>> reserved;
+    std::unordered_map<TargetId, std::vector<float>> scores;
+    size_t num_blobs = 0;
+    u64 max_unique = 0;
+    for (u32 lane = 0; lane < num_lanes; ++lane) {
+      BLOB_MAP_T &blob_map = blob_map_[lane];
+      std::unordered_map<TargetId, TargetInfo*> &tgt_remap = tgt_remaps[lane];
+      std::vector<BlobId> lost;
+      for (BLOB_MAP_T::value_type &blob_part : blob_map) {
+        BlobInfo &blob_info = blob_part.second;
+        max_unique = std::max(max_unique, blob_info.blob_id_.unique_);
+        bool intact = true;
+        for (BufferInfo &buf : blob_info.buffers_) {
+          auto it = tgt_remap.find(buf.tid_);
+          if (it == tgt_remap.end() || it->second == nullptr) {
+            intact = false;
+            break;
+          }
+          buf.tid_ = it->second->id_;
+        }
+        if (!intact) {
+          // Staged blobs are reloaded from the backend, which keeps its size
+          ssize_t size_diff = blob_info.last_flush_ > 0 ?
+              0 : -(ssize_t)blob_info.blob_size_;
+          lost_blobs_.emplace_back(
+              LostBlob{blob_info.tag_id_, blob_info.blob_id_, size_diff});
+          lost.emplace_back(blob_part.first);
+          continue;
+        }
+        for (const BufferInfo &buf : blob_info.buffers_) {
+          // Shared slabs are reserved once
+          if (buf.fp_ != 0 && !dedup_index_.Recover(buf)) {
+            continue;
+          }
+          reserved[buf.tid_].emplace_back(buf);
+          scores[buf.tid_].emplace_back(blob_info.score_);
+        }
+        blob_info.RebuildExtents();
+        blob_info.last_access_ = now;
+        blob_id_map_[lane].emplace(
+            BlobNameKey(blob_info.tag_id_, blob_info.name_,
+                        HashBlobName(blob_info.tag_id_, blob_info.name_)),
+            blob_info.blob_id_);
+        score_index_[lane].Schedule(blob_info, GetIndexTime(now));
+        for (const TagId &tag : blob_info.tags_) {
+          tag_index_[lane][tag].emplace(blob_info.blob_id_);
+        }
+        IndexBlobName(blob_info, lane);
+        if (blob_info.NeedsFlush()) {
+          dirty_list_[lane].Push(blob_info);
+        }
+        ++num_blobs;
+      }
+      for (BlobId &blob_id : lost) {
+        blob_map.erase(blob_id);
+      }
+    }
+    if (num_records > 0) {
+      id_alloc_ = max_unique + 1;
+    }
+
+    // Mark the recovered buffers as allocated
+    std::vector<LPointer<bdev::ReserveTask>> reserve_tasks;
+    for (auto &tgt_bufs : reserved) {
+      TargetInfo &target = *target_map_[tgt_bufs.first];
+      reserve_tasks.emplace_back(
+          target.AsyncReserve(task->task_node_ + 1,
+                              tgt_bufs.second, scores[tgt_bufs.first]));
+    }
+    for (LPointer<bdev::ReserveTask> &reserve_task : reserve_tasks) {
+      reserve_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(reserve_task);
+    }
+    for (u32 lane = 0; lane < num_lanes; ++lane) {
+      SnapshotLane(lane);
+    }
+    t.Pause();
+    HILOG(kInfo, "(node {}) Recovered {} blobs ({} lost) from {} records "
+          "in {} msec", node_id_, num_blobs, lost_blobs_.size(),
+          num_records, t.GetMsec());
+  }
+
+  /** Replace the snapshot of a lane with its blobs and restart its log */
+  void SnapshotLane(u32 lane) {
+    BLOB_MAP_T &blob_map = blob_map_[lane];
+    mdm_logs_[lane].Snapshot([&](MetadataLog::Writer &writer) {
+      writer.Append(LogOp::kLanes, (u32)blob_map_.size());
+      for (bdev::Client &target : targets_) {
+        writer.Append(LogOp::kTarget, target.id_,
+                      target.dev_name_, target.slab_sizes_);
+      }
+      for (BLOB_MAP_T::value_type &blob_part : blob_map) {
+        writer.Append(LogOp::kPutBlob, blob_part.first, blob_part.second);
+      }
+    });
+  }
+
+  /** Log the metadata of a blob after it changed */
+  void LogBlob(BlobInfo &blob_info, RunContext &rctx) {
+    if (mdm_logs_.empty()) {
+      return;
+    }
+    MetadataLog &log = mdm_logs_[rctx.lane_id_];
+    log.Append(LogOp::kPutBlob, blob_info.blob_id_, blob_info);
+    if (log.NeedsSnapshot(HERMES_SERVER_CONF.recovery_.snapshot_log_size_)) {
+      SnapshotLane(rctx.lane_id_);
+    }
+  }
+
+  /** Log that a blob was destroyed, before its buffers are freed */
+  void LogDestroyBlob(const BlobId &blob_id, RunContext &rctx) {
+    if (mdm_logs_.empty()) {
+      return;
+    }
+    mdm_logs_[rctx.lane_id_].Append(LogOp::kDelBlob, blob_id);
+  }
+
+  /**
+   * Remove the blobs dropped during recovery from their buckets.
+   * Runs in the first flush period, once the bucket mdm is known.
+   * */
+  void ForgetLostBlobs(Task *task) {
+    std::vector<LPointer<bucket_mdm::TagRemoveBlobTask>> remove_tasks;
+    remove_tasks.reserve(lost_blobs_.size());
+    for (LostBlob &lost : lost_blobs_) {
+      remove_tasks.emplace_back(
+          bkt_mdm_.AsyncTagRemoveBlob(task->task_node_ + 1,
+                                      lost.tag_id_, lost.blob_id_));
+      if (lost.size_diff_ != 0) {
+        bkt_mdm_.AsyncUpdateSize(task->task_node_ + 1,
+                                 lost.tag_id_, lost.size_diff_,
+                                 bucket_mdm::UpdateSizeMode::kAdd);
+      }
+    }
+    for (LPointer<bucket_mdm::TagRemoveBlobTask> &remove_task : remove_tasks) {
+      remove_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(remove_task);
+    }
+    lost_blobs_.clear();
+  }
+
   /** Destroy blob mdm */
   void Destruct(DestructTask *task, RunContext &rctx) {
     task->SetModuleComplete();
@@ -122,13 +670,10 @@ class Server : public TaskLib {
   }
 
  private:
-  /** Get the globally unique blob name */
-  const hshm::charbuf GetBlobNameWithBucket(TagId tag_id, const hshm::charbuf &blob_name) {
-    hshm::charbuf new_name(sizeof(TagId) + blob_name.size());
-    hrun::LocalSerialize srl(new_name);
-    srl << tag_id;
-    srl << blob_name;
-    return new_name;
+  /** View a task's blob name without copying it */
+  template<typename StringT>
+  static std::string_view GetNameView(const StringT &name) {
+    return std::string_view(name.data(), name.size());
   }
 
  public:
@@ -191,64 +736,112 @@ class Server : public TaskLib {
     return targets_.back();
   }
 
-  /** Check if blob should be reorganized */
-  template<bool UPDATE_SCORE=false>
-  bool ShouldReorganize(BlobInfo &blob_info,
-                        float score,
-                        TaskNode &task_node) {
-    ServerConfig &server = HERMES_CONF->server_config_;
+  /** Whether \a target is below its BORG minimum capacity */
+  bool IsLowOnCapacity(TargetInfo &target) {
+    size_t rem_cap = target.monitor_task_->rem_cap_;
+    return rem_cap < target.max_cap_ * target.borg_min_thresh_;
+  }
+
+  /**
+   * Find the target a buffer of \a blob_info should migrate to.
+   * Buffers are demoted when their target is low on capacity and
+   * promoted when the target above has room for them. When \a force
+   * is set, the capacity thresholds are ignored. Returns nullptr if
+   * the buffer should stay where it is.
+   * */
+  TargetInfo* FindMigrationTarget(const BlobInfo &blob_info,
+                                  const BufferInfo &buf,
+                                  float score, bool force) {
+    TargetInfo &target = *target_map_[buf.tid_];
+    // Get the target with minimum difference in score to this blob
+    if (abs(target.score_ - score) < .1) {
+      return nullptr;
+    }
+    const bdev::Client &cmp_tgt = FindNearestTarget(score);
+    if (cmp_tgt.id_ == target.id_) {
+      return nullptr;
+    }
+    float cmp_rem_cap = cmp_tgt.monitor_task_->rem_cap_;
+    if (cmp_rem_cap <= buf.t_size_) {
+      return nullptr;
+    }
+    if (!force) {
+      if (cmp_tgt.score_ <= target.score_) {
+        // Demote if we have sufficiently low capacity
+        if (!IsLowOnCapacity(target)) {
+          return nullptr;
+        }
+        HILOG(kInfo, "Demoting buffer of blob {} of score {} "
+              "from tgt={} tgt_score={} to tgt={} tgt_score={}",
+              blob_info.blob_id_, blob_info.score_,
+              target.id_, target.score_,
+              cmp_tgt.id_, cmp_tgt.score_);
+      } else {
+        // Promote since the guy above us has sufficiently high capacity
+        HILOG(kInfo, "Promoting buffer of blob {} of score {} "
+              "from tgt={} tgt_score={} to tgt={} tgt_score={}",
+              blob_info.blob_id_, blob_info.score_,
+              target.id_, target.score_,
+              cmp_tgt.id_, cmp_tgt.score_);
+      }
+    }
+    return target_map_[cmp_tgt.id_];
+  }
+
+  /** Time since the blob mdm started, used to order score refreshes */
+  double GetIndexTime(hshm::Timepoint &time) {
+    return start_time_.GetSecFromStart(time);
+  }
+
+  /** Schedule a score refresh for a blob that was just accessed */
+  void MarkAccessed(BlobInfo &blob_info, RunContext &rctx) {
+    score_index_[rctx.lane_id_].Schedule(
+        blob_info, GetIndexTime(blob_info.last_access_));
+  }
+
+  /**
+   * Refresh a blob's score, move it between the score histograms of its
+   * targets, and queue it if a buffer should change tier. Demotions are
+   * queued whatever the capacity of the source, which FlushData checks
+   * when it pops them. The refresh is rescheduled while the score is
+   * still decaying.
+   * */
+  void RescoreBlob(ScoreIndex &score_index, BlobInfo &blob_info,
+                   hshm::Timepoint &now, TaskNode &task_node) {
+    BorgInfo &borg = HERMES_CONF->server_config_.borg_;
+    float score = MakeScore(blob_info, now);
     for (BufferInfo &buf : blob_info.buffers_) {
       TargetInfo &target = *target_map_[buf.tid_];
       Histogram &hist = target.monitor_task_->score_hist_;
-      u32 percentile = hist.GetPercentile(score);
-      u32 precentile_lt = hist.GetPercentileLT(score);
-      size_t rem_cap = target.monitor_task_->rem_cap_;
-      size_t max_cap = target.max_cap_;
-      float borg_cap_min = target.borg_min_thresh_;
-      float borg_cap_max = target.borg_max_thresh_;
-      // float min_score = hist.GetQuantile(0);
       // Update the target score
       target.score_ = target.bw_score_;
       // Update blob score
-      if constexpr(UPDATE_SCORE) {
-        u32 bin_orig = hist.GetBin(blob_info.score_);
-        u32 bin_new = hist.GetBin(score);
-        if (bin_orig != bin_new) {
-          target.AsyncUpdateScore(task_node + 1,
-                                  blob_info.score_, score);
-        }
+      u32 bin_orig = hist.GetBin(blob_info.score_);
+      u32 bin_new = hist.GetBin(score);
+      if (bin_orig != bin_new) {
+        target.AsyncUpdateScore(task_node + 1, blob_info.score_, score);
       }
-      // Determine if the blob should be reorganized
-      // Get the target with minimum difference in score to this blob
-      if (abs(target.score_ - score) < .1) {
-        continue;
-      }
-      const bdev::Client &cmp_tgt = FindNearestTarget(score);
-      if (cmp_tgt.id_ == target.id_) {
-        continue;
-      }
-      if (cmp_tgt.score_ <= target.score_) {
-        // Demote if we have sufficiently low capacity
-        if (rem_cap < max_cap * borg_cap_min) {
-          HILOG(kInfo, "Demoting blob {} of score {} from tgt={} tgt_score={} to tgt={} tgt_score={}",
-                blob_info.blob_id_, blob_info.score_,
-                target.id_, target.score_,
-                cmp_tgt.id_, cmp_tgt.score_);
-          return true;
-        }
-      } else {
-        // Promote if the guy above us has sufficiently high capacity
-        float cmp_rem_cap = cmp_tgt.monitor_task_->rem_cap_;
-        if (cmp_rem_cap > blob_info.blob_size_) {
-          HILOG(kInfo, "Promoting blob {} of score {} from tgt={} tgt_score={} to tgt={} tgt_score={}",
-                blob_info.blob_id_, blob_info.score_,
-                target.id_, target.score_,
-                cmp_tgt.id_, cmp_tgt.score_);
-          return true;
-        }
+    }
+    blob_info.score_ = score;
+    blob_info.access_freq_ = 0;
+    blob_info.reorg_version_ += 1;
+    for (BufferInfo &buf : blob_info.buffers_) {
+      TargetInfo *dst = FindMigrationTarget(blob_info, buf, score, true);
+      if (dst != nullptr) {
+        // TargetInfo pointers refer to elements of targets_
+        TargetInfo *src = target_map_[buf.tid_];
+        bool promote = dst->score_ > src->score_;
+        size_t tgt_idx = (promote ? dst : src) - targets_.data();
+        score_index.PushReorg(tgt_idx, promote, blob_info);
+        break;
       }
     }
-    return false;
+    float time_diff = blob_info.last_access_.GetSecFromStart(now);
+    float rec_diff = borg.recency_max_ - borg.recency_min_;
+    if (time_diff < borg.recency_max_ && rec_diff > 0) {
+      score_index.Schedule(blob_info,
+                           GetIndexTime(now) + rec_diff / kScoreSteps);
+    }
   }
 
   /**
@@ -256,338 +849,1180 @@ class Server : public TaskLib {
    * reorganize blobs
    * */
   struct FlushInfo {
-    BlobInfo *blob_info_;
+    BlobId blob_id_;  /**< The blob may be destroyed while flushing */
+    TagId tag_id_;
+    hshm::charbuf name_;
+    LPointer<GetBlobTask> get_task_;
     LPointer<data_stager::StageOutTask> stage_task_;
+    hipc::Pointer data_;
+    size_t data_size_;
     size_t mod_count_;
   };
   void FlushData(FlushDataTask *task, RunContext &rctx) {
     hshm::Timepoint now;
     now.Now();
-    // Get the blob info data structure
+    double now_sec = GetIndexTime(now);
     BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
-    std::vector<FlushInfo> stage_tasks;
-    stage_tasks.reserve(256);
-    for (auto &it : blob_map) {
-      BlobInfo &blob_info = it.second;
-      // Update blob scores
-      float new_score = MakeScore(blob_info, now);
-      blob_info.score_ = new_score;
-      if (ShouldReorganize<true>(blob_info, new_score, task->task_node_)) {
-        Context ctx;
-        LPointer<ReorganizeBlobTask> reorg_task =
-            blob_mdm_.AsyncReorganizeBlob(task->task_node_ + 1,
-                                          blob_info.tag_id_,
-                                          hshm::charbuf(""),
-                                          blob_info.blob_id_,
-                                          new_score, false, ctx,
-                                          TASK_LOW_LATENCY);
-        reorg_task->Wait<TASK_YIELD_CO>(task);
-        HRUN_CLIENT->DelTask(reorg_task);
+    ScoreIndex &score_index = score_index_[rctx.lane_id_];
+    if (!lost_blobs_.empty()) {
+      ForgetLostBlobs(task);
+    }
+
+    // Refresh the scores that may have changed since the last period
+    ScoreIndex::RescoreEntry rescore;
+    for (size_t i = 0; i < kMaxScoreBatch &&
+         score_index.PopDue(now_sec, rescore); ++i) {
+      auto it = blob_map.find(rescore.blob_id_);
+      if (it == blob_map.end() ||
+          it->second.rescore_time_ != rescore.time_) {
+        continue;
       }
-      blob_info.access_freq_ = 0;
+      BlobInfo &blob_info = it->second;
+      blob_info.rescore_time_ = -1;
+      RescoreBlob(score_index, blob_info, now, task->task_node_);
+    }
+
+    // Reorganize the best candidates for each target
+    size_t max_reorgs = HERMES_CONF->server_config_.borg_.migrate_max_inflight_;
+    std::vector<LPointer<ReorganizeBlobTask>> reorg_tasks;
+    auto is_live = [&blob_map](const ScoreIndex::ReorgEntry &reorg) {
+      auto it = blob_map.find(reorg.blob_id_);
+      return it != blob_map.end() &&
+          it->second.reorg_version_ == reorg.version_;
+    };
+    for (size_t tgt_idx = 0; tgt_idx < targets_.size(); ++tgt_idx) {
+      for (bool promote : {true, false}) {
+        // Cold blobs wait in the queue until their target runs low
+        if (!promote && !IsLowOnCapacity(targets_[tgt_idx])) {
+          // A blob has at most one live entry, so the rest are stale
+          if (score_index.DemoteCount(tgt_idx) > blob_map.size()) {
+            score_index.PruneDemote(tgt_idx, is_live);
+          }
+          continue;
+        }
+        ScoreIndex::ReorgEntry reorg;
+        size_t count = 0;
+        while (count < max_reorgs &&
+               score_index.PopReorg(tgt_idx, promote, reorg)) {
+          if (!is_live(reorg)) {
+            continue;
+          }
+          BlobInfo &blob_info = blob_map.find(reorg.blob_id_)->second;
+          blob_info.reorg_version_ += 1;
+          Context ctx;
+          reorg_tasks.emplace_back(
+              blob_mdm_.AsyncReorganizeBlob(task->task_node_ + 1,
+                                            blob_info.tag_id_,
+                                            hshm::charbuf(""),
+                                            blob_info.blob_id_,
+                                            blob_info.score_, false, ctx,
+                                            TASK_LOW_LATENCY));
+          ++count;
+        }
+      }
+    }
+    for (LPointer<ReorganizeBlobTask> &reorg_task : reorg_tasks) {
+      reorg_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(reorg_task);
+    }
+
+    // Send the bucket size changes of lanes that have gone idle
+    if (HERMES_SERVER_CONF.mdm_.size_flush_ms_ > 0) {
+      LPointer<FlushSizeDeltasTask> size_task =
+          blob_mdm_.AsyncFlushSizeDeltas(task->task_node_ + 1,
+                                         DomainId::GetLocal(),
+                                         TagId::GetNull());
+      size_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(size_task);
+    }
 
-      // Flush data
-      FlushInfo flush_info;
-      flush_info.blob_info_ = &blob_info;
-      flush_info.mod_count_ = blob_info.mod_count_;
-      if (blob_info.last_flush_ > 0 &&
-          flush_info.mod_count_ > blob_info.last_flush_) {
+    // Flush the blobs that were dirty when this period began
+    FlushDirtyBlobs(task, rctx);
+  }
+
+  /**
+   * Flush dirty blobs as a pipeline. Reads from the tiers, stage-outs and
+   * buffer frees of different blobs overlap, with at most flush_concurrency
+   * blobs and flush_max_bytes bytes in flight.
+   * */
+  void FlushDirtyBlobs(FlushDataTask *task, RunContext &rctx) {
+    ServerConfig &server = HERMES_CONF->server_config_;
+    size_t max_blobs = std::max<size_t>(server.borg_.flush_concurrency_, 1);
+    size_t max_bytes = server.borg_.flush_max_bytes_;
+    BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
+    DirtyBlobList &dirty_list = dirty_list_[rctx.lane_id_];
+    FlushStats &stats = flush_stats_[rctx.lane_id_];
+    size_t num_dirty = std::min(dirty_list.size(), kMaxFlushBatch);
+    size_t period_bytes = 0;
+    std::list<FlushInfo> flushing;
+    hshm::Timer t;
+    t.Resume();
+    while (num_dirty > 0 || !flushing.empty()) {
+      // Start reading blobs until the window is full
+      while (num_dirty > 0 && !dirty_list.empty() &&
+             stats.inflight_blobs_ < max_blobs &&
+             (stats.inflight_blobs_ == 0 ||
+              stats.inflight_bytes_ + dirty_list.head_->blob_size_ <=
+                  max_bytes)) {
+        --num_dirty;
+        BlobInfo &blob_info = *dirty_list.Pop();
+        if (!blob_info.NeedsFlush()) {
+          continue;
+        }
+        FlushInfo flush_info;
+        flush_info.blob_id_ = blob_info.blob_id_;
+        flush_info.tag_id_ = blob_info.tag_id_;
+        flush_info.name_ = blob_info.name_;
+        flush_info.mod_count_ = blob_info.mod_count_;
+        flush_info.data_size_ = blob_info.blob_size_;
+        stats.inflight_blobs_ += 1;
+        stats.inflight_bytes_ += flush_info.data_size_;
         HILOG(kDebug, "Flushing blob {} (mod_count={}, last_flush={})",
               blob_info.blob_id_, flush_info.mod_count_, blob_info.last_flush_);
         LPointer<char> data = HRUN_CLIENT->AllocateBufferServer<TASK_YIELD_CO>(
-            blob_info.blob_size_, task);
-        LPointer<GetBlobTask> get_blob =
+            flush_info.data_size_, task);
+        if (blob_map.find(flush_info.blob_id_) == blob_map.end()) {
+          // Destroyed while allocating: GetBlob would recreate it
+          HRUN_CLIENT->FreeBuffer(data);
+          stats.inflight_blobs_ -= 1;
+          stats.inflight_bytes_ -= flush_info.data_size_;
+          continue;
+        }
+        flush_info.data_ = data.shm_;
+        flush_info.get_task_ =
             blob_mdm_.AsyncGetBlob(task->task_node_ + 1,
-                                   blob_info.tag_id_,
-                                   blob_info.name_,
-                                   blob_info.blob_id_,
-                                   0, blob_info.blob_size_,
-                                   data.shm_);
-        get_blob->Wait<TASK_YIELD_CO>(task);
-        HRUN_CLIENT->DelTask(get_blob);
-        flush_info.stage_task_ =
-          stager_mdm_.AsyncStageOut(task->task_node_ + 1,
-                                    blob_info.tag_id_,
-                                    blob_info.name_,
-                                    data.shm_, blob_info.blob_size_,
-                                    TASK_DATA_OWNER);
-        stage_tasks.emplace_back(flush_info);
-      }
-      if (stage_tasks.size() == 256) {
-        break;
+                                   flush_info.tag_id_,
+                                   flush_info.name_,
+                                   flush_info.blob_id_,
+                                   0, flush_info.data_size_,
+                                   data.shm_, Context(),
+                                   HERMES_BLOB_BACKGROUND);
+        flushing.emplace_back(flush_info);
+      }
+      if (dirty_list.empty()) {
+        num_dirty = 0;
       }
-    }
 
-    for (FlushInfo &flush_info : stage_tasks) {
-      BlobInfo &blob_info = *flush_info.blob_info_;
-      flush_info.stage_task_->Wait<TASK_YIELD_CO>(task);
-      blob_info.last_flush_ = flush_info.mod_count_;
-      HRUN_CLIENT->DelTask(flush_info.stage_task_);
+      // Stage out blobs that were read and retire finished stage-outs
+      bool progress = false;
+      for (auto it = flushing.begin(); it != flushing.end();) {
+        FlushInfo &flush_info = *it;
+        if (flush_info.get_task_.ptr_ != nullptr) {
+          if (flush_info.get_task_->IsComplete()) {
+            HRUN_CLIENT->DelTask(flush_info.get_task_);
+            flush_info.get_task_.ptr_ = nullptr;
+            progress = true;
+            if (blob_map.find(flush_info.blob_id_) == blob_map.end()) {
+              // Destroyed while it was read: nothing to stage out
+              HRUN_CLIENT->FreeBuffer(flush_info.data_);
+              stats.inflight_blobs_ -= 1;
+              stats.inflight_bytes_ -= flush_info.data_size_;
+              it = flushing.erase(it);
+              continue;
+            }
+            flush_info.stage_task_ =
+                stager_mdm_.AsyncStageOut(task->task_node_ + 1,
+                                          flush_info.tag_id_,
+                                          flush_info.name_,
+                                          flush_info.data_,
+                                          flush_info.data_size_,
+                                          TASK_DATA_OWNER);
+          }
+          ++it;
+          continue;
+        }
+        if (!flush_info.stage_task_->IsComplete()) {
+          ++it;
+          continue;
+        }
+        auto blob_it = blob_map.find(flush_info.blob_id_);
+        if (blob_it != blob_map.end()) {
+          blob_it->second.last_flush_ = flush_info.mod_count_;
+        }
+        HRUN_CLIENT->DelTask(flush_info.stage_task_);
+        stats.inflight_blobs_ -= 1;
+        stats.inflight_bytes_ -= flush_info.data_size_;
+        stats.flushed_blobs_ += 1;
+        stats.flushed_bytes_ += flush_info.data_size_;
+        period_bytes += flush_info.data_size_;
+        it = flushing.erase(it);
+        progress = true;
+      }
+      if (!progress && !flushing.empty()) {
+        task->Yield<TASK_YIELD_CO>();
+      }
+    }
+    t.Pause();
+    if (period_bytes > 0) {
+      stats.mbps_ = period_bytes / t.GetUsec();
     }
   }
   void MonitorFlushData(u32 mode, FlushDataTask *task, RunContext &rctx) {
-    BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
-    for (auto &it : blob_map) {
-      BlobInfo &blob_info = it.second;
-      if (blob_info.last_flush_ > 0 &&
-          blob_info.mod_count_ > blob_info.last_flush_) {
-        rctx.flush_->count_ += 1;
-        return;
-      }
+    if (!dirty_list_[rctx.lane_id_].empty() ||
+        flush_stats_[rctx.lane_id_].inflight_blobs_ > 0) {
+      rctx.flush_->count_ += 1;
+    }
+  }
+
+  /** Queue a blob for flushing if it was modified since its last flush */
+  void MarkDirty(BlobInfo &blob_info, RunContext &rctx) {
+    if (blob_info.NeedsFlush()) {
+      dirty_list_[rctx.lane_id_].Push(blob_info);
     }
   }
 
   /**
-   * Create a blob's metadata
+   * Prepare a blob for a put. Stages the blob in, releases its buffers
+   * if it is being replaced, and computes the additional space needed.
+   * Returns the change in the size of the bucket.
    * */
-  void PutBlob(PutBlobTask *task, RunContext &rctx) {
-    // Get the blob info data structure
-    hshm::charbuf blob_name = hshm::to_charbuf(*task->blob_name_);
-    if (task->blob_id_.IsNull()) {
-      task->blob_id_ = GetOrCreateBlobId(task->tag_id_, task->lane_hash_,
-                                         blob_name, rctx, task->flags_);
+  ssize_t PutBlobPrepare(BlobInfo &blob_info, const TagId &tag_id,
+                         size_t blob_off, size_t data_size,
+                         float score, bitfield32_t flags, Codec codec,
+                         Task *task, size_t &size_diff) {
+    blob_info.score_ = score;
+    blob_info.user_score_ = score;
+    if (codec != Codec::kDefault) {
+      blob_info.codec_ = codec;
     }
-    HILOG(kDebug, "Beginning PUT for (hash: {})",
-          std::hash<hshm::charbuf>{}(blob_name));
-    BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
-    BlobInfo &blob_info = blob_map[task->blob_id_];
-    blob_info.score_ = task->score_;
-    blob_info.user_score_ = task->score_;
 
     // Stage Blob
-    if (task->flags_.Any(HERMES_SHOULD_STAGE) && blob_info.last_flush_ == 0) {
+    if (flags.Any(HERMES_SHOULD_STAGE) && blob_info.last_flush_ == 0) {
       HILOG(kDebug, "This file has not yet been flushed");
       blob_info.last_flush_ = 1;
       LPointer<data_stager::StageInTask> stage_task =
           stager_mdm_.AsyncStageIn(task->task_node_ + 1,
-                                   task->tag_id_,
+                                   tag_id,
                                    blob_info.name_,
-                                   task->score_, 0);
+                                   score, 0);
       stage_task->Wait<TASK_YIELD_CO>(task);
       blob_info.mod_count_ = 1;
       HRUN_CLIENT->DelTask(stage_task);
     }
-    if (task->flags_.Any(HERMES_SHOULD_STAGE)) {
+    if (flags.Any(HERMES_SHOULD_STAGE)) {
       HILOG(kDebug, "This is marked as a file: {} {}",
             blob_info.mod_count_, blob_info.last_flush_);
     }
     ssize_t bkt_size_diff = 0;
-    if (task->flags_.Any(HERMES_BLOB_REPLACE)) {
+    if (flags.Any(HERMES_BLOB_REPLACE)) {
       bkt_size_diff -= blob_info.blob_size_;
-      PutBlobFreeBuffersPhase(blob_info, task, rctx);
+      PutBlobFreeBuffersPhase(blob_info, task);
     }
 
     // Determine amount of additional buffering space needed
-    size_t needed_space = task->blob_off_ + task->data_size_;
-    size_t size_diff = 0;
+    size_t needed_space = blob_off + data_size;
+    size_diff = 0;
     if (needed_space > blob_info.max_blob_size_) {
       size_diff = needed_space - blob_info.max_blob_size_;
     }
-    size_t min_blob_size = task->blob_off_ + task->data_size_;
+    size_t min_blob_size = blob_off + data_size;
     if (min_blob_size > blob_info.blob_size_) {
-      blob_info.blob_size_ = task->blob_off_ + task->data_size_;
+      blob_info.blob_size_ = blob_off + data_size;
     }
     bkt_size_diff += (ssize_t)size_diff;
     HILOG(kDebug, "The size diff is {} bytes (bkt diff {})", size_diff, bkt_size_diff)
+    return bkt_size_diff;
+  }
 
+  /**
+   * Allocate each of \a sizes bytes into the matching entry of \a new_bufs.
+   * The DPE is run once over the set of sizes and the allocations
+   * for each placement level are issued to the targets together.
+   * */
+  void AllocateBuffers(std::vector<size_t> &sizes, float score,
+                       std::vector<std::vector<BufferInfo>> &new_bufs,
+                       Task *task) {
     // Use DPE
     std::vector<PlacementSchema> schema_vec;
-    if (size_diff > 0) {
-      Context ctx;
-      auto *dpe = DpeFactory::Get(ctx.dpe_);
-      ctx.blob_score_ = task->score_;
-      dpe->Placement({size_diff}, targets_, ctx, schema_vec);
+    Context ctx;
+    auto *dpe = DpeFactory::Get(ctx.dpe_);
+    ctx.blob_score_ = score;
+    dpe->Placement(sizes, targets_, ctx, schema_vec);
+    schema_vec.resize(sizes.size());
+    size_t num_levels = 0;
+    for (size_t i = 0; i < schema_vec.size(); ++i) {
+      PlacementSchema &schema = schema_vec[i];
+      size_t fallback_size = schema.plcmnts_.empty() ? sizes[i] : 0;
+      schema.plcmnts_.emplace_back(fallback_size, fallback_target_->id_);
+      num_levels = std::max(num_levels, schema.plcmnts_.size());
     }
 
     // Allocate blob buffers
-    for (PlacementSchema &schema : schema_vec) {
-      schema.plcmnts_.emplace_back(0, fallback_target_->id_);
-      for (size_t sub_idx = 0; sub_idx < schema.plcmnts_.size(); ++sub_idx) {
-        SubPlacement &placement = schema.plcmnts_[sub_idx];
+    new_bufs.resize(sizes.size());
+    std::vector<LPointer<bdev::AllocateTask>> alloc_tasks(sizes.size());
+    for (size_t sub_idx = 0; sub_idx < num_levels; ++sub_idx) {
+      for (size_t i = 0; i < sizes.size(); ++i) {
+        std::vector<SubPlacement> &plcmnts = schema_vec[i].plcmnts_;
+        alloc_tasks[i].ptr_ = nullptr;
+        if (sub_idx >= plcmnts.size() || plcmnts[sub_idx].size_ == 0) {
+          continue;
+        }
+        SubPlacement &placement = plcmnts[sub_idx];
         TargetInfo &bdev = *target_map_[placement.tid_];
-        LPointer<bdev::AllocateTask> alloc_task =
-            bdev.AsyncAllocate(task->task_node_ + 1,
-                               blob_info.score_,
-                               placement.size_,
-                               blob_info.buffers_);
+        alloc_tasks[i] = bdev.AsyncAllocate(task->task_node_ + 1,
+                                            score,
+                                            placement.size_,
+                                            new_bufs[i]);
+      }
+      for (size_t i = 0; i < sizes.size(); ++i) {
+        LPointer<bdev::AllocateTask> &alloc_task = alloc_tasks[i];
+        if (alloc_task.ptr_ == nullptr) {
+          continue;
+        }
         alloc_task->Wait<TASK_YIELD_CO>(task);
-//        HILOG(kInfo, "(node {}) Placing {}/{} bytes in target {} of bw {}",
-//              HRUN_CLIENT->node_id_,
-//              alloc_task->alloc_size_, task->data_size_,
-//              placement.tid_, bdev.bandwidth_)
-        if (alloc_task->alloc_size_ < alloc_task->size_) {
-          SubPlacement &next_placement = schema.plcmnts_[sub_idx + 1];
+        std::vector<SubPlacement> &plcmnts = schema_vec[i].plcmnts_;
+        if (alloc_task->alloc_size_ < alloc_task->size_ &&
+            sub_idx + 1 < plcmnts.size()) {
+          SubPlacement &next_placement = plcmnts[sub_idx + 1];
           size_t diff = alloc_task->size_ - alloc_task->alloc_size_;
           next_placement.size_ += diff;
         }
-        // bdev.monitor_task_->rem_cap_ -= alloc_task->alloc_size_;
         HRUN_CLIENT->DelTask(alloc_task);
       }
     }
+  }
 
-    // Place blob in buffers
+  /**
+   * Allocate \a sizes bytes of additional space for \a blobs,
+   * all of which have the score \a score.
+   * */
+  void PutBlobAllocate(std::vector<BlobInfo*> &blobs,
+                       std::vector<size_t> &sizes,
+                       float score, Task *task) {
+    if (blobs.size() == 0) {
+      return;
+    }
+    std::vector<std::vector<BufferInfo>> new_bufs;
+    AllocateBuffers(sizes, score, new_bufs, task);
+
+    // Attach the buffers to the blobs
+    for (size_t i = 0; i < blobs.size(); ++i) {
+      BlobInfo &blob_info = *blobs[i];
+      blob_info.buffers_.insert(blob_info.buffers_.end(),
+                                new_bufs[i].begin(), new_bufs[i].end());
+      blob_info.max_blob_size_ = blob_info.UpdateExtents();
+    }
+  }
+
+  /**
+   * Allocate \a size bytes on \a target, or on the fallback target if
+   * \a target is full. Returns the target, or nullptr if neither has space.
+   * */
+  TargetInfo* AllocateOrFallback(TargetInfo *target, size_t size, float score,
+                                 std::vector<BufferInfo> &buffers, Task *task) {
+    for (TargetInfo *tgt : {target, fallback_target_}) {
+      buffers.clear();
+      LPointer<bdev::AllocateTask> alloc_task =
+          tgt->AsyncAllocate(task->task_node_ + 1, score, size, buffers);
+      alloc_task->Wait<TASK_YIELD_CO>(task);
+      bool success = alloc_task->alloc_size_ >= size;
+      HRUN_CLIENT->DelTask(alloc_task);
+      if (success) {
+        return tgt;
+      }
+      tgt->AsyncFree(task->task_node_ + 1, score, std::move(buffers), true);
+    }
+    return nullptr;
+  }
+
+  /**
+   * Allocate \a size bytes wherever the DPE places them. Returns false,
+   * with \a buffers released, if the targets can't hold all of it.
+   * */
+  bool AllocateAnywhere(size_t size, float score,
+                        std::vector<BufferInfo> &buffers, Task *task) {
+    std::vector<size_t> sizes = {size};
+    std::vector<std::vector<BufferInfo>> new_bufs;
+    AllocateBuffers(sizes, score, new_bufs, task);
+    buffers = std::move(new_bufs[0]);
+    size_t alloc_size = 0;
+    for (BufferInfo &buf : buffers) {
+      alloc_size += buf.t_size_;
+    }
+    if (alloc_size >= size) {
+      return true;
+    }
+    for (BufferInfo &buf : buffers) {
+      FreeBuffer(buf, score, task);
+    }
+    buffers.clear();
+    return false;
+  }
+
+  /** Write \a size bytes of \a data across \a buffers, trimming the last */
+  void WriteBuffers(std::vector<BufferInfo> &buffers,
+                    char *data, size_t size, u32 task_flags, Task *task,
+                    std::vector<LPointer<bdev::WriteTask>> &write_tasks) {
+    size_t off = 0;
+    for (BufferInfo &buf : buffers) {
+      buf.t_size_ = std::min(buf.t_size_, size - off);
+      if (buf.t_size_ == 0) {
+        continue;
+      }
+      TargetInfo &target = *target_map_[buf.tid_];
+      write_tasks.emplace_back(
+          target.AsyncWrite(task->task_node_ + 1, data + off,
+                            buf.t_off_, buf.t_size_, task_flags));
+      off += buf.t_size_;
+    }
+  }
+
+  /**
+   * Drop a blob's reference to \a buf. Returns whether the slab should be
+   * freed, which is false while other blobs share it.
+   * */
+  bool ReleaseBuffer(const BufferInfo &buf) {
+    return buf.fp_ == 0 || dedup_index_.Release(buf.fp_);
+  }
+
+  /** Free a buffer a blob no longer references */
+  void FreeBuffer(const BufferInfo &buf, float score, Task *task) {
+    if (!ReleaseBuffer(buf)) {
+      return;
+    }
+    TargetInfo &target = *target_map_[buf.tid_];
+    std::vector<BufferInfo> buf_vec = {buf};
+    target.AsyncFree(task->task_node_ + 1, score, std::move(buf_vec), true);
+  }
+
+  /**
+   * Give the blob private, uncompressed copies of the buffers a put of
+   * [blob_off, blob_off + data_size) overlaps, so the new data can be
+   * written in place. Compressed buffers are only created by the BORG
+   * for cold blobs and shared buffers by dedup puts, so this is rare.
+   * A copy that doesn't fit on the buffer's target or the fallback target
+   * is placed by the DPE like any other allocation. The caller holds
+   * BlobInfo::BeginWrite, so a reorganize won't swap over these buffers.
+   * */
+  void PutBlobUnshare(BlobInfo &blob_info,
+                      size_t blob_off, size_t data_size, Task *task) {
+    std::vector<BufferInfo> unshare;
+    size_t blob_right = blob_off + data_size;
+    size_t buf_idx = blob_info.FindBuffer(blob_off);
+    for (; buf_idx < blob_info.buffers_.size(); ++buf_idx) {
+      if (blob_info.GetBufferOffset(buf_idx) >= blob_right) {
+        break;
+      }
+      BufferInfo &buf = blob_info.buffers_[buf_idx];
+      if (buf.IsCompressed() || buf.fp_ != 0) {
+        unshare.emplace_back(buf);
+      }
+    }
+    for (BufferInfo &old_buf : unshare) {
+      auto find_buf = [&blob_info, &old_buf]() {
+        return std::find_if(
+            blob_info.buffers_.begin(), blob_info.buffers_.end(),
+            [&old_buf](const BufferInfo &buf) {
+              return buf.tid_ == old_buf.tid_ && buf.t_off_ == old_buf.t_off_;
+            });
+      };
+      // A slab no other blob references can be written in place
+      if (!old_buf.IsCompressed() && dedup_index_.TryUnshare(old_buf.fp_)) {
+        auto it = find_buf();
+        if (it != blob_info.buffers_.end()) {
+          it->fp_ = 0;
+        }
+        continue;
+      }
+
+      // Read and decompress the buffer
+      TargetInfo &src = *target_map_[old_buf.tid_];
+      size_t stored_size = old_buf.GetTargetSize();
+      size_t data_off = old_buf.IsCompressed() ? stored_size : 0;
+      LPointer<char> data = HRUN_CLIENT->AllocateBufferServer<TASK_YIELD_CO>(
+          data_off + old_buf.t_size_, task);
+      char *plain = data.ptr_ + data_off;
+      LPointer<bdev::ReadTask> read_task = src.AsyncRead(
+          task->task_node_ + 1, data.ptr_, old_buf.t_off_, stored_size);
+      read_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(read_task);
+      if (old_buf.IsCompressed() &&
+          !Compressor::Decompress(old_buf.codec_, data.ptr_, old_buf.c_size_,
+                                  plain, old_buf.t_size_)) {
+        // The put still lands, but the rest of the buffer is lost
+        HELOG(kError, "Failed to decompress a buffer of {}, zeroing it",
+              blob_info.name_.str());
+        memset(plain, 0, old_buf.t_size_);
+      }
+
+      // Store a private copy, preferably on the same target
+      std::vector<BufferInfo> new_bufs;
+      if (!AllocateOrFallback(&src, old_buf.t_size_, blob_info.score_,
+                              new_bufs, task) &&
+          !AllocateAnywhere(old_buf.t_size_, blob_info.score_,
+                            new_bufs, task)) {
+        HELOG(kError, "No space to copy a buffer of {}",
+              blob_info.name_.str());
+        HRUN_CLIENT->FreeBuffer(data);
+        continue;
+      }
+      std::vector<LPointer<bdev::WriteTask>> write_tasks;
+      WriteBuffers(new_bufs, plain, old_buf.t_size_, 0, task, write_tasks);
+      for (LPointer<bdev::WriteTask> &write_task : write_tasks) {
+        write_task->Wait<TASK_YIELD_CO>(task);
+        HRUN_CLIENT->DelTask(write_task);
+      }
+      HRUN_CLIENT->FreeBuffer(data);
+
+      // Swap the buffers, unless another task already did
+      auto it = find_buf();
+      if (it == blob_info.buffers_.end()) {
+        for (BufferInfo &new_buf : new_bufs) {
+          FreeBuffer(new_buf, blob_info.score_, task);
+        }
+        continue;
+      }
+      it = blob_info.buffers_.erase(it);
+      blob_info.buffers_.insert(it, new_bufs.begin(), new_bufs.end());
+      blob_info.RebuildExtents();
+      FreeBuffer(old_buf, blob_info.score_, task);
+    }
+  }
+
+  /** Whether a put can place its data in slabs shared with other blobs */
+  bool CanDedup(BlobInfo &blob_info, size_t blob_off, bitfield32_t flags) {
+    return flags.Any(HERMES_BLOB_DEDUP) && blob_off == 0 &&
+        blob_info.buffers_.empty();
+  }
+
+  /**
+   * Place a new blob's data in slabs shared with the blobs holding the
+   * same pages. Pages are fingerprinted and looked up in the node's dedup
+   * index, and each match is compared against the stored slab before it
+   * is referenced. The remaining pages are written to their own slabs,
+   * which are then indexed.
+   * */
+  void PutBlobDedup(BlobInfo &blob_info, char *data, size_t data_size,
+                    float score, Task *task) {
+    size_t num_pages = (data_size + kDedupPageSize - 1) / kDedupPageSize;
+    std::vector<u64> fps(num_pages);
+    std::vector<BufferInfo> shared(num_pages);
+    std::vector<bool> is_shared(num_pages, false);
+    auto page_size = [data_size](size_t i) {
+      return std::min(kDedupPageSize, data_size - i * kDedupPageSize);
+    };
+
+    // Reference the slabs that may hold the pages already
+    size_t match_size = 0;
+    for (size_t i = 0; i < num_pages; ++i) {
+      fps[i] = DedupIndex::Fingerprint(data + i * kDedupPageSize,
+                                       page_size(i));
+      is_shared[i] = dedup_index_.Acquire(fps[i], page_size(i), shared[i]);
+      match_size += is_shared[i] ? page_size(i) : 0;
+    }
+
+    // Compare the matches, so a fingerprint collision can't corrupt the blob
+    if (match_size > 0) {
+      LPointer<char> stored =
+          HRUN_CLIENT->AllocateBufferServer<TASK_YIELD_CO>(match_size, task);
+      std::vector<LPointer<bdev::ReadTask>> read_tasks;
+      size_t stored_off = 0;
+      for (size_t i = 0; i < num_pages; ++i) {
+        if (!is_shared[i]) {
+          continue;
+        }
+        TargetInfo &target = *target_map_[shared[i].tid_];
+        read_tasks.emplace_back(target.AsyncRead(
+            task->task_node_ + 1, stored.ptr_ + stored_off,
+            shared[i].t_off_, page_size(i)));
+        stored_off += page_size(i);
+      }
+      for (LPointer<bdev::ReadTask> &read_task : read_tasks) {
+        read_task->Wait<TASK_YIELD_CO>(task);
+        HRUN_CLIENT->DelTask(read_task);
+      }
+      stored_off = 0;
+      for (size_t i = 0; i < num_pages; ++i) {
+        if (!is_shared[i]) {
+          continue;
+        }
+        if (memcmp(stored.ptr_ + stored_off,
+                   data + i * kDedupPageSize, page_size(i)) != 0) {
+          FreeBuffer(shared[i], score, task);
+          is_shared[i] = false;
+        }
+        stored_off += page_size(i);
+      }
+      HRUN_CLIENT->FreeBuffer(stored);
+    }
+
+    // Write the other pages to new slabs
+    std::vector<size_t> new_pages;
+    std::vector<size_t> sizes;
+    for (size_t i = 0; i < num_pages; ++i) {
+      if (!is_shared[i]) {
+        new_pages.emplace_back(i);
+        sizes.emplace_back(page_size(i));
+      }
+    }
+    std::vector<std::vector<BufferInfo>> new_bufs;
+    if (!new_pages.empty()) {
+      AllocateBuffers(sizes, score, new_bufs, task);
+    }
     std::vector<LPointer<bdev::WriteTask>> write_tasks;
-    write_tasks.reserve(blob_info.buffers_.size());
-    size_t blob_off = task->blob_off_, buf_off = 0;
-    size_t buf_left = 0, buf_right = 0;
-    size_t blob_right = task->blob_off_ + task->data_size_;
-    char *blob_buf = HRUN_CLIENT->GetDataPointer(task->data_);
+    for (size_t j = 0; j < new_pages.size(); ++j) {
+      WriteBuffers(new_bufs[j], data + new_pages[j] * kDedupPageSize,
+                   sizes[j], 0, task, write_tasks);
+    }
+    for (LPointer<bdev::WriteTask> &write_task : write_tasks) {
+      write_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(write_task);
+    }
+
+    // Index the new pages that fit in one slab and attach all pages
+    size_t new_idx = 0;
+    for (size_t i = 0; i < num_pages; ++i) {
+      if (is_shared[i]) {
+        blob_info.buffers_.emplace_back(shared[i]);
+        continue;
+      }
+      std::vector<BufferInfo> &bufs = new_bufs[new_idx++];
+      if (bufs.size() == 1) {
+        dedup_index_.Insert(fps[i], bufs[0]);
+      }
+      blob_info.buffers_.insert(blob_info.buffers_.end(),
+                                bufs.begin(), bufs.end());
+    }
+    blob_info.max_blob_size_ = blob_info.UpdateExtents();
+  }
+
+  /**
+   * Add the segments placing \a blob_buf in the blob's buffers to
+   * \a writes, to be issued with WriteSegments.
+   * */
+  void PutBlobWrite(BlobInfo &blob_info,
+                    size_t blob_off, size_t data_size,
+                    char *blob_buf, TARGET_IO_T &writes) {
+    size_t buf_off = 0;
+    size_t blob_right = blob_off + data_size;
     HILOG(kDebug, "Number of buffers {}", blob_info.buffers_.size());
-    bool found_left = false;
-    for (BufferInfo &buf : blob_info.buffers_) {
-      buf_right = buf_left + buf.t_size_;
+    size_t buf_idx = blob_info.FindBuffer(blob_off);
+    for (; buf_idx < blob_info.buffers_.size(); ++buf_idx) {
       if (blob_off >= blob_right) {
         break;
       }
-      if (buf_left <= blob_off && blob_off < buf_right) {
-        found_left = true;
+      BufferInfo &buf = blob_info.buffers_[buf_idx];
+      size_t buf_left = blob_info.GetBufferOffset(buf_idx);
+      size_t buf_right = blob_info.buf_ends_[buf_idx];
+      size_t rel_off = blob_off - buf_left;
+      size_t tgt_off = buf.t_off_ + rel_off;
+      size_t buf_size = buf.t_size_ - rel_off;
+      if (buf_right > blob_right) {
+        buf_size = blob_right - (buf_left + rel_off);
+      }
+      if (buf.IsCompressed() || buf.fp_ != 0) {
+        // No target had space for a private copy of the buffer
+        HELOG(kError, "Dropping write of {} bytes to shared buffer of {}",
+              buf_size, blob_info.name_.str());
+        buf_off += buf_size;
+        blob_off = buf_right;
+        continue;
+      }
+      HILOG(kDebug, "Writing {} bytes at off {} from target {}", buf_size, tgt_off, buf.tid_)
+      writes[buf.tid_].emplace_back(blob_buf + buf_off, tgt_off, buf_size);
+      buf_off += buf_size;
+      blob_off = buf_right;
+    }
+  }
+
+  /**
+   * Issue one vectored write per target of \a writes, so the buffers of
+   * a put that are contiguous on a device become one request.
+   * */
+  void WriteSegments(TARGET_IO_T &writes, Task *task,
+                     std::vector<LPointer<bdev::WriteVTask>> &write_tasks) {
+    for (TARGET_IO_T::value_type &tgt_segs : writes) {
+      TargetInfo &target = *target_map_[tgt_segs.first];
+      write_tasks.emplace_back(
+          target.AsyncWriteV(task->task_node_ + 1,
+                             std::move(tgt_segs.second)));
+    }
+  }
+
+  /** Notify the stager and data operators that a blob was modified */
+  void PutBlobNotify(BlobInfo &blob_info, const TagId &tag_id,
+                     const BlobId &blob_id,
+                     size_t blob_off, size_t data_size,
+                     bitfield32_t flags, Task *task) {
+    if (flags.Any(HERMES_SHOULD_STAGE)) {
+      stager_mdm_.AsyncUpdateSize(task->task_node_ + 1,
+                                  tag_id,
+                                  blob_info.name_,
+                                  blob_off,
+                                  data_size, 0);
+    }
+    if (flags.Any(HERMES_BLOB_DID_CREATE)) {
+      bkt_mdm_.AsyncTagAddBlob(task->task_node_ + 1,
+                               tag_id,
+                               blob_id);
+    }
+    if (flags.Any(HERMES_HAS_DERIVED)) {
+      op_mdm_.AsyncRegisterData(task->task_node_ + 1,
+                                tag_id,
+                                blob_info.name_.str(),
+                                blob_id,
+                                blob_off,
+                                data_size);
+    }
+  }
+
+  /**
+   * Add \a diff to the size of the \a tag_id bucket. The change is held
+   * by the lane and sent with the lane's other changes once per flush
+   * period, unless \a now is set or batching is disabled.
+   * */
+  void UpdateBucketSize(const TagId &tag_id, ssize_t diff,
+                        Task *task, RunContext &rctx, bool now = false) {
+    if (diff == 0) {
+      return;
+    }
+    size_t period_ms = HERMES_SERVER_CONF.mdm_.size_flush_ms_;
+    if (now || period_ms == 0) {
+      bkt_mdm_.AsyncUpdateSize(task->task_node_ + 1, tag_id, diff,
+                               bucket_mdm::UpdateSizeMode::kAdd);
+      return;
+    }
+    SizeDeltas &lane = size_deltas_[rctx.lane_id_];
+    lane.deltas_[tag_id] += diff;
+    hshm::Timepoint cur_time;
+    cur_time.Now();
+    if (lane.last_flush_.GetMsecFromStart(cur_time) >= period_ms) {
+      SendSizeDeltas(lane, TagId::GetNull(), task, nullptr);
+    }
+  }
+
+  /**
+   * Send the size changes \a lane holds for \a tag_id, or for every tag
+   * if it is null. The UpdateSize tasks are fired and forgotten unless
+   * \a update_tasks is given to collect them.
+   * */
+  void SendSizeDeltas(SizeDeltas &lane, const TagId &tag_id, Task *task,
+                      std::vector<LPointer<bucket_mdm::UpdateSizeTask>>
+                      *update_tasks) {
+    u32 task_flags = TASK_LOW_LATENCY;
+    if (!update_tasks) {
+      task_flags |= TASK_FIRE_AND_FORGET;
+    }
+    auto send = [&](const TagId &delta_tag, ssize_t diff) {
+      LPointer<bucket_mdm::UpdateSizeTask> update_task =
+          bkt_mdm_.AsyncUpdateSize(task->task_node_ + 1, delta_tag, diff,
+                                   bucket_mdm::UpdateSizeMode::kAdd,
+                                   task_flags);
+      if (update_tasks) {
+        update_tasks->emplace_back(update_task);
       }
-      if (found_left) {
-        size_t rel_off = blob_off - buf_left;
-        size_t tgt_off = buf.t_off_ + rel_off;
-        size_t buf_size = buf.t_size_ - rel_off;
-        if (buf_right > blob_right) {
-          buf_size = blob_right - (buf_left + rel_off);
+    };
+    if (!tag_id.IsNull()) {
+      auto it = lane.deltas_.find(tag_id);
+      if (it != lane.deltas_.end()) {
+        if (it->second != 0) {
+          send(it->first, it->second);
         }
-        HILOG(kDebug, "Writing {} bytes at off {} from target {}", buf_size, tgt_off, buf.tid_)
-        TargetInfo &target = *target_map_[buf.tid_];
-        LPointer<bdev::WriteTask> write_task =
-            target.AsyncWrite(task->task_node_ + 1,
-                              blob_buf + buf_off,
-                              tgt_off, buf_size);
-        write_tasks.emplace_back(write_task);
+        lane.deltas_.erase(it);
+      }
+      return;
+    }
+    for (auto &delta : lane.deltas_) {
+      if (delta.second != 0) {
+        send(delta.first, delta.second);
+      }
+    }
+    lane.deltas_.clear();
+    lane.last_flush_.Now();
+  }
+
+  /** Send this lane's held bucket size changes and wait for them */
+  void FlushSizeDeltas(FlushSizeDeltasTask *task, RunContext &rctx) {
+    std::vector<LPointer<bucket_mdm::UpdateSizeTask>> update_tasks;
+    SendSizeDeltas(size_deltas_[rctx.lane_id_], task->tag_id_,
+                   task, &update_tasks);
+    for (LPointer<bucket_mdm::UpdateSizeTask> &update_task : update_tasks) {
+      update_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(update_task);
+    }
+    task->SetModuleComplete();
+  }
+  void MonitorFlushSizeDeltas(u32 mode, FlushSizeDeltasTask *task,
+                              RunContext &rctx) {
+  }
+
+  /**
+   * Create a blob's metadata
+   * */
+  void PutBlob(PutBlobTask *task, RunContext &rctx) {
+    // Get the blob info data structure
+    if (task->blob_id_.IsNull()) {
+      task->blob_id_ = GetOrCreateBlobId(task->tag_id_, task->lane_hash_,
+                                         GetNameView(*task->blob_name_),
+                                         rctx, task->flags_);
+    }
+    HILOG(kDebug, "Beginning PUT for (hash: {})", task->lane_hash_);
+    BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
+    BlobInfo &blob_info = blob_map[task->blob_id_];
+    blob_info.BeginWrite();
+    size_t size_diff;
+    ssize_t bkt_size_diff = PutBlobPrepare(
+        blob_info, task->tag_id_, task->blob_off_, task->data_size_,
+        task->score_, task->flags_, static_cast<Codec>(task->codec_),
+        task, size_diff);
+    char *blob_buf = HRUN_CLIENT->GetDataPointer(task->data_);
+    if (CanDedup(blob_info, task->blob_off_, task->flags_)) {
+      PutBlobDedup(blob_info, blob_buf, task->data_size_, task->score_, task);
+    } else {
+      // Allocate blob buffers
+      if (size_diff > 0) {
+        std::vector<BlobInfo*> blobs = {&blob_info};
+        std::vector<size_t> sizes = {size_diff};
+        PutBlobAllocate(blobs, sizes, task->score_, task);
+      }
+
+      // Place blob in buffers
+      TARGET_IO_T writes;
+      std::vector<LPointer<bdev::WriteVTask>> write_tasks;
+      PutBlobUnshare(blob_info, task->blob_off_, task->data_size_, task);
+      PutBlobWrite(blob_info, task->blob_off_, task->data_size_,
+                   blob_buf, writes);
+      WriteSegments(writes, task, write_tasks);
+
+      // Wait for the placements to complete
+      for (LPointer<bdev::WriteVTask> &write_task : write_tasks) {
+        write_task->Wait<TASK_YIELD_CO>(task);
+        HRUN_CLIENT->DelTask(write_task);
+      }
+    }
+    blob_info.EndWrite();
+
+    // Update information
+    if (!task->flags_.Any(HERMES_SHOULD_STAGE)) {
+      UpdateBucketSize(task->tag_id_, bkt_size_diff, task, rctx,
+                       task->flags_.Any(HERMES_BLOB_APPEND));
+    }
+    PutBlobNotify(blob_info, task->tag_id_, task->blob_id_,
+                  task->blob_off_, task->data_size_, task->flags_, task);
+
+    // Free data
+    HILOG(kDebug, "Completing PUT for {}", blob_info.name_.str());
+    blob_info.UpdateWriteStats();
+    MarkAccessed(blob_info, rctx);
+    MarkDirty(blob_info, rctx);
+    LogBlob(blob_info, rctx);
+    task->SetModuleComplete();
+  }
+  void MonitorPutBlob(u32 mode, PutBlobTask *task, RunContext &rctx) {
+  }
+
+  /** Release buffers */
+  void PutBlobFreeBuffersPhase(BlobInfo &blob_info, Task *task) {
+    for (BufferInfo &buf : blob_info.buffers_) {
+      FreeBuffer(buf, blob_info.score_, task);
+    }
+    blob_info.ClearBuffers();
+    blob_info.max_blob_size_ = 0;
+    blob_info.blob_size_ = 0;
+  }
+
+  /**
+   * Put a batch of blobs. Every blob is prepared first so that the DPE
+   * runs once for the batch, then all writes are issued before waiting.
+   * */
+  void MultiPutBlob(MultiPutBlobTask *task, RunContext &rctx) {
+    std::vector<BlobIoEntry> entries = task->GetEntries();
+    BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
+    char *data = HRUN_CLIENT->GetDataPointer(task->data_);
+    std::vector<BlobInfo*> blobs;
+    std::vector<bitfield32_t> flags;
+    std::vector<BlobInfo*> alloc_blobs;
+    std::vector<size_t> alloc_sizes;
+    blobs.reserve(entries.size());
+    flags.reserve(entries.size());
+    ssize_t bkt_size_diff = 0;
+
+    // Get the blob info data structures
+    for (BlobIoEntry &entry : entries) {
+      flags.emplace_back(task->flags_);
+      if (entry.blob_id_.IsNull()) {
+        u32 name_hash = HashBlobName(task->tag_id_, entry.blob_name_);
+        entry.blob_id_ = GetOrCreateBlobId(task->tag_id_, name_hash,
+                                           GetNameView(entry.blob_name_),
+                                           rctx, flags.back());
+      }
+      BlobInfo &blob_info = blob_map[entry.blob_id_];
+      blob_info.BeginWrite();
+      size_t size_diff;
+      bkt_size_diff += PutBlobPrepare(
+          blob_info, task->tag_id_, entry.blob_off_, entry.data_size_,
+          task->score_, flags.back(), static_cast<Codec>(task->codec_),
+          task, size_diff);
+      if (size_diff > 0) {
+        // Reserve the space so repeated entries don't allocate twice
+        blob_info.max_blob_size_ += size_diff;
+        alloc_blobs.emplace_back(&blob_info);
+        alloc_sizes.emplace_back(size_diff);
+      }
+      blobs.emplace_back(&blob_info);
+    }
+
+    // Allocate blob buffers
+    PutBlobAllocate(alloc_blobs, alloc_sizes, task->score_, task);
+
+    // Place blobs in buffers, with one write per target for the batch
+    TARGET_IO_T writes;
+    std::vector<LPointer<bdev::WriteVTask>> write_tasks;
+    for (size_t i = 0; i < entries.size(); ++i) {
+      BlobIoEntry &entry = entries[i];
+      PutBlobUnshare(*blobs[i], entry.blob_off_, entry.data_size_, task);
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+      BlobIoEntry &entry = entries[i];
+      PutBlobWrite(*blobs[i], entry.blob_off_, entry.data_size_,
+                   data + entry.data_off_, writes);
+    }
+    WriteSegments(writes, task, write_tasks);
+    for (LPointer<bdev::WriteVTask> &write_task : write_tasks) {
+      write_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(write_task);
+    }
+    for (BlobInfo *blob_info : blobs) {
+      blob_info->EndWrite();
+    }
+
+    // Update information
+    if (!task->flags_.Any(HERMES_SHOULD_STAGE)) {
+      UpdateBucketSize(task->tag_id_, bkt_size_diff, task, rctx);
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+      BlobIoEntry &entry = entries[i];
+      PutBlobNotify(*blobs[i], task->tag_id_, entry.blob_id_,
+                    entry.blob_off_, entry.data_size_, flags[i], task);
+      blobs[i]->UpdateWriteStats();
+      MarkAccessed(*blobs[i], rctx);
+      MarkDirty(*blobs[i], rctx);
+      LogBlob(*blobs[i], rctx);
+    }
+    if (task->flags_.Any(HERMES_GET_BLOB_ID)) {
+      task->SetEntries(entries);
+    }
+    task->SetModuleComplete();
+  }
+  void MonitorMultiPutBlob(u32 mode, MultiPutBlobTask *task, RunContext &rctx) {
+  }
+
+  /** A read of a compressed buffer, decompressed once it completes */
+  struct CompressedRead {
+    BufferInfo buf_;        /**< The compressed buffer */
+    LPointer<char> data_;   /**< Compressed data, then the decompressed data */
+    size_t rel_off_;        /**< Offset of the requested data in the buffer */
+    size_t size_;           /**< Size of the requested data */
+    char *dst_;             /**< Where the requested data goes */
+  };
+
+  /**
+   * Add the segments loading the blob's buffers into \a blob_buf to
+   * \a reads, to be issued with ReadSegments. Compressed buffers are
+   * read whole into \a c_reads, to be passed to GetBlobDecompress once
+   * the reads complete.
+   * */
+  size_t GetBlobRead(BlobInfo &blob_info,
+                     size_t blob_off, size_t data_size,
+                     char *blob_buf, Task *task,
+                     TARGET_IO_T &reads,
+                     std::vector<bdev::ReadTask*> &read_tasks,
+                     std::vector<CompressedRead> &c_reads,
+                     u32 task_flags = 0) {
+    size_t buf_off = 0;
+    size_t blob_right = blob_off + data_size;
+    size_t buf_idx = blob_info.FindBuffer(blob_off);
+    for (; buf_idx < blob_info.buffers_.size(); ++buf_idx) {
+      if (blob_off >= blob_right) {
+        break;
+      }
+      BufferInfo &buf = blob_info.buffers_[buf_idx];
+      size_t buf_left = blob_info.GetBufferOffset(buf_idx);
+      size_t buf_right = blob_info.buf_ends_[buf_idx];
+      size_t rel_off = blob_off - buf_left;
+      size_t tgt_off = buf.t_off_ + rel_off;
+      size_t buf_size = buf.t_size_ - rel_off;
+      if (buf_right > blob_right) {
+        buf_size = blob_right - (buf_left + rel_off);
+      }
+      HILOG(kDebug, "Loading {} bytes at off {} from target {}", buf_size, tgt_off, buf.tid_)
+      TargetInfo &target = *target_map_[buf.tid_];
+      if (buf.IsCompressed()) {
+        CompressedRead c_read;
+        c_read.buf_ = buf;
+        c_read.data_ = HRUN_CLIENT->AllocateBufferServer<TASK_YIELD_CO>(
+            buf.c_size_ + buf.t_size_, task);
+        c_read.rel_off_ = rel_off;
+        c_read.size_ = buf_size;
+        c_read.dst_ = blob_buf + buf_off;
+        read_tasks.emplace_back(target.AsyncRead(task->task_node_ + 1,
+                                                 c_read.data_.ptr_,
+                                                 buf.t_off_, buf.c_size_,
+                                                 task_flags).ptr_);
+        c_reads.emplace_back(c_read);
         buf_off += buf_size;
         blob_off = buf_right;
+        continue;
       }
-      buf_left += buf.t_size_;
+      reads[buf.tid_].emplace_back(blob_buf + buf_off, tgt_off, buf_size);
+      buf_off += buf_size;
+      blob_off = buf_right;
     }
-    blob_info.max_blob_size_ = blob_off;
+    return buf_off;
+  }
 
-    // Wait for the placements to complete
-    for (LPointer<bdev::WriteTask> &write_task : write_tasks) {
-      write_task->Wait<TASK_YIELD_CO>(task);
-      HRUN_CLIENT->DelTask(write_task);
+  /** Issue one vectored read per target of \a reads */
+  void ReadSegments(TARGET_IO_T &reads, u32 task_flags, Task *task,
+                    std::vector<bdev::ReadVTask*> &read_tasks) {
+    for (TARGET_IO_T::value_type &tgt_segs : reads) {
+      TargetInfo &target = *target_map_[tgt_segs.first];
+      read_tasks.emplace_back(
+          target.AsyncReadV(task->task_node_ + 1,
+                            std::move(tgt_segs.second), task_flags).ptr_);
     }
+  }
 
-    // Update information
-    if (task->flags_.Any(HERMES_SHOULD_STAGE)) {
-      stager_mdm_.AsyncUpdateSize(task->task_node_ + 1,
-                                   task->tag_id_,
-                                   blob_info.name_,
-                                   task->blob_off_,
-                                   task->data_size_, 0);
-    } else {
-      bkt_mdm_.AsyncUpdateSize(task->task_node_ + 1,
-                               task->tag_id_,
-                               bkt_size_diff,
-                               bucket_mdm::UpdateSizeMode::kAdd);
-    }
-    if (task->flags_.Any(HERMES_BLOB_DID_CREATE)) {
-      bkt_mdm_.AsyncTagAddBlob(task->task_node_ + 1,
-                               task->tag_id_,
-                               task->blob_id_);
-    }
-    if (task->flags_.Any(HERMES_HAS_DERIVED)) {
-      op_mdm_.AsyncRegisterData(task->task_node_ + 1,
-                                task->tag_id_,
-                                task->blob_name_->str(),
-                                task->blob_id_,
-                                task->blob_off_,
-                                task->data_size_);
+  /** Copy the requested data out of completed compressed reads */
+  void GetBlobDecompress(std::vector<CompressedRead> &c_reads) {
+    for (CompressedRead &c_read : c_reads) {
+      BufferInfo &buf = c_read.buf_;
+      char *plain = c_read.data_.ptr_ + buf.c_size_;
+      if (Compressor::Decompress(buf.codec_, c_read.data_.ptr_, buf.c_size_,
+                                 plain, buf.t_size_)) {
+        memcpy(c_read.dst_, plain + c_read.rel_off_, c_read.size_);
+      } else {
+        HELOG(kError, "Failed to decompress a buffer in target {}", buf.tid_);
+      }
+      HRUN_CLIENT->FreeBuffer(c_read.data_);
     }
-
-    // Free data
-    HILOG(kDebug, "Completing PUT for {}", blob_name.str());
-    blob_info.UpdateWriteStats();
-    task->SetModuleComplete();
-  }
-  void MonitorPutBlob(u32 mode, PutBlobTask *task, RunContext &rctx) {
   }
 
-  /** Release buffers */
-  void PutBlobFreeBuffersPhase(BlobInfo &blob_info, PutBlobTask *task, RunContext &rctx) {
-    for (BufferInfo &buf : blob_info.buffers_) {
-      TargetInfo &target = *target_map_[buf.tid_];
-      std::vector<BufferInfo> buf_vec = {buf};
-      target.AsyncFree(task->task_node_ + 1,
-                       blob_info.score_,
-                       std::move(buf_vec), true);
+  /** Stage in a blob's data before it is first read */
+  void GetBlobStageIn(BlobInfo &blob_info, const TagId &tag_id,
+                      bitfield32_t flags, Task *task) {
+    if (flags.Any(HERMES_SHOULD_STAGE) && blob_info.last_flush_ == 0) {
+      // TODO(llogan): Don't hardcore score = 1
+      blob_info.last_flush_ = 1;
+      LPointer<data_stager::StageInTask> stage_task =
+          stager_mdm_.AsyncStageIn(task->task_node_ + 1,
+                                   tag_id,
+                                   blob_info.name_,
+                                   1, 0);
+      stage_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(stage_task);
     }
-    blob_info.buffers_.clear();
-    blob_info.max_blob_size_ = 0;
-    blob_info.blob_size_ = 0;
   }
 
   /** Get a blob's data */
   void GetBlob(GetBlobTask *task, RunContext &rctx) {
     if (task->blob_id_.IsNull()) {
-      hshm::charbuf blob_name = hshm::to_charbuf(*task->blob_name_);
       task->blob_id_ = GetOrCreateBlobId(task->tag_id_, task->lane_hash_,
-                                         blob_name, rctx, task->flags_);
+                                         GetNameView(*task->blob_name_),
+                                         rctx, task->flags_);
     }
     BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
     BlobInfo &blob_info = blob_map[task->blob_id_];
 
     // Stage Blob
-    if (task->flags_.Any(HERMES_SHOULD_STAGE) && blob_info.last_flush_ == 0) {
-      // TODO(llogan): Don't hardcore score = 1
-      blob_info.last_flush_ = 1;
-      LPointer<data_stager::StageInTask> stage_task =
-          stager_mdm_.AsyncStageIn(task->task_node_ + 1,
-                                   task->tag_id_,
-                                   blob_info.name_,
-                                   1, 0);
-      stage_task->Wait<TASK_YIELD_CO>(task);
-      HRUN_CLIENT->DelTask(stage_task);
-    }
+    GetBlobStageIn(blob_info, task->tag_id_, task->flags_, task);
 
     // Read blob from buffers
+    TARGET_IO_T reads;
+    std::vector<bdev::ReadVTask*> readv_tasks;
     std::vector<bdev::ReadTask*> read_tasks;
-    read_tasks.reserve(blob_info.buffers_.size());
     HILOG(kDebug, "Getting blob {} of size {} starting at offset {} (total_blob_size={}, buffers={})",
           task->blob_id_, task->data_size_, task->blob_off_, blob_info.blob_size_, blob_info.buffers_.size());
-    size_t blob_off = task->blob_off_;
-    size_t buf_left = 0, buf_right = 0;
-    size_t buf_off = 0;
-    size_t blob_right = task->blob_off_ + task->data_size_;
-    bool found_left = false;
     char *blob_buf = HRUN_CLIENT->GetDataPointer(task->data_);
-    for (BufferInfo &buf : blob_info.buffers_) {
-      buf_right = buf_left + buf.t_size_;
-      if (blob_off >= blob_right) {
-        break;
-      }
-      if (buf_left <= blob_off && blob_off < buf_right) {
-        found_left = true;
-      }
-      if (found_left) {
-        size_t rel_off = blob_off - buf_left;
-        size_t tgt_off = buf.t_off_ + rel_off;
-        size_t buf_size = buf.t_size_ - rel_off;
-        if (buf_right > blob_right) {
-          buf_size = blob_right - (buf_left + rel_off);
-        }
-        HILOG(kDebug, "Loading {} bytes at off {} from target {}", buf_size, tgt_off, buf.tid_)
-        TargetInfo &target = *target_map_[buf.tid_];
-        bdev::ReadTask *read_task = target.AsyncRead(task->task_node_ + 1,
-                                                     blob_buf + buf_off,
-                                                     tgt_off, buf_size).ptr_;
-        read_tasks.emplace_back(read_task);
-        buf_off += buf_size;
-        blob_off = buf_right;
-      }
-      buf_left += buf.t_size_;
+    u32 io_flags = task->flags_.Any(HERMES_BLOB_BACKGROUND) ?
+        TASK_BACKGROUND : 0;
+    std::vector<CompressedRead> c_reads;
+    size_t buf_off = GetBlobRead(blob_info, task->blob_off_, task->data_size_,
+                                 blob_buf, task, reads, read_tasks, c_reads,
+                                 io_flags);
+    ReadSegments(reads, io_flags, task, readv_tasks);
+    for (bdev::ReadVTask *&read_task : readv_tasks) {
+      read_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(read_task);
     }
     for (bdev::ReadTask *&read_task : read_tasks) {
       read_task->Wait<TASK_YIELD_CO>(task);
       HRUN_CLIENT->DelTask(read_task);
     }
+    GetBlobDecompress(c_reads);
     task->data_size_ = buf_off;
+    if (!task->flags_.Any(HERMES_BLOB_BACKGROUND)) {
+      blob_info.UpdateReadStats();
+      MarkAccessed(blob_info, rctx);
+    }
     task->SetModuleComplete();
   }
   void MonitorGetBlob(u32 mode, GetBlobTask *task, RunContext &rctx) {
   }
 
+  /** Get a batch of blobs. All reads are issued before waiting. */
+  void MultiGetBlob(MultiGetBlobTask *task, RunContext &rctx) {
+    std::vector<BlobIoEntry> entries = task->GetEntries();
+    BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
+    char *data = HRUN_CLIENT->GetDataPointer(task->data_);
+    TARGET_IO_T reads;
+    std::vector<bdev::ReadVTask*> readv_tasks;
+    std::vector<bdev::ReadTask*> read_tasks;
+    std::vector<CompressedRead> c_reads;
+    for (BlobIoEntry &entry : entries) {
+      bitfield32_t flags(task->flags_);
+      if (entry.blob_id_.IsNull()) {
+        u32 name_hash = HashBlobName(task->tag_id_, entry.blob_name_);
+        entry.blob_id_ = GetOrCreateBlobId(task->tag_id_, name_hash,
+                                           GetNameView(entry.blob_name_),
+                                           rctx, flags);
+      }
+      BlobInfo &blob_info = blob_map[entry.blob_id_];
+      GetBlobStageIn(blob_info, task->tag_id_, flags, task);
+      entry.data_size_ = GetBlobRead(blob_info, entry.blob_off_,
+                                     entry.data_size_,
+                                     data + entry.data_off_,
+                                     task, reads, read_tasks, c_reads);
+      blob_info.UpdateReadStats();
+      MarkAccessed(blob_info, rctx);
+    }
+    ReadSegments(reads, 0, task, readv_tasks);
+    for (bdev::ReadVTask *&read_task : readv_tasks) {
+      read_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(read_task);
+    }
+    for (bdev::ReadTask *&read_task : read_tasks) {
+      read_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(read_task);
+    }
+    GetBlobDecompress(c_reads);
+    task->SetEntries(entries);
+    task->SetModuleComplete();
+  }
+  void MonitorMultiGetBlob(u32 mode, MultiGetBlobTask *task, RunContext &rctx) {
+  }
+
+  /** Get the ids and sizes of a batch of blobs */
+  void MultiGetBlobSize(MultiGetBlobSizeTask *task, RunContext &rctx) {
+    std::vector<BlobIoEntry> entries = task->GetEntries();
+    BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
+    for (BlobIoEntry &entry : entries) {
+      if (entry.blob_id_.IsNull()) {
+        bitfield32_t flags;
+        u32 name_hash = HashBlobName(task->tag_id_, entry.blob_name_);
+        entry.blob_id_ = GetOrCreateBlobId(task->tag_id_, name_hash,
+                                           GetNameView(entry.blob_name_),
+                                           rctx, flags);
+      }
+      auto it = blob_map.find(entry.blob_id_);
+      entry.data_size_ = it == blob_map.end() ? 0 : it->second.blob_size_;
+    }
+    task->SetEntries(entries);
+    task->SetModuleComplete();
+  }
+  void MonitorMultiGetBlobSize(u32 mode, MultiGetBlobSizeTask *task,
+                               RunContext &rctx) {
+  }
+
   /**
    * Tag a blob
    * */
@@ -599,7 +2034,12 @@ class Server : public TaskLib {
       return;
     }
     BlobInfo &blob = it->second;
-    blob.tags_.push_back(task->tag_);
+    std::unordered_set<BlobId> &tagged =
+        tag_index_[rctx.lane_id_][task->tag_];
+    if (tagged.emplace(blob.blob_id_).second) {
+      blob.tags_.push_back(task->tag_);
+      LogBlob(blob, rctx);
+    }
     task->SetModuleComplete();
   }
   void MonitorTagBlob(u32 mode, TagBlobTask *task, RunContext &rctx) {
@@ -609,40 +2049,120 @@ class Server : public TaskLib {
    * Check if blob has a tag
    * */
   void BlobHasTag(BlobHasTagTask *task, RunContext &rctx) {
-    BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
-    auto it = blob_map.find(task->blob_id_);
-    if (it == blob_map.end()) {
-      task->SetModuleComplete();
+    TAG_INDEX_T &tag_index = tag_index_[rctx.lane_id_];
+    auto it = tag_index.find(task->tag_);
+    task->has_tag_ = it != tag_index.end() &&
+        it->second.count(task->blob_id_) > 0;
+    task->SetModuleComplete();
+  }
+  void MonitorBlobHasTag(u32 mode, BlobHasTagTask *task, RunContext &rctx) {
+  }
+
+  /**
+   * Find the blobs of this lane labeled with a tag
+   * */
+  void GetBlobsWithTag(GetBlobsWithTagTask *task, RunContext &rctx) {
+    TAG_INDEX_T &tag_index = tag_index_[rctx.lane_id_];
+    std::vector<BlobId> blob_ids;
+    auto it = tag_index.find(task->tag_);
+    if (it != tag_index.end()) {
+      BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
+      blob_ids.reserve(it->second.size());
+      for (const BlobId &blob_id : it->second) {
+        if (!task->tag_id_.IsNull()) {
+          auto blob_it = blob_map.find(blob_id);
+          if (blob_it == blob_map.end() ||
+              blob_it->second.tag_id_ != task->tag_id_) {
+            continue;
+          }
+        }
+        blob_ids.emplace_back(blob_id);
+      }
+    }
+    task->SerializeBlobIds(blob_ids);
+    task->SetModuleComplete();
+  }
+  void MonitorGetBlobsWithTag(u32 mode, GetBlobsWithTagTask *task,
+                              RunContext &rctx) {
+  }
+
+  /** Remove a blob from the index of each of its tags */
+  void UnindexBlobTags(const BlobInfo &blob_info, u32 lane) {
+    TAG_INDEX_T &tag_index = tag_index_[lane];
+    for (const TagId &tag : blob_info.tags_) {
+      auto it = tag_index.find(tag);
+      if (it == tag_index.end()) {
+        continue;
+      }
+      it->second.erase(blob_info.blob_id_);
+      if (it->second.empty()) {
+        tag_index.erase(it);
+      }
+    }
+  }
+
+  /** Add a blob's name to the ordered name index, if enabled */
+  void IndexBlobName(const BlobInfo &blob_info, u32 lane) {
+    if (name_index_.empty()) {
       return;
     }
-    BlobInfo &blob = it->second;
-    task->has_tag_ = std::find(blob.tags_.begin(),
-                               blob.tags_.end(),
-                               task->tag_) != blob.tags_.end();
+    name_index_[lane].Insert(
+        blob_info.tag_id_,
+        std::string_view(blob_info.name_.data(), blob_info.name_.size()),
+        blob_info.blob_id_);
+  }
+
+  /** Remove a blob's name from the ordered name index, if enabled */
+  void UnindexBlobName(const BlobInfo &blob_info, u32 lane) {
+    if (name_index_.empty()) {
+      return;
+    }
+    name_index_[lane].Erase(
+        blob_info.tag_id_,
+        std::string_view(blob_info.name_.data(), blob_info.name_.size()));
+  }
+
+  /**
+   * List the blobs of this lane in a tag, in name order. Returns nothing
+   * if the name index is disabled.
+   * */
+  void ListBlobs(ListBlobsTask *task, RunContext &rctx) {
+    std::vector<BlobNameEntry> entries;
+    if (!name_index_.empty()) {
+      name_index_[rctx.lane_id_].List(task->tag_id_,
+                                      task->prefix_->str(),
+                                      task->start_after_->str(),
+                                      task->limit_, entries);
+    }
+    task->SerializeEntries(entries);
     task->SetModuleComplete();
   }
-  void MonitorBlobHasTag(u32 mode, BlobHasTagTask *task, RunContext &rctx) {
+  void MonitorListBlobs(u32 mode, ListBlobsTask *task, RunContext &rctx) {
   }
 
   /**
-   * Create \a blob_id BLOB ID
+   * Create \a blob_id BLOB ID.
+   * \a name_hash is HashBlobName of the tag and name. Requests looking up
+   * a blob by name are routed by this hash, so it is the task's lane_hash_.
    * */
-  BlobId GetOrCreateBlobId(TagId &tag_id, u32 lane_hash,
-                           const hshm::charbuf &blob_name, RunContext &rctx,
+  BlobId GetOrCreateBlobId(const TagId &tag_id, u32 name_hash,
+                           std::string_view blob_name, RunContext &rctx,
                            bitfield32_t &flags) {
-    hshm::charbuf blob_name_unique = GetBlobNameWithBucket(tag_id, blob_name);
     BLOB_ID_MAP_T &blob_id_map = blob_id_map_[rctx.lane_id_];
-    auto it = blob_id_map.find(blob_name_unique);
+    auto it = blob_id_map.find(BlobNameKey(tag_id, blob_name, name_hash));
     if (it == blob_id_map.end()) {
-      BlobId blob_id = BlobId(node_id_, lane_hash, id_alloc_.fetch_add(1));
-      blob_id_map.emplace(blob_name_unique, blob_id);
+      BlobId blob_id = BlobId(node_id_, name_hash, id_alloc_.fetch_add(1));
       flags.SetBits(HERMES_BLOB_DID_CREATE);
       BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
-      blob_map.emplace(blob_id, BlobInfo());
       BlobInfo &blob_info = blob_map[blob_id];
-      blob_info.name_ = blob_name;
+      // The name is stored once in the BlobInfo; the map key views it
+      blob_info.name_ = hshm::charbuf(blob_name.size());
+      memcpy(blob_info.name_.data(), blob_name.data(), blob_name.size());
+      blob_id_map.emplace(
+          BlobNameKey(tag_id, blob_info.name_, name_hash), blob_id);
       blob_info.blob_id_ = blob_id;
       blob_info.tag_id_ = tag_id;
+      IndexBlobName(blob_info, rctx.lane_id_);
       blob_info.blob_size_ = 0;
       blob_info.max_blob_size_ = 0;
       blob_info.score_ = 1;
@@ -654,9 +2174,10 @@ class Server : public TaskLib {
     return it->second;
   }
   void GetOrCreateBlobId(GetOrCreateBlobIdTask *task, RunContext &rctx) {
-    hshm::charbuf blob_name = hshm::to_charbuf(*task->blob_name_);
     bitfield32_t flags;
-    task->blob_id_ = GetOrCreateBlobId(task->tag_id_, task->lane_hash_, blob_name, rctx, flags);
+    task->blob_id_ = GetOrCreateBlobId(task->tag_id_, task->lane_hash_,
+                                       GetNameView(*task->blob_name_),
+                                       rctx, flags);
     task->SetModuleComplete();
   }
   void MonitorGetOrCreateBlobId(u32 mode, GetOrCreateBlobIdTask *task, RunContext &rctx) {
@@ -667,18 +2188,20 @@ class Server : public TaskLib {
    * */
   HSHM_ALWAYS_INLINE
   void GetBlobId(GetBlobIdTask *task, RunContext &rctx) {
-    hshm::charbuf blob_name = hshm::to_charbuf(*task->blob_name_);
-    hshm::charbuf blob_name_unique = GetBlobNameWithBucket(task->tag_id_, blob_name);
+    std::string_view blob_name = GetNameView(*task->blob_name_);
     BLOB_ID_MAP_T &blob_id_map = blob_id_map_[rctx.lane_id_];
-    auto it = blob_id_map.find(blob_name_unique);
+    auto it = blob_id_map.find(
+        BlobNameKey(task->tag_id_, blob_name, task->lane_hash_));
     if (it == blob_id_map.end()) {
       task->blob_id_ = BlobId::GetNull();
       task->SetModuleComplete();
-      HILOG(kDebug, "Failed to find blob {} in {}", blob_name.str(), task->tag_id_);
+      HILOG(kDebug, "Failed to find blob (hash: {}) in {}",
+            task->lane_hash_, task->tag_id_);
       return;
     }
     task->blob_id_ = it->second;
-    HILOG(kDebug, "Found blob {} / {} in {}", task->blob_id_, blob_name.str(), task->tag_id_);
+    HILOG(kDebug, "Found blob {} (hash: {}) in {}",
+          task->blob_id_, task->lane_hash_, task->tag_id_);
     task->SetModuleComplete();
   }
   void MonitorGetBlobId(u32 mode, GetBlobIdTask *task, RunContext &rctx) {
@@ -708,7 +2231,7 @@ class Server : public TaskLib {
     if (task->blob_id_.IsNull()) {
       bitfield32_t flags;
       task->blob_id_ = GetOrCreateBlobId(task->tag_id_, task->lane_hash_,
-                                         hshm::to_charbuf(*task->blob_name_),
+                                         GetNameView(*task->blob_name_),
                                          rctx, flags);
     }
     BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
@@ -772,9 +2295,15 @@ class Server : public TaskLib {
     }
     BLOB_ID_MAP_T &blob_id_map = blob_id_map_[rctx.lane_id_];
     BlobInfo &blob = it->second;
-    blob_id_map.erase(blob.name_);
-    blob_id_map[blob.name_] = task->blob_id_;
+    blob_id_map.erase(BlobNameKey(blob.tag_id_, blob.name_,
+                                  HashBlobName(blob.tag_id_, blob.name_)));
+    UnindexBlobName(blob, rctx.lane_id_);
     blob.name_ = hshm::to_charbuf(*task->new_blob_name_);
+    blob_id_map.emplace(BlobNameKey(blob.tag_id_, blob.name_,
+                                    HashBlobName(blob.tag_id_, blob.name_)),
+                        task->blob_id_);
+    IndexBlobName(blob, rctx.lane_id_);
+    LogBlob(blob, rctx);
     task->SetModuleComplete();
   }
   void MonitorRenameBlob(u32 mode, RenameBlobTask *task, RunContext &rctx) {
@@ -811,11 +2340,18 @@ class Server : public TaskLib {
         }
         BLOB_ID_MAP_T &blob_id_map = blob_id_map_[rctx.lane_id_];
         BlobInfo &blob_info = it->second;
-        hshm::charbuf unique_name = GetBlobNameWithBucket(blob_info.tag_id_, blob_info.name_);
-        blob_id_map.erase(unique_name);
+        blob_id_map.erase(BlobNameKey(
+            blob_info.tag_id_, blob_info.name_,
+            HashBlobName(blob_info.tag_id_, blob_info.name_)));
+        UnindexBlobTags(blob_info, rctx.lane_id_);
+        UnindexBlobName(blob_info, rctx.lane_id_);
+        LogDestroyBlob(task->blob_id_, rctx);
         HSHM_MAKE_AR0(task->free_tasks_, nullptr);
         task->free_tasks_->reserve(blob_info.buffers_.size());
         for (BufferInfo &buf : blob_info.buffers_) {
+          if (!ReleaseBuffer(buf)) {
+            continue;
+          }
           TargetInfo &tgt_info = *target_map_[buf.tid_];
           std::vector<BufferInfo> buf_vec = {buf};
           bdev::FreeTask *free_task = tgt_info.AsyncFree(
@@ -838,12 +2374,11 @@ class Server : public TaskLib {
         BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
         BlobInfo &blob_info = blob_map[task->blob_id_];
         if (task->update_size_) {
-          bkt_mdm_.AsyncUpdateSize(task->task_node_ + 1,
-                                   task->tag_id_,
-                                   -(ssize_t) blob_info.blob_size_,
-                                   bucket_mdm::UpdateSizeMode::kAdd);
+          UpdateBucketSize(task->tag_id_, -(ssize_t) blob_info.blob_size_,
+                           task, rctx);
         }
         HSHM_DESTROY_AR(task->free_tasks_);
+        dirty_list_[rctx.lane_id_].Remove(blob_info);
         blob_map.erase(task->blob_id_);
         task->SetModuleComplete();
       }
@@ -853,67 +2388,343 @@ class Server : public TaskLib {
   }
 
   /**
-   * Reorganize \a blob_id blob in \a bkt_id bucket
+   * Destroy many blobs of a tag in this lane. The metadata of every blob
+   * is removed up front; the buffers are then freed with one vectored
+   * free per target instead of one free per buffer.
    * */
-  void ReorganizeBlob(ReorganizeBlobTask *task, RunContext &rctx) {
+  void DestroyBlobs(DestroyBlobsTask *task, RunContext &rctx) {
     switch (task->phase_) {
-      case ReorganizeBlobPhase::kGet: {
-        hshm::charbuf blob_name = hshm::to_charbuf(*task->blob_name_);
-        if (task->blob_id_.IsNull()) {
-          bitfield32_t flags;
-          task->blob_id_ = GetOrCreateBlobId(task->tag_id_, task->lane_hash_,
-                                             blob_name, rctx, flags);
-        }
+      case DestroyBlobPhase::kFreeBuffers: {
         BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
-        auto it = blob_map.find(task->blob_id_);
-        if (it == blob_map.end()) {
-          task->SetModuleComplete();
-          return;
+        BLOB_ID_MAP_T &blob_id_map = blob_id_map_[rctx.lane_id_];
+        std::unordered_map<TargetId, std::vector<BufferInfo>> tgt_bufs;
+        std::unordered_map<TargetId, std::vector<float>> tgt_scores;
+        size_t destroyed_size = 0;
+        for (const BlobId &blob_id : *task->blob_ids_) {
+          auto it = blob_map.find(blob_id);
+          if (it == blob_map.end()) {
+            continue;
+          }
+          BlobInfo &blob_info = it->second;
+          blob_id_map.erase(BlobNameKey(
+              blob_info.tag_id_, blob_info.name_,
+              HashBlobName(blob_info.tag_id_, blob_info.name_)));
+          UnindexBlobTags(blob_info, rctx.lane_id_);
+          UnindexBlobName(blob_info, rctx.lane_id_);
+          LogDestroyBlob(blob_id, rctx);
+          for (BufferInfo &buf : blob_info.buffers_) {
+            if (!ReleaseBuffer(buf)) {
+              continue;
+            }
+            tgt_bufs[buf.tid_].emplace_back(buf);
+            tgt_scores[buf.tid_].emplace_back(blob_info.score_);
+          }
+          destroyed_size += blob_info.blob_size_;
+          dirty_list_[rctx.lane_id_].Remove(blob_info);
+          blob_map.erase(it);
         }
-        BlobInfo &blob_info = it->second;
-        if (task->is_user_score_) {
-          blob_info.user_score_ = task->score_;
-          blob_info.score_ = blob_info.user_score_;
-        } else {
-          blob_info.score_ = task->score_;
-        }
-//        if (!ShouldReorganize(blob_info, task->score_, task->task_node_)) {
-//          task->SetModuleComplete();
-//          return;
-//        }
-        task->data_ = HRUN_CLIENT->AllocateBufferServer<TASK_YIELD_STD>(
-            blob_info.blob_size_, task).shm_;
-        task->data_size_ = blob_info.blob_size_;
-        task->get_task_ = blob_mdm_.AsyncGetBlob(task->task_node_ + 1,
-                                                 task->tag_id_,
-                                                 hshm::charbuf(""),
-                                                 task->blob_id_,
-                                                 0,
-                                                 task->data_size_,
-                                                 task->data_).ptr_;
-        task->tag_id_ = blob_info.tag_id_;
-        task->phase_ = ReorganizeBlobPhase::kWaitGet;
-      }
-      case ReorganizeBlobPhase::kWaitGet: {
-        if (!task->get_task_->IsComplete()) {
-          return;
+        HSHM_MAKE_AR0(task->free_tasks_, nullptr);
+        task->free_tasks_->reserve(tgt_bufs.size());
+        for (auto &bufs : tgt_bufs) {
+          TargetInfo &tgt_info = *target_map_[bufs.first];
+          bdev::FreeTask *free_task = tgt_info.AsyncFree(
+              task->task_node_ + 1, bufs.second,
+              tgt_scores[bufs.first], false).ptr_;
+          task->free_tasks_->emplace_back(free_task);
+        }
+        if (task->update_size_) {
+          UpdateBucketSize(task->tag_id_, -(ssize_t) destroyed_size,
+                           task, rctx);
+        }
+        task->phase_ = DestroyBlobPhase::kWaitFreeBuffers;
+      }
+      case DestroyBlobPhase::kWaitFreeBuffers: {
+        std::vector<bdev::FreeTask *> &free_tasks = *task->free_tasks_;
+        for (bdev::FreeTask *&free_task : free_tasks) {
+          if (!free_task->IsComplete()) {
+            return;
+          }
+        }
+        for (bdev::FreeTask *&free_task : free_tasks) {
+          HRUN_CLIENT->DelTask(free_task);
         }
-        HRUN_CLIENT->DelTask(task->get_task_);
-        task->phase_ = ReorganizeBlobPhase::kPut;
-      }
-      case ReorganizeBlobPhase::kPut: {
-        task->put_task_ = blob_mdm_.AsyncPutBlob(
-            task->task_node_ + 1,
-            task->tag_id_, hshm::charbuf(""),
-            task->blob_id_, 0,
-            task->data_size_,
-            task->data_,
-            task->score_,
-            HERMES_BLOB_REPLACE | TASK_FIRE_AND_FORGET | TASK_DATA_OWNER).ptr_;
+        HSHM_DESTROY_AR(task->free_tasks_);
         task->SetModuleComplete();
       }
     }
   }
+  void MonitorDestroyBlobs(u32 mode, DestroyBlobsTask *task, RunContext &rctx) {
+  }
+
+  /** A buffer of a blob being moved to another target */
+  struct BufferMigration {
+    BufferInfo old_buf_;
+    TargetInfo *dst_;
+    Codec codec_;  /**< Codec to store the buffer with in dst_ */
+    std::vector<BufferInfo> new_bufs_;
+    LPointer<bdev::AllocateTask> alloc_task_;
+    size_t data_off_;  /**< Offset of the buffer's staging space */
+    char *out_ = nullptr;  /**< The data to write, or null on error */
+    size_t out_size_ = 0;  /**< Number of bytes to write */
+    bool copied_ = false;  /**< Whether new_bufs_ hold the data */
+    bool swapped_ = false;  /**< Whether new_bufs_ replaced old_buf_ */
+  };
+
+  /** The codec a blob's buffers use in \a target */
+  static Codec GetMigrationCodec(const BlobInfo &blob_info,
+                                 const TargetInfo &target) {
+    if (blob_info.codec_ != Codec::kDefault) {
+      return blob_info.codec_;
+    }
+    return target.codec_;
+  }
+
+  /**
+   * Reorganize \a blob_id blob in \a bkt_id bucket.
+   * Only the buffers that belong in a different tier are moved: each is
+   * read (and decompressed), compressed with the destination's codec,
+   * allocated on the destination, copied there, and swapped into the
+   * blob before the old buffer is freed. The bdev allocate and free
+   * calls keep the targets' score histograms consistent.
+   * */
+  void ReorganizeBlob(ReorganizeBlobTask *task, RunContext &rctx) {
+    if (task->blob_id_.IsNull()) {
+      // Routed by blob id, so lane_hash_ is not the name hash here
+      hshm::charbuf blob_name = hshm::to_charbuf(*task->blob_name_);
+      bitfield32_t flags;
+      task->blob_id_ = GetOrCreateBlobId(
+          task->tag_id_, HashBlobName(task->tag_id_, blob_name),
+          GetNameView(blob_name), rctx, flags);
+    }
+    BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
+    auto it = blob_map.find(task->blob_id_);
+    if (it == blob_map.end()) {
+      task->SetModuleComplete();
+      return;
+    }
+    BlobInfo &blob_info = it->second;
+    float score = task->score_;
+    if (blob_info.score_ != score) {
+      for (BufferInfo &buf : blob_info.buffers_) {
+        TargetInfo &target = *target_map_[buf.tid_];
+        target.AsyncUpdateScore(task->task_node_ + 1,
+                                blob_info.score_, score);
+      }
+    }
+    if (task->is_user_score_) {
+      blob_info.user_score_ = score;
+    }
+    blob_info.score_ = score;
+
+    // Find the buffers that should change tier and fit in the budget
+    FlushStats &stats = flush_stats_[rctx.lane_id_];
+    std::vector<BufferMigration> migrations;
+    size_t data_size = 0;
+    bool deferred = false;
+    for (BufferInfo &buf : blob_info.buffers_) {
+      TargetInfo *dst = FindMigrationTarget(blob_info, buf, score,
+                                            task->is_user_score_);
+      if (dst == nullptr) {
+        continue;
+      }
+      MigrationBudget &src_budget = *migrate_budget_[buf.tid_];
+      MigrationBudget &dst_budget = *migrate_budget_[dst->id_];
+      if (!src_budget.TryAcquire(buf.GetTargetSize())) {
+        stats.deferred_migrations_ += 1;
+        deferred = true;
+        continue;
+      }
+      if (!dst_budget.TryAcquire(buf.t_size_)) {
+        src_budget.Release(buf.GetTargetSize(), true);
+        stats.deferred_migrations_ += 1;
+        deferred = true;
+        continue;
+      }
+      // Staging space: the stored data, the plain data, the compressed data
+      BufferMigration migration;
+      migration.old_buf_ = buf;
+      migration.dst_ = dst;
+      migration.codec_ = GetMigrationCodec(blob_info, *dst);
+      migration.alloc_task_.ptr_ = nullptr;
+      migration.data_off_ = data_size;
+      data_size += buf.GetTargetSize();
+      data_size += buf.IsCompressed() ? buf.t_size_ : 0;
+      data_size += migration.codec_ != Codec::kNone ? buf.t_size_ : 0;
+      migrations.emplace_back(std::move(migration));
+    }
+    if (deferred) {
+      // Reconsider the blob in the next BORG period
+      hshm::Timepoint now;
+      now.Now();
+      score_index_[rctx.lane_id_].Schedule(blob_info, GetIndexTime(now));
+    }
+    if (migrations.empty()) {
+      if (task->is_user_score_) {
+        LogBlob(blob_info, rctx);
+      }
+      task->SetModuleComplete();
+      return;
+    }
+    // The blob may be destroyed while this task yields, so blob_info is
+    // not used past this point
+    size_t mod_count = blob_info.mod_count_;
+    size_t buf_gen = blob_info.buf_gen_;
+    std::string blob_name = blob_info.name_.str();
+
+    // Read the old buffers
+    LPointer<char> data = HRUN_CLIENT->AllocateBufferServer<TASK_YIELD_CO>(
+        data_size, task);
+    std::vector<LPointer<bdev::ReadTask>> read_tasks;
+    read_tasks.reserve(migrations.size());
+    for (BufferMigration &migration : migrations) {
+      BufferInfo &old_buf = migration.old_buf_;
+      TargetInfo &src = *target_map_[old_buf.tid_];
+      read_tasks.emplace_back(
+          src.AsyncRead(task->task_node_ + 1,
+                        data.ptr_ + migration.data_off_,
+                        old_buf.t_off_, old_buf.GetTargetSize(),
+                        TASK_BACKGROUND));
+    }
+    for (LPointer<bdev::ReadTask> &read_task : read_tasks) {
+      read_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(read_task);
+    }
+
+    // Convert the data to the destination's codec
+    for (BufferMigration &migration : migrations) {
+      BufferInfo &old_buf = migration.old_buf_;
+      char *stored = data.ptr_ + migration.data_off_;
+      char *plain = stored;
+      if (old_buf.IsCompressed()) {
+        plain = stored + old_buf.c_size_;
+        if (!Compressor::Decompress(old_buf.codec_, stored, old_buf.c_size_,
+                                    plain, old_buf.t_size_)) {
+          HELOG(kError, "Failed to decompress a buffer of {}", blob_name);
+          continue;
+        }
+      }
+      migration.out_ = plain;
+      migration.out_size_ = old_buf.t_size_;
+      if (migration.codec_ == Codec::kNone) {
+        continue;
+      }
+      // Only compress into a single slab, and only if it saves space
+      char *comp = plain + old_buf.t_size_;
+      size_t c_size = Compressor::Compress(migration.codec_,
+                                           plain, old_buf.t_size_,
+                                           comp, migration.dst_->max_slab_size_);
+      if (c_size == 0) {
+        migration.codec_ = Codec::kNone;
+        continue;
+      }
+      migration.out_ = comp;
+      migration.out_size_ = c_size;
+    }
+
+    // Allocate space on the destination targets
+    for (BufferMigration &migration : migrations) {
+      if (migration.out_ == nullptr) {
+        continue;
+      }
+      migration.alloc_task_ = migration.dst_->AsyncAllocate(
+          task->task_node_ + 1, score,
+          migration.out_size_, migration.new_bufs_);
+    }
+    for (BufferMigration &migration : migrations) {
+      if (migration.out_ == nullptr) {
+        continue;
+      }
+      migration.alloc_task_->Wait<TASK_YIELD_CO>(task);
+    }
+
+    // Copy the data to the new buffers
+    std::vector<LPointer<bdev::WriteTask>> write_tasks;
+    for (BufferMigration &migration : migrations) {
+      if (migration.out_ == nullptr ||
+          migration.alloc_task_->alloc_size_ < migration.out_size_) {
+        continue;
+      }
+      if (migration.codec_ == Codec::kNone) {
+        WriteBuffers(migration.new_bufs_,
+                     migration.out_, migration.out_size_,
+                     TASK_BACKGROUND, task, write_tasks);
+        migration.copied_ = true;
+        continue;
+      }
+      if (migration.new_bufs_.size() != 1) {
+        continue;
+      }
+      BufferInfo &new_buf = migration.new_bufs_[0];
+      write_tasks.emplace_back(
+          migration.dst_->AsyncWrite(task->task_node_ + 1,
+                                     migration.out_,
+                                     new_buf.t_off_, migration.out_size_,
+                                     TASK_BACKGROUND));
+      new_buf.t_size_ = migration.old_buf_.t_size_;
+      new_buf.codec_ = migration.codec_;
+      new_buf.c_size_ = migration.out_size_;
+      migration.copied_ = true;
+    }
+    for (LPointer<bdev::WriteTask> &write_task : write_tasks) {
+      write_task->Wait<TASK_YIELD_CO>(task);
+      HRUN_CLIENT->DelTask(write_task);
+    }
+    HRUN_CLIENT->FreeBuffer(data);
+
+    // Swap the new buffers into the blob, unless it changed while copying.
+    // A put that began before the copy may still be writing the old ones.
+    it = blob_map.find(task->blob_id_);
+    bool changed = it == blob_map.end() ||
+        it->second.mod_count_ != mod_count ||
+        it->second.WroteSince(buf_gen);
+    std::vector<BufferInfo> buffers;
+    if (!changed) {
+      BlobInfo &cur_info = it->second;
+      buffers.reserve(cur_info.buffers_.size() + migrations.size());
+      for (BufferInfo &buf : cur_info.buffers_) {
+        auto mig = std::find_if(
+            migrations.begin(), migrations.end(),
+            [&buf](const BufferMigration &migration) {
+              // A blob may reference a shared slab more than once
+              return migration.old_buf_.tid_ == buf.tid_ &&
+                  migration.old_buf_.t_off_ == buf.t_off_ &&
+                  !migration.swapped_;
+            });
+        if (mig == migrations.end() || !mig->copied_) {
+          buffers.emplace_back(buf);
+          continue;
+        }
+        buffers.insert(buffers.end(),
+                       mig->new_bufs_.begin(), mig->new_bufs_.end());
+        mig->swapped_ = true;
+      }
+      cur_info.buffers_ = std::move(buffers);
+      cur_info.RebuildExtents();
+      LogBlob(cur_info, rctx);
+    }
+
+    // Release the buffers that are no longer referenced
+    for (BufferMigration &migration : migrations) {
+      BufferInfo &old_buf = migration.old_buf_;
+      bool moved = migration.swapped_;
+      migrate_budget_[old_buf.tid_]->Release(old_buf.GetTargetSize(), false);
+      migrate_budget_[migration.dst_->id_]->Release(old_buf.t_size_, false);
+      if (migration.alloc_task_.ptr_ == nullptr) {
+        continue;
+      }
+      HRUN_CLIENT->DelTask(migration.alloc_task_);
+      if (moved) {
+        stats.executed_migrations_ += 1;
+        stats.migrated_bytes_ += old_buf.t_size_;
+        FreeBuffer(old_buf, score, task);
+      } else {
+        // Also balances the destination's histogram if nothing was allocated
+        migration.dst_->AsyncFree(task->task_node_ + 1, score,
+                                  std::move(migration.new_bufs_), true);
+      }
+    }
+    task->SetModuleComplete();
+  }
   void MonitorReorganizeBlob(u32 mode, ReorganizeBlobTask *task, RunContext &rctx) {
   }
 
@@ -925,7 +2736,7 @@ class Server : public TaskLib {
     BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
     std::vector<BlobInfo> blob_mdms;
     blob_mdms.reserve(blob_map.size());
-    for (const std::pair<BlobId, BlobInfo> &blob_part : blob_map) {
+    for (const BLOB_MAP_T::value_type &blob_part : blob_map) {
       const BlobInfo &blob_info = blob_part.second;
       blob_mdms.emplace_back(blob_info);
     }
@@ -935,6 +2746,43 @@ class Server : public TaskLib {
   void MonitorPollBlobMetadata(u32 mode, PollBlobMetadataTask *task, RunContext &rctx) {
   }
 
+  /**
+   * Get a page of blob summaries from this lane. At most a few pages
+   * worth of blobs are examined, so a selective query returns a short
+   * page instead of holding the lane.
+   * */
+  HSHM_ALWAYS_INLINE
+  void PollBlobMetadataPage(PollBlobMetadataPageTask *task,
+                            RunContext &rctx) {
+    BLOB_MAP_T &blob_map = blob_map_[rctx.lane_id_];
+    BlobQuery query = task->GetQuery();
+    MetadataCursor &cursor = task->cursor_;
+    size_t page_size = std::max<size_t>(query.page_size_, 1);
+    size_t max_scan = page_size * MetadataCursor::kMaxScanPages;
+    std::vector<BlobStat> page;
+    page.reserve(std::min(page_size, blob_map.size()));
+    BLOB_MAP_T::iterator it = blob_map.begin_from(cursor.slot_);
+    for (size_t scanned = 0;
+         it != blob_map.end() && page.size() < page_size &&
+         scanned < max_scan; ++it, ++scanned) {
+      if (query.Match(it->second)) {
+        page.emplace_back(it->second);
+      }
+    }
+    cursor.node_id_ = node_id_;
+    cursor.lane_ = rctx.lane_id_;
+    if (it == blob_map.end()) {
+      cursor.NextLane(blob_map_.size(), HRUN_RPC->GetNumHosts());
+    } else {
+      cursor.slot_ = it.slot();
+    }
+    task->SerializePage(page);
+    task->SetModuleComplete();
+  }
+  void MonitorPollBlobMetadataPage(u32 mode, PollBlobMetadataPageTask *task,
+                                   RunContext &rctx) {
+  }
+
   /**
    * Get all metadata about a blob
    * */
@@ -955,6 +2803,8 @@ class Server : public TaskLib {
       stats.bandwidth_ = bdev_client.bandwidth_;
       stats.latency_ = bdev_client.latency_;
       stats.score_ = bdev_client.score_;
+      stats.bg_deferred_ = bdev_client.monitor_task_->bg_deferred_;
+      stats.bg_executed_ = bdev_client.monitor_task_->bg_executed_;
       target_mdms.emplace_back(stats);
     }
     task->SerializeTargetMetadata(target_mdms);
@@ -963,6 +2813,24 @@ class Server : public TaskLib {
   void MonitorPollTargetMetadata(u32 mode, PollTargetMetadataTask *task, RunContext &rctx) {
   }
 
+  /**
+   * Get the statistics of the flush pipeline of this node
+   * */
+  HSHM_ALWAYS_INLINE
+  void PollFlushStats(PollFlushStatsTask *task, RunContext &rctx) {
+    FlushStats node_stats;
+    node_stats.node_id_ = HRUN_CLIENT->node_id_;
+    for (size_t i = 0; i < flush_stats_.size(); ++i) {
+      FlushStats lane_stats = flush_stats_[i];
+      lane_stats.queue_depth_ = dirty_list_[i].size();
+      node_stats.Merge(lane_stats);
+    }
+    task->SerializeFlushStats({node_stats});
+    task->SetModuleComplete();
+  }
+  void MonitorPollFlushStats(u32 mode, PollFlushStatsTask *task, RunContext &rctx) {
+  }
+
  public:
 #include "hermes_blob_mdm/hermes_blob_mdm_lib_exec.h"
 };
@@ -65,10 +65,11 @@ class Client : public TaskLibClient {
                                 const TaskNode &task_node,
                                 TagId tag_id,
                                 ssize_t update,
-                                int mode) {
+                                int mode,
+                                u32 task_flags = TASK_LOW_LATENCY | TASK_FIRE_AND_FORGET) {
     HRUN_CLIENT->ConstructTask<UpdateSizeTask>(
         task, task_node, DomainId::GetNode(tag_id.node_id_), id_,
-        tag_id, update, mode);
+        tag_id, update, mode, task_flags);
   }
   HRUN_TASK_NODE_PUSH_ROOT(UpdateSize);
 
@@ -113,6 +114,28 @@ class Client : public TaskLibClient {
   }
   HRUN_TASK_NODE_PUSH_ROOT(AppendBlob);
 
+  /** Reserve \a size bytes at the end of the bucket */
+  void AsyncReserveAppendConstruct(ReserveAppendTask *task,
+                                   const TaskNode &task_node,
+                                   const TagId &tag_id,
+                                   size_t size) {
+    HRUN_CLIENT->ConstructTask<ReserveAppendTask>(
+        task, task_node, DomainId::GetNode(tag_id.node_id_), id_,
+        tag_id, size);
+  }
+  size_t ReserveAppendRoot(const TagId &tag_id, size_t size,
+                           bitfield32_t &flags) {
+    LPointer<hrunpq::TypedPushTask<ReserveAppendTask>> push_task =
+        AsyncReserveAppendRoot(tag_id, size);
+    push_task->Wait();
+    ReserveAppendTask *task = push_task->get();
+    size_t off = task->off_;
+    flags = task->flags_;
+    HRUN_CLIENT->DelTask(push_task);
+    return off;
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(ReserveAppend);
+
   /** Create a tag or get the ID of existing tag */
   HSHM_ALWAYS_INLINE
   void AsyncGetOrCreateTagConstruct(GetOrCreateTagTask *task,
@@ -331,6 +354,30 @@ class Client : public TaskLibClient {
     return target_mdms;
   }
   HRUN_TASK_NODE_PUSH_ROOT(PollTagMetadata);
+
+  /**
+   * Get a page of tag summaries matching \a query, starting at \a cursor.
+   * The cursor is advanced past the page; poll until cursor.done_.
+   * */
+  void AsyncPollTagMetadataPageConstruct(PollTagMetadataPageTask *task,
+                                         const TaskNode &task_node,
+                                         const TagQuery &query,
+                                         const MetadataCursor &cursor) {
+    HRUN_CLIENT->ConstructTask<PollTagMetadataPageTask>(
+        task, task_node, id_, query, cursor);
+  }
+  std::vector<TagStat> PollTagMetadataPageRoot(const TagQuery &query,
+                                               MetadataCursor &cursor) {
+    LPointer<hrunpq::TypedPushTask<PollTagMetadataPageTask>> push_task =
+        AsyncPollTagMetadataPageRoot(query, cursor);
+    push_task->Wait();
+    PollTagMetadataPageTask *task = push_task->get();
+    std::vector<TagStat> page = task->DeserializePage();
+    cursor = task->cursor_;
+    HRUN_CLIENT->DelTask(push_task);
+    return page;
+  }
+  HRUN_TASK_NODE_PUSH_ROOT(PollTagMetadataPage);
 };
 
 }  // namespace hrun
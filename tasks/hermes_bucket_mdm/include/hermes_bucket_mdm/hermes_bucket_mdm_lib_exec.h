@@ -72,6 +72,14 @@ void Run(u32 method, Task *task, RunContext &rctx) override {
       PollTagMetadata(reinterpret_cast<PollTagMetadataTask *>(task), rctx);
       break;
     }
+    case Method::kPollTagMetadataPage: {
+      PollTagMetadataPage(reinterpret_cast<PollTagMetadataPageTask *>(task), rctx);
+      break;
+    }
+    case Method::kReserveAppend: {
+      ReserveAppend(reinterpret_cast<ReserveAppendTask *>(task), rctx);
+      break;
+    }
   }
 }
 /** Execute a task */
@@ -145,6 +153,14 @@ void Monitor(u32 mode, Task *task, RunContext &rctx) override {
       MonitorPollTagMetadata(mode, reinterpret_cast<PollTagMetadataTask *>(task), rctx);
       break;
     }
+    case Method::kPollTagMetadataPage: {
+      MonitorPollTagMetadataPage(mode, reinterpret_cast<PollTagMetadataPageTask *>(task), rctx);
+      break;
+    }
+    case Method::kReserveAppend: {
+      MonitorReserveAppend(mode, reinterpret_cast<ReserveAppendTask *>(task), rctx);
+      break;
+    }
   }
 }
 /** Delete a task */
@@ -218,6 +234,14 @@ void Del(u32 method, Task *task) override {
       HRUN_CLIENT->DelTask<PollTagMetadataTask>(reinterpret_cast<PollTagMetadataTask *>(task));
       break;
     }
+    case Method::kPollTagMetadataPage: {
+      HRUN_CLIENT->DelTask<PollTagMetadataPageTask>(reinterpret_cast<PollTagMetadataPageTask *>(task));
+      break;
+    }
+    case Method::kReserveAppend: {
+      HRUN_CLIENT->DelTask<ReserveAppendTask>(reinterpret_cast<ReserveAppendTask *>(task));
+      break;
+    }
   }
 }
 /** Duplicate a task */
@@ -291,6 +315,14 @@ void Dup(u32 method, Task *orig_task, std::vector<LPointer<Task>> &dups) overrid
       hrun::CALL_DUPLICATE(reinterpret_cast<PollTagMetadataTask*>(orig_task), dups);
       break;
     }
+    case Method::kPollTagMetadataPage: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<PollTagMetadataPageTask*>(orig_task), dups);
+      break;
+    }
+    case Method::kReserveAppend: {
+      hrun::CALL_DUPLICATE(reinterpret_cast<ReserveAppendTask*>(orig_task), dups);
+      break;
+    }
   }
 }
 /** Register the duplicate output with the origin task */
@@ -364,6 +396,14 @@ void DupEnd(u32 method, u32 replica, Task *orig_task, Task *dup_task) override {
       hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<PollTagMetadataTask*>(orig_task), reinterpret_cast<PollTagMetadataTask*>(dup_task));
       break;
     }
+    case Method::kPollTagMetadataPage: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<PollTagMetadataPageTask*>(orig_task), reinterpret_cast<PollTagMetadataPageTask*>(dup_task));
+      break;
+    }
+    case Method::kReserveAppend: {
+      hrun::CALL_DUPLICATE_END(replica, reinterpret_cast<ReserveAppendTask*>(orig_task), reinterpret_cast<ReserveAppendTask*>(dup_task));
+      break;
+    }
   }
 }
 /** Ensure there is space to store replicated outputs */
@@ -437,6 +477,14 @@ void ReplicateStart(u32 method, u32 count, Task *task) override {
       hrun::CALL_REPLICA_START(count, reinterpret_cast<PollTagMetadataTask*>(task));
       break;
     }
+    case Method::kPollTagMetadataPage: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<PollTagMetadataPageTask*>(task));
+      break;
+    }
+    case Method::kReserveAppend: {
+      hrun::CALL_REPLICA_START(count, reinterpret_cast<ReserveAppendTask*>(task));
+      break;
+    }
   }
 }
 /** Determine success and handle failures */
@@ -510,6 +558,14 @@ void ReplicateEnd(u32 method, Task *task) override {
       hrun::CALL_REPLICA_END(reinterpret_cast<PollTagMetadataTask*>(task));
       break;
     }
+    case Method::kPollTagMetadataPage: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<PollTagMetadataPageTask*>(task));
+      break;
+    }
+    case Method::kReserveAppend: {
+      hrun::CALL_REPLICA_END(reinterpret_cast<ReserveAppendTask*>(task));
+      break;
+    }
   }
 }
 /** Serialize a task when initially pushing into remote */
@@ -583,6 +639,14 @@ std::vector<DataTransfer> SaveStart(u32 method, BinaryOutputArchive<true> &ar, T
       ar << *reinterpret_cast<PollTagMetadataTask*>(task);
       break;
     }
+    case Method::kPollTagMetadataPage: {
+      ar << *reinterpret_cast<PollTagMetadataPageTask*>(task);
+      break;
+    }
+    case Method::kReserveAppend: {
+      ar << *reinterpret_cast<ReserveAppendTask*>(task);
+      break;
+    }
   }
   return ar.Get();
 }
@@ -675,6 +739,16 @@ TaskPointer LoadStart(u32 method, BinaryInputArchive<true> &ar) override {
       ar >> *reinterpret_cast<PollTagMetadataTask*>(task_ptr.ptr_);
       break;
     }
+    case Method::kPollTagMetadataPage: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<PollTagMetadataPageTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<PollTagMetadataPageTask*>(task_ptr.ptr_);
+      break;
+    }
+    case Method::kReserveAppend: {
+      task_ptr.ptr_ = HRUN_CLIENT->NewEmptyTask<ReserveAppendTask>(task_ptr.shm_);
+      ar >> *reinterpret_cast<ReserveAppendTask*>(task_ptr.ptr_);
+      break;
+    }
   }
   return task_ptr;
 }
@@ -749,6 +823,14 @@ std::vector<DataTransfer> SaveEnd(u32 method, BinaryOutputArchive<false> &ar, Ta
       ar << *reinterpret_cast<PollTagMetadataTask*>(task);
       break;
     }
+    case Method::kPollTagMetadataPage: {
+      ar << *reinterpret_cast<PollTagMetadataPageTask*>(task);
+      break;
+    }
+    case Method::kReserveAppend: {
+      ar << *reinterpret_cast<ReserveAppendTask*>(task);
+      break;
+    }
   }
   return ar.Get();
 }
@@ -823,6 +905,14 @@ void LoadEnd(u32 replica, u32 method, BinaryInputArchive<false> &ar, Task *task)
       ar.Deserialize(replica, *reinterpret_cast<PollTagMetadataTask*>(task));
       break;
     }
+    case Method::kPollTagMetadataPage: {
+      ar.Deserialize(replica, *reinterpret_cast<PollTagMetadataPageTask*>(task));
+      break;
+    }
+    case Method::kReserveAppend: {
+      ar.Deserialize(replica, *reinterpret_cast<ReserveAppendTask*>(task));
+      break;
+    }
   }
 }
 /** Get the grouping of the task */
@@ -879,6 +969,12 @@ u32 GetGroup(u32 method, Task *task, hshm::charbuf &group) override {
     case Method::kPollTagMetadata: {
       return reinterpret_cast<PollTagMetadataTask*>(task)->GetGroup(group);
     }
+    case Method::kPollTagMetadataPage: {
+      return reinterpret_cast<PollTagMetadataPageTask*>(task)->GetGroup(group);
+    }
+    case Method::kReserveAppend: {
+      return reinterpret_cast<ReserveAppendTask*>(task)->GetGroup(group);
+    }
   }
   return -1;
 }
@@ -158,14 +158,15 @@ struct UpdateSizeTask : public Task, TaskFlags<TF_SRL_SYM> {
               const TaskStateId &state_id,
               const TagId &tag_id,
               ssize_t update,
-              int mode) : Task(alloc) {
+              int mode,
+              u32 task_flags = TASK_LOW_LATENCY | TASK_FIRE_AND_FORGET) : Task(alloc) {
     // Initialize task
     task_node_ = task_node;
     lane_hash_ = tag_id.hash_;
     prio_ = TaskPrio::kLowLatency;
     task_state_ = state_id;
     method_ = Method::kUpdateSize;
-    task_flags_.SetBits(TASK_LOW_LATENCY | TASK_FIRE_AND_FORGET);
+    task_flags_.SetBits(task_flags);
     domain_id_ = domain_id;
 
     // Custom params
@@ -602,7 +603,7 @@ class DestroyTagPhase {
 struct DestroyTagTask : public Task, TaskFlags<TF_SRL_SYM> {
   IN TagId tag_id_;
   TEMP int phase_ = DestroyTagPhase::kDestroyBlobs;
-  TEMP hipc::ShmArchive<std::vector<blob_mdm::DestroyBlobTask*>> destroy_blob_tasks_;
+  TEMP hipc::ShmArchive<std::vector<blob_mdm::DestroyBlobsTask*>> destroy_blob_tasks_;
 
   /** SHM default constructor */
   HSHM_ALWAYS_INLINE explicit
@@ -765,6 +766,8 @@ struct TagRemoveTraitTask : public Task, TaskFlags<TF_SRL_SYM> {};
 /** A task to destroy all blobs in the tag */
 struct TagClearBlobsTask : public Task, TaskFlags<TF_SRL_SYM> {
   IN TagId tag_id_;
+  TEMP int phase_ = DestroyTagPhase::kDestroyBlobs;
+  TEMP hipc::ShmArchive<std::vector<blob_mdm::DestroyBlobsTask*>> destroy_blob_tasks_;
 
   /** SHM default constructor */
   HSHM_ALWAYS_INLINE explicit
@@ -1042,6 +1045,160 @@ struct PollTagMetadataTask : public Task, TaskFlags<TF_SRL_SYM_START | TF_SRL_AS
   }
 };
 
+/**
+ * Collect a page of tag summaries from one lane of one node,
+ * starting at \a cursor and filtered by \a query
+ * */
+struct PollTagMetadataPageTask : public Task, TaskFlags<TF_SRL_SYM> {
+  IN hipc::ShmArchive<hipc::string> query_;
+  INOUT MetadataCursor cursor_;
+  OUT hipc::ShmArchive<hipc::string> page_;
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  PollTagMetadataPageTask(hipc::Allocator *alloc) : Task(alloc) {}
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  PollTagMetadataPageTask(hipc::Allocator *alloc,
+                          const TaskNode &task_node,
+                          const TaskStateId &state_id,
+                          const TagQuery &query,
+                          const MetadataCursor &cursor) : Task(alloc) {
+    // Initialize task
+    task_node_ = task_node;
+    lane_hash_ = cursor.lane_;
+    prio_ = TaskPrio::kLowLatency;
+    task_state_ = state_id;
+    method_ = Method::kPollTagMetadataPage;
+    task_flags_.SetBits(0);
+    domain_id_ = DomainId::GetNode(cursor.node_id_);
+
+    // Custom params
+    std::stringstream ss;
+    {
+      cereal::BinaryOutputArchive ar(ss);
+      ar << query;
+    }
+    HSHM_MAKE_AR(query_, alloc, ss.str())
+    cursor_ = cursor;
+    HSHM_MAKE_AR0(page_, alloc)
+  }
+
+  /** Deserialize the filters */
+  TagQuery GetQuery() {
+    TagQuery query;
+    std::stringstream ss(query_->str());
+    cereal::BinaryInputArchive ar(ss);
+    ar >> query;
+    return query;
+  }
+
+  /** Serialize the page */
+  void SerializePage(const std::vector<TagStat> &page) {
+    std::stringstream ss;
+    {
+      cereal::BinaryOutputArchive ar(ss);
+      ar << page;
+    }
+    (*page_) = ss.str();
+  }
+
+  /** Deserialize the page */
+  std::vector<TagStat> DeserializePage() {
+    std::vector<TagStat> page;
+    std::stringstream ss(page_->str());
+    cereal::BinaryInputArchive ar(ss);
+    ar >> page;
+    return page;
+  }
+
+  /** Destructor */
+  ~PollTagMetadataPageTask() {
+    HSHM_DESTROY_AR(query_)
+    HSHM_DESTROY_AR(page_)
+  }
+
+  /** (De)serialize message call */
+  template<typename Ar>
+  void SerializeStart(Ar &ar) {
+    task_serialize<Ar>(ar);
+    ar(query_, cursor_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void SerializeEnd(u32 replica, Ar &ar) {
+    ar(cursor_, page_);
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    return TASK_UNORDERED;
+  }
+};
+
+/**
+ * Reserve a range of the bucket for appending. Appenders compute
+ * the pages of the range themselves and put them in parallel.
+ * */
+struct ReserveAppendTask : public Task, TaskFlags<TF_SRL_SYM> {
+  IN TagId tag_id_;
+  IN size_t size_;
+  OUT size_t off_;
+  OUT bitfield32_t flags_;
+
+  /** SHM default constructor */
+  HSHM_ALWAYS_INLINE explicit
+  ReserveAppendTask(hipc::Allocator *alloc) : Task(alloc) {}
+
+  /** Emplace constructor */
+  HSHM_ALWAYS_INLINE explicit
+  ReserveAppendTask(hipc::Allocator *alloc,
+                    const TaskNode &task_node,
+                    const DomainId &domain_id,
+                    const TaskStateId &state_id,
+                    const TagId &tag_id,
+                    size_t size) : Task(alloc) {
+    // Initialize task
+    task_node_ = task_node;
+    lane_hash_ = tag_id.hash_;
+    prio_ = TaskPrio::kLowLatency;
+    task_state_ = state_id;
+    method_ = Method::kReserveAppend;
+    task_flags_.SetBits(TASK_LOW_LATENCY);
+    domain_id_ = domain_id;
+
+    // Custom params
+    tag_id_ = tag_id;
+    size_ = size;
+    off_ = 0;
+  }
+
+  /** (De)serialize message call */
+  template<typename Ar>
+  void SerializeStart(Ar &ar) {
+    task_serialize<Ar>(ar);
+    ar(tag_id_, size_);
+  }
+
+  /** (De)serialize message return */
+  template<typename Ar>
+  void SerializeEnd(u32 replica, Ar &ar) {
+    ar(off_, flags_);
+  }
+
+  /** Create group */
+  HSHM_ALWAYS_INLINE
+  u32 GetGroup(hshm::charbuf &group) {
+    hrun::LocalSerialize srl(group);
+    srl << task_state_;
+    srl << lane_hash_;
+    return 0;
+  }
+};
+
 }  // namespace hermes::bucket_mdm
 
 #endif  // HRUN_TASKS_HERMES_BUCKET_MDM_INCLUDE_HERMES_BUCKET_MDM_HERMES_BUCKET_MDM_TASKS_H_
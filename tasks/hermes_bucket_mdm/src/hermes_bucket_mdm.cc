@@ -10,13 +10,25 @@
 #include "hermes/dpe/dpe_factory.h"
 #include "bdev/bdev.h"
 #include "data_stager/data_stager.h"
+#include "hermes/flat_hash_map.h"
+#include "hermes/metadata_log.h"
 
 namespace hermes::bucket_mdm {
 
-typedef std::unordered_map<hshm::charbuf, TagId> TAG_ID_MAP_T;
-typedef std::unordered_map<TagId, TagInfo> TAG_MAP_T;
+typedef FlatHashMap<hshm::charbuf, TagId> TAG_ID_MAP_T;
+typedef FlatHashMap<TagId, TagInfo> TAG_MAP_T;
+
+/** The url and parameters a staged bucket was created with */
+struct StagerParams {
+  std::string url_;
+  std::string params_;
+};
 
 class Server : public TaskLib {
+ public:
+  /** Most blobs destroyed by a single DestroyBlobs task */
+  static const size_t kMaxDestroyBatch = 4096;
+
  public:
   std::vector<TAG_ID_MAP_T> tag_id_map_;
   std::vector<TAG_MAP_T> tag_map_;
@@ -26,6 +38,14 @@ class Server : public TaskLib {
   blob_mdm::Client blob_mdm_;
   data_stager::Client stager_mdm_;
 
+  /**====================================
+   * Metadata recovery
+   * ===================================*/
+  std::vector<MetadataLog> mdm_logs_;  /**< Per lane, if recovery is enabled */
+  std::vector<std::unordered_map<TagId, StagerParams>> stagers_;
+  /** Stagers of recovered buckets, to register again */
+  std::vector<std::pair<TagId, StagerParams>> recovered_stagers_;
+
  public:
   Server() = default;
 
@@ -36,11 +56,163 @@ class Server : public TaskLib {
     bkt_mdm_.Init(id_, HRUN_ADMIN->queue_id_);
     tag_id_map_.resize(HRUN_QM_RUNTIME->max_lanes_);
     tag_map_.resize(HRUN_QM_RUNTIME->max_lanes_);
+    stagers_.resize(HRUN_QM_RUNTIME->max_lanes_);
+    if (HERMES_SERVER_CONF.recovery_.enabled_) {
+      RecoverTags();
+    }
     task->SetModuleComplete();
   }
   void MonitorConstruct(u32 mode, ConstructTask *task, RunContext &rctx) {
   }
 
+  /** Apply a logged record to the tags of \a lane */
+  void ReplayTagRecord(u32 lane, LogOp op, cereal::BinaryInputArchive &ar,
+                       bool &same_lanes) {
+    TAG_MAP_T &tag_map = tag_map_[lane];
+    TagId tag_id;
+    switch (op) {
+      case LogOp::kLanes: {
+        u32 logged_lanes;
+        ar(logged_lanes);
+        same_lanes &= logged_lanes == tag_map_.size();
+        break;
+      }
+      case LogOp::kPutTag: {
+        StagerParams stager;
+        ar(tag_id);
+        TagInfo &tag_info = tag_map[tag_id];
+        ar(tag_info, stager.url_, stager.params_);
+        if (tag_info.flags_.Any(HERMES_SHOULD_STAGE)) {
+          stagers_[lane][tag_id] = std::move(stager);
+        }
+        break;
+      }
+      case LogOp::kDelTag: {
+        ar(tag_id);
+        tag_map.erase(tag_id);
+        stagers_[lane].erase(tag_id);
+        break;
+      }
+      case LogOp::kTagSize: {
+        size_t internal_size;
+        ar(tag_id, internal_size);
+        tag_map[tag_id].internal_size_ = internal_size;
+        break;
+      }
+      case LogOp::kTagBlobs: {
+        BlobIdSet blobs;
+        ar(tag_id, blobs);
+        auto it = tag_map.find(tag_id);
+        if (it != tag_map.end()) {
+          it->second.blobs_ = std::move(blobs);
+        }
+        break;
+      }
+      case LogOp::kTagAddBlob:
+      case LogOp::kTagRemoveBlob: {
+        BlobId blob_id;
+        ar(tag_id, blob_id);
+        auto it = tag_map.find(tag_id);
+        if (it == tag_map.end()) {
+          break;
+        }
+        BlobIdSet &blobs = it->second.blobs_;
+        if (op == LogOp::kTagAddBlob) {
+          blobs.emplace(blob_id);
+        } else {
+          blobs.erase(blob_id);
+        }
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+
+  /**
+   * Reload the tags logged before a restart, and snapshot every lane.
+   * Traits are not recovered. Staged buckets register their stagers
+   * again once the stager is known.
+   * */
+  void RecoverTags() {
+    RecoveryInfo &recovery = HERMES_SERVER_CONF.recovery_;
+    u32 num_lanes = tag_map_.size();
+    size_t num_records = 0;
+    bool same_lanes = true;
+    mdm_logs_.resize(num_lanes);
+    for (u32 lane = 0; lane < num_lanes; ++lane) {
+      MetadataLog &log = mdm_logs_[lane];
+      log.Init(recovery.path_, hshm::Formatter::format(
+          "bucket_mdm.{}.{}", node_id_, lane));
+      num_records += log.Replay(
+          [&](LogOp op, cereal::BinaryInputArchive &ar) {
+            ReplayTagRecord(lane, op, ar, same_lanes);
+          });
+    }
+    if (!same_lanes) {
+      // Tags would be looked up in the wrong lanes
+      HELOG(kError, "(node {}) Not recovering tags: the number of lanes "
+            "changed to {}", node_id_, num_lanes);
+      for (u32 lane = 0; lane < num_lanes; ++lane) {
+        tag_map_[lane].clear();
+        stagers_[lane].clear();
+      }
+    }
+    size_t num_tags = 0;
+    u64 max_unique = 0;
+    for (u32 lane = 0; lane < num_lanes; ++lane) {
+      for (TAG_MAP_T::value_type &tag_part : tag_map_[lane]) {
+        TagInfo &tag_info = tag_part.second;
+        max_unique = std::max(max_unique, tag_info.tag_id_.unique_);
+        if (tag_info.name_.size()) {
+          tag_id_map_[lane].emplace(tag_info.name_, tag_info.tag_id_);
+        }
+        ++num_tags;
+      }
+      for (auto &stager : stagers_[lane]) {
+        recovered_stagers_.emplace_back(stager);
+      }
+      SnapshotLane(lane);
+    }
+    if (num_records > 0) {
+      id_alloc_ = max_unique + 1;
+    }
+    HILOG(kInfo, "(node {}) Recovered {} tags from {} records",
+          node_id_, num_tags, num_records);
+  }
+
+  /** Replace the snapshot of a lane with its tags and restart its log */
+  void SnapshotLane(u32 lane) {
+    TAG_MAP_T &tag_map = tag_map_[lane];
+    std::unordered_map<TagId, StagerParams> &stagers = stagers_[lane];
+    mdm_logs_[lane].Snapshot([&](MetadataLog::Writer &writer) {
+      writer.Append(LogOp::kLanes, (u32)tag_map_.size());
+      StagerParams none;
+      for (TAG_MAP_T::value_type &tag_part : tag_map) {
+        auto it = stagers.find(tag_part.first);
+        StagerParams &stager = it != stagers.end() ? it->second : none;
+        writer.Append(LogOp::kPutTag, tag_part.first, tag_part.second,
+                      stager.url_, stager.params_);
+        writer.Append(LogOp::kTagBlobs, tag_part.first,
+                      tag_part.second.blobs_);
+      }
+    });
+  }
+
+  /** Log a change to a tag */
+  template<typename ...Args>
+  void LogTag(RunContext &rctx, LogOp op, const Args& ...args) {
+    if (mdm_logs_.empty()) {
+      return;
+    }
+    MetadataLog &log = mdm_logs_[rctx.lane_id_];
+    log.Append(op, args...);
+    if (log.NeedsSnapshot(HERMES_SERVER_CONF.recovery_.snapshot_log_size_)) {
+      SnapshotLane(rctx.lane_id_);
+    }
+  }
+
   /** Destroy bucket mdm */
   void Destruct(DestructTask *task, RunContext &rctx) {
     task->SetModuleComplete();
@@ -54,6 +226,14 @@ class Server : public TaskLib {
   void SetBlobMdm(SetBlobMdmTask *task, RunContext &rctx) {
     blob_mdm_.Init(task->blob_mdm_, HRUN_ADMIN->queue_id_);
     stager_mdm_.Init(task->stager_mdm_, HRUN_ADMIN->queue_id_);
+    for (auto &recovered : recovered_stagers_) {
+      StagerParams &stager = recovered.second;
+      stager_mdm_.AsyncRegisterStager(task->task_node_ + 1,
+                                      recovered.first,
+                                      hshm::charbuf(stager.url_),
+                                      hshm::charbuf(stager.params_));
+    }
+    recovered_stagers_.clear();
     task->SetModuleComplete();
   }
   void MonitorSetBlobMdm(u32 mode, SetBlobMdmTask *task, RunContext &rctx) {
@@ -62,7 +242,13 @@ class Server : public TaskLib {
   /** Update the size of the bucket */
   void UpdateSize(UpdateSizeTask *task, RunContext &rctx) {
     TAG_MAP_T &tag_map = tag_map_[rctx.lane_id_];
-    TagInfo &tag_info = tag_map[task->tag_id_];
+    auto it = tag_map.find(task->tag_id_);
+    if (it == tag_map.end()) {
+      // Late batched updates of a destroyed tag
+      task->SetModuleComplete();
+      return;
+    }
+    TagInfo &tag_info = it->second;
     ssize_t internal_size = (ssize_t) tag_info.internal_size_;
     if (task->mode_ == UpdateSizeMode::kAdd) {
       internal_size += task->update_;
@@ -72,11 +258,43 @@ class Server : public TaskLib {
     HILOG(kDebug, "Updating size of tag {} from {} to {} with update {} (mode={})",
           task->tag_id_, tag_info.internal_size_, internal_size, task->update_, task->mode_)
     tag_info.internal_size_ = (size_t) internal_size;
+    LogTag(rctx, LogOp::kTagSize, task->tag_id_, tag_info.internal_size_);
     task->SetModuleComplete();
   }
   void MonitorUpdateSize(u32 mode, UpdateSizeTask *task, RunContext &rctx) {
   }
 
+  /**
+   * Reserve \a size bytes past the end of the bucket. The size only grows
+   * once the appended blobs are put, so the ranges handed out are tracked
+   * separately to keep concurrent appends from overlapping.
+   * */
+  size_t ReserveAppendRange(TagInfo &tag_info, size_t size) {
+    size_t off = std::max(tag_info.append_off_, tag_info.internal_size_);
+    tag_info.append_off_ = off + size;
+    return off;
+  }
+
+  /** Reserve a range of the bucket for a client-side append */
+  void ReserveAppend(ReserveAppendTask *task, RunContext &rctx) {
+    TAG_MAP_T &tag_map = tag_map_[rctx.lane_id_];
+    auto it = tag_map.find(task->tag_id_);
+    if (it == tag_map.end()) {
+      task->off_ = 0;
+      task->SetModuleComplete();
+      return;
+    }
+    TagInfo &tag_info = it->second;
+    task->off_ = ReserveAppendRange(tag_info, task->size_);
+    task->flags_ = tag_info.flags_;
+    HILOG(kDebug, "(node {}) Reserved {} bytes at {} in tag {}",
+          HRUN_CLIENT->node_id_, task->size_, task->off_, task->tag_id_)
+    task->SetModuleComplete();
+  }
+  void MonitorReserveAppend(u32 mode, ReserveAppendTask *task,
+                            RunContext &rctx) {
+  }
+
   /**
    * Create the PartialPuts for append operations.
    * */
@@ -87,7 +305,7 @@ class Server : public TaskLib {
               HRUN_CLIENT->node_id_, task->tag_id_, task->task_node_)
         TAG_MAP_T &tag_map = tag_map_[rctx.lane_id_];
         TagInfo &tag_info = tag_map[task->tag_id_];
-        size_t bucket_size = tag_info.internal_size_;
+        size_t bucket_size = ReserveAppendRange(tag_info, task->data_size_);
         size_t cur_page = bucket_size / task->page_size_;
         size_t cur_page_off = bucket_size % task->page_size_;
         size_t update_size = task->page_size_ - cur_page_off;
@@ -178,7 +396,8 @@ class Server : public TaskLib {
                                                     append.blob_off_,
                                                     append.data_size_,
                                                     task->data_ + buf_off,
-                                                    task->score_, 0,
+                                                    task->score_,
+                                                    HERMES_BLOB_APPEND,
                                                     ctx, 0).ptr_;
           HILOG(kDebug, "(node {}) Finished spawning blob {} of size {} for tag {} (task_node={} blob_mdm={})",
                 HRUN_CLIENT->node_id_, append.blob_name_.str(), append.data_size_,
@@ -236,13 +455,21 @@ class Server : public TaskLib {
       tag_info.tag_id_ = tag_id;
       tag_info.owner_ = task->blob_owner_;
       tag_info.internal_size_ = task->backend_size_;
+      StagerParams stager;
       if (task->flags_.Any(HERMES_SHOULD_STAGE)) {
         stager_mdm_.AsyncRegisterStager(task->task_node_ + 1,
                                         tag_id,
                                         hshm::charbuf(task->tag_name_->str()),
                                         hshm::charbuf(task->params_->str()));
         tag_info.flags_.SetBits(HERMES_SHOULD_STAGE);
+        if (!mdm_logs_.empty()) {
+          stager.url_ = task->tag_name_->str();
+          stager.params_ = task->params_->str();
+          stagers_[rctx.lane_id_][tag_id] = stager;
+        }
       }
+      LogTag(rctx, LogOp::kPutTag, tag_id, tag_info,
+             stager.url_, stager.params_);
     } else {
       if (tag_name.size()) {
         HILOG(kDebug, "Found existing tag: {}", tag_name.str())
@@ -304,6 +531,51 @@ class Server : public TaskLib {
   void MonitorRenameTag(u32 mode, RenameTagTask *task, RunContext &rctx) {
   }
 
+  /**
+   * Destroy the \a blobs of \a tag_id with one DestroyBlobs task per
+   * batch of blobs owned by the same lane of the same blob mdm. The tasks
+   * are appended to \a blob_tasks for the caller to wait on.
+   * */
+  void DestroyBlobsBulk(Task *task, const TagId &tag_id,
+                        const BlobIdSet &blobs,
+                        std::vector<blob_mdm::DestroyBlobsTask*> &blob_tasks) {
+    u32 num_lanes = HRUN_QM_RUNTIME->max_lanes_;
+    std::unordered_map<u64, std::vector<BlobId>> batches;
+    auto flush = [&](std::vector<BlobId> &batch) {
+      blob_tasks.emplace_back(
+          blob_mdm_.AsyncDestroyBlobs(task->task_node_ + 1, tag_id,
+                                      batch, false).ptr_);
+      batch.clear();
+    };
+    for (const BlobId &blob_id : blobs) {
+      u64 owner = ((u64)blob_id.node_id_ << 32) | (blob_id.hash_ % num_lanes);
+      std::vector<BlobId> &batch = batches[owner];
+      batch.emplace_back(blob_id);
+      if (batch.size() >= kMaxDestroyBatch) {
+        flush(batch);
+      }
+    }
+    for (auto &batch : batches) {
+      if (!batch.second.empty()) {
+        flush(batch.second);
+      }
+    }
+  }
+
+  /** Whether the DestroyBlobs tasks are done. Deletes them if so. */
+  bool WaitDestroyBlobs(
+      std::vector<blob_mdm::DestroyBlobsTask*> &blob_tasks) {
+    for (blob_mdm::DestroyBlobsTask *&blob_task : blob_tasks) {
+      if (!blob_task->IsComplete()) {
+        return false;
+      }
+    }
+    for (blob_mdm::DestroyBlobsTask *&blob_task : blob_tasks) {
+      HRUN_CLIENT->DelTask(blob_task);
+    }
+    return true;
+  }
+
   /** Destroy tag */
   void DestroyTag(DestroyTagTask *task, RunContext &rctx) {
     switch (task->phase_) {
@@ -313,14 +585,8 @@ class Server : public TaskLib {
         TagInfo &tag = tag_map[task->tag_id_];
         tag_id_map.erase(tag.name_);
         HSHM_MAKE_AR0(task->destroy_blob_tasks_, nullptr);
-        std::vector<blob_mdm::DestroyBlobTask*> blob_tasks = *task->destroy_blob_tasks_;
-        blob_tasks.reserve(tag.blobs_.size());
-        for (BlobId &blob_id : tag.blobs_) {
-          blob_mdm::DestroyBlobTask *blob_task =
-              blob_mdm_.AsyncDestroyBlob(task->task_node_ + 1,
-                                         task->tag_id_, blob_id, false).ptr_;
-          blob_tasks.emplace_back(blob_task);
-        }
+        DestroyBlobsBulk(task, task->tag_id_, tag.blobs_,
+                         *task->destroy_blob_tasks_);
         stager_mdm_.AsyncUnregisterStager(task->task_node_ + 1,
                                           task->tag_id_);
         HILOG(kDebug, "Destroying the tag: {}", tag.name_.str());
@@ -328,18 +594,14 @@ class Server : public TaskLib {
         return;
       }
       case DestroyTagPhase::kWaitDestroyBlobs: {
-        std::vector<blob_mdm::DestroyBlobTask*> blob_tasks = *task->destroy_blob_tasks_;
-        for (blob_mdm::DestroyBlobTask *&blob_task : blob_tasks) {
-          if (!blob_task->IsComplete()) {
-            return;
-          }
-        }
-        for (blob_mdm::DestroyBlobTask *&blob_task : blob_tasks) {
-          HRUN_CLIENT->DelTask(blob_task);
+        if (!WaitDestroyBlobs(*task->destroy_blob_tasks_)) {
+          return;
         }
         HSHM_DESTROY_AR(task->destroy_blob_tasks_);
         TAG_MAP_T &tag_map = tag_map_[rctx.lane_id_];
         tag_map.erase(task->tag_id_);
+        stagers_[rctx.lane_id_].erase(task->tag_id_);
+        LogTag(rctx, LogOp::kDelTag, task->tag_id_);
         HILOG(kDebug, "Finished destroying the tag");
         task->SetModuleComplete();
       }
@@ -357,7 +619,9 @@ class Server : public TaskLib {
       return;
     }
     TagInfo &tag = it->second;
-    tag.blobs_.emplace_back(task->blob_id_);
+    if (tag.blobs_.emplace(task->blob_id_)) {
+      LogTag(rctx, LogOp::kTagAddBlob, task->tag_id_, task->blob_id_);
+    }
     task->SetModuleComplete();
   }
   void MonitorTagAddBlob(u32 mode, TagAddBlobTask *task, RunContext &rctx) {
@@ -372,8 +636,9 @@ class Server : public TaskLib {
       return;
     }
     TagInfo &tag = it->second;
-    auto blob_it = std::find(tag.blobs_.begin(), tag.blobs_.end(), task->blob_id_);
-    tag.blobs_.erase(blob_it);
+    if (tag.blobs_.erase(task->blob_id_)) {
+      LogTag(rctx, LogOp::kTagRemoveBlob, task->tag_id_, task->blob_id_);
+    }
     task->SetModuleComplete();
   }
   void MonitorTagRemoveBlob(u32 mode, TagRemoveBlobTask *task, RunContext &rctx) {
@@ -381,21 +646,35 @@ class Server : public TaskLib {
 
   /** Clear blobs from a tag */
   void TagClearBlobs(TagClearBlobsTask *task, RunContext &rctx) {
-    TAG_MAP_T &tag_map = tag_map_[rctx.lane_id_];
-    auto it = tag_map.find(task->tag_id_);
-    if (it == tag_map.end()) {
-      task->SetModuleComplete();
-      return;
-    }
-    TagInfo &tag = it->second;
-    if (tag.owner_) {
-      for (BlobId &blob_id : tag.blobs_) {
-        blob_mdm_.AsyncDestroyBlob(task->task_node_ + 1, task->tag_id_, blob_id);
+    switch (task->phase_) {
+      case DestroyTagPhase::kDestroyBlobs: {
+        TAG_MAP_T &tag_map = tag_map_[rctx.lane_id_];
+        auto it = tag_map.find(task->tag_id_);
+        if (it == tag_map.end()) {
+          task->SetModuleComplete();
+          return;
+        }
+        TagInfo &tag = it->second;
+        HSHM_MAKE_AR0(task->destroy_blob_tasks_, nullptr);
+        if (tag.owner_) {
+          DestroyBlobsBulk(task, task->tag_id_, tag.blobs_,
+                           *task->destroy_blob_tasks_);
+        }
+        tag.blobs_.clear();
+        tag.internal_size_ = 0;
+        tag.append_off_ = 0;
+        LogTag(rctx, LogOp::kTagBlobs, task->tag_id_, tag.blobs_);
+        LogTag(rctx, LogOp::kTagSize, task->tag_id_, tag.internal_size_);
+        task->phase_ = DestroyTagPhase::kWaitDestroyBlobs;
+      }
+      case DestroyTagPhase::kWaitDestroyBlobs: {
+        if (!WaitDestroyBlobs(*task->destroy_blob_tasks_)) {
+          return;
+        }
+        HSHM_DESTROY_AR(task->destroy_blob_tasks_);
+        task->SetModuleComplete();
       }
     }
-    tag.blobs_.clear();
-    tag.internal_size_ = 0;
-    task->SetModuleComplete();
   }
   void MonitorTagClearBlobs(u32 mode, TagClearBlobsTask *task, RunContext &rctx) {
   }
@@ -427,7 +706,7 @@ class Server : public TaskLib {
     TagInfo &tag = it->second;
     hipc::vector<BlobId> &blobs = (*task->blob_ids_);
     blobs.reserve(tag.blobs_.size());
-    for (BlobId &blob_id : tag.blobs_) {
+    for (const BlobId &blob_id : tag.blobs_) {
       blobs.emplace_back(blob_id);
     }
     task->SetModuleComplete();
@@ -443,7 +722,7 @@ class Server : public TaskLib {
     TAG_MAP_T &blob_map = tag_map_[rctx.lane_id_];
     std::vector<TagInfo> tag_mdms;
     tag_mdms.reserve(blob_map.size());
-    for (const std::pair<TagId, TagInfo> &tag_part : blob_map) {
+    for (const TAG_MAP_T::value_type &tag_part : blob_map) {
       const TagInfo &tag_info = tag_part.second;
       tag_mdms.emplace_back(tag_info);
     }
@@ -453,6 +732,41 @@ class Server : public TaskLib {
   void MonitorPollTagMetadata(u32 mode, PollTagMetadataTask *task, RunContext &rctx) {
   }
 
+  /**
+   * Get a page of tag summaries from this lane, examining at most a
+   * few pages worth of tags
+   * */
+  HSHM_ALWAYS_INLINE
+  void PollTagMetadataPage(PollTagMetadataPageTask *task, RunContext &rctx) {
+    TAG_MAP_T &tag_map = tag_map_[rctx.lane_id_];
+    TagQuery query = task->GetQuery();
+    MetadataCursor &cursor = task->cursor_;
+    size_t page_size = std::max<size_t>(query.page_size_, 1);
+    size_t max_scan = page_size * MetadataCursor::kMaxScanPages;
+    std::vector<TagStat> page;
+    page.reserve(std::min(page_size, tag_map.size()));
+    TAG_MAP_T::iterator it = tag_map.begin_from(cursor.slot_);
+    for (size_t scanned = 0;
+         it != tag_map.end() && page.size() < page_size &&
+         scanned < max_scan; ++it, ++scanned) {
+      if (query.Match(it->second)) {
+        page.emplace_back(it->second);
+      }
+    }
+    cursor.node_id_ = node_id_;
+    cursor.lane_ = rctx.lane_id_;
+    if (it == tag_map.end()) {
+      cursor.NextLane(tag_map_.size(), HRUN_RPC->GetNumHosts());
+    } else {
+      cursor.slot_ = it.slot();
+    }
+    task->SerializePage(page);
+    task->SetModuleComplete();
+  }
+  void MonitorPollTagMetadataPage(u32 mode, PollTagMetadataPageTask *task,
+                                  RunContext &rctx) {
+  }
+
  public:
 #include "hermes_bucket_mdm/hermes_bucket_mdm_lib_exec.h"
 };
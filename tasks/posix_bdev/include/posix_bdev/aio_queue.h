@@ -0,0 +1,226 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HRUN_TASKS_POSIX_BDEV_INCLUDE_POSIX_BDEV_AIO_QUEUE_H_
+#define HRUN_TASKS_POSIX_BDEV_INCLUDE_POSIX_BDEV_AIO_QUEUE_H_
+
+#ifdef HERMES_LIBAIO
+
+#include <libaio.h>
+#include <cstring>
+#include <vector>
+#include "hermes/hermes_types.h"
+#include "bdev/io_segment.h"
+
+namespace hermes::posix_bdev {
+
+using bdev::AsyncIo;
+
+/**
+ * A long-lived kernel AIO context over one file, for kernels without
+ * io_uring. Driven like UringQueue: a task takes an iocb from the ring on
+ * its first poll, the iocbs taken during a worker's pass are submitted
+ * together by the next poll, and every poll reaps without blocking.
+ * Not thread-safe: posix_bdev keeps one per priority and lane.
+ * */
+class AioQueue {
+ public:
+  io_context_t ctx_ = 0;
+  bool is_init_ = false;
+  int fd_ = -1;
+  std::vector<struct iocb> iocbs_;       /**< The ring of iocbs */
+  std::vector<struct iocb*> free_;       /**< iocbs not in flight */
+  std::vector<struct iocb*> queued_;     /**< iocbs not yet submitted */
+  std::vector<struct io_event> events_;  /**< Reaped completions */
+
+ public:
+  /** Default constructor */
+  AioQueue() = default;
+
+  /** Contexts are not copyable */
+  AioQueue(const AioQueue &other) = delete;
+  AioQueue& operator=(const AioQueue &other) = delete;
+
+  /** Destructor */
+  ~AioQueue() {
+    Shutdown();
+  }
+
+  /** Create a context of \a depth requests over \a fd */
+  bool Init(int fd, u32 depth) {
+    int ret = io_setup((int)depth, &ctx_);
+    if (ret < 0) {
+      HELOG(kError, "io_setup failed: {}", strerror(-ret));
+      return false;
+    }
+    is_init_ = true;
+    fd_ = fd;
+    iocbs_.resize(depth);
+    free_.reserve(depth);
+    for (struct iocb &cb : iocbs_) {
+      free_.emplace_back(&cb);
+    }
+    queued_.reserve(depth);
+    events_.resize(depth);
+    return true;
+  }
+
+  /** Tear down the context */
+  void Shutdown() {
+    if (is_init_) {
+      io_destroy(ctx_);
+      is_init_ = false;
+    }
+  }
+
+  /**
+   * Queue the untransferred part of \a io. It is submitted by the next
+   * Submit. Returns false if every iocb is in flight.
+   * */
+  bool Queue(AsyncIo &io, bool is_write,
+             const char *buf, size_t size, size_t off) {
+    if (free_.empty()) {
+      return false;
+    }
+    struct iocb *cb = free_.back();
+    free_.pop_back();
+    char *ptr = const_cast<char*>(buf) + io.done_;
+    size_t len = size - io.done_;
+    long long pos = (long long)(off + io.done_);
+    if (is_write) {
+      io_prep_pwrite(cb, fd_, ptr, len, pos);
+    } else {
+      io_prep_pread(cb, fd_, ptr, len, pos);
+    }
+    cb->data = &io;
+    queued_.emplace_back(cb);
+    io.pending_ = true;
+    return true;
+  }
+
+  /**
+   * Queue the untransferred part of a vectored \a io of \a size bytes
+   * at \a off. \a iov is advanced past the bytes already transferred and
+   * must stay valid until the request completes.
+   * */
+  bool QueueV(AsyncIo &io, bool is_write, std::vector<struct iovec> &iov,
+              size_t size, size_t off) {
+    if (free_.empty()) {
+      return false;
+    }
+    struct iocb *cb = free_.back();
+    free_.pop_back();
+    bdev::SkipTransferred(io, iov, size);
+    long long pos = (long long)(off + io.done_);
+    if (is_write) {
+      io_prep_pwritev(cb, fd_, iov.data(), (int)iov.size(), pos);
+    } else {
+      io_prep_preadv(cb, fd_, iov.data(), (int)iov.size(), pos);
+    }
+    cb->data = &io;
+    queued_.emplace_back(cb);
+    io.pending_ = true;
+    return true;
+  }
+
+  /** Submit every queued iocb in one system call */
+  void Submit() {
+    if (queued_.empty()) {
+      return;
+    }
+    int ret = io_submit(ctx_, (long)queued_.size(), queued_.data());
+    if (ret < 0) {
+      if (ret != -EAGAIN) {
+        HELOG(kError, "io_submit failed: {}", strerror(-ret));
+        FailQueued(ret);
+      }
+      return;
+    }
+    // The kernel may take a prefix; the rest go with the next Submit
+    queued_.erase(queued_.begin(), queued_.begin() + ret);
+  }
+
+  /** Fail the queued iocbs with \a err */
+  void FailQueued(int err) {
+    for (struct iocb *cb : queued_) {
+      AsyncIo *io = reinterpret_cast<AsyncIo*>(cb->data);
+      io->err_ = err;
+      io->pending_ = false;
+      free_.emplace_back(cb);
+    }
+    queued_.clear();
+  }
+
+  /** Complete every request the kernel has finished, without blocking */
+  void Reap() {
+    if (free_.size() + queued_.size() == iocbs_.size()) {
+      return;
+    }
+    struct timespec timeout{0, 0};
+    int ret = io_getevents(ctx_, 0, (long)events_.size(),
+                           events_.data(), &timeout);
+    if (ret < 0) {
+      if (ret != -EINTR) {
+        HELOG(kError, "io_getevents failed: {}", strerror(-ret));
+      }
+      return;
+    }
+    for (int i = 0; i < ret; ++i) {
+      struct io_event &event = events_[i];
+      AsyncIo *io = reinterpret_cast<AsyncIo*>(event.data);
+      long res = (long)event.res;
+      if (res < 0) {
+        io->err_ = (int)res;
+      } else if (res == 0) {
+        io->err_ = -EIO;
+      } else {
+        io->done_ += (size_t)res;
+      }
+      io->pending_ = false;
+      free_.emplace_back(event.obj);
+    }
+  }
+
+  /**
+   * Make progress on \a io. A new or short transfer is queued and left
+   * for the next poll to submit, so the iocbs of a poll pass are batched.
+   * Returns true once the transfer is done.
+   * */
+  bool Poll(AsyncIo &io, bool is_write,
+            const char *buf, size_t size, size_t off) {
+    if (!io.pending_ && !io.IsDone(size) &&
+        Queue(io, is_write, buf, size, off)) {
+      return false;
+    }
+    Submit();
+    Reap();
+    return io.IsDone(size);
+  }
+
+  /** Poll for a vectored transfer of \a size bytes, as with Poll */
+  bool PollV(AsyncIo &io, bool is_write, std::vector<struct iovec> &iov,
+             size_t size, size_t off) {
+    if (!io.pending_ && !io.IsDone(size) &&
+        QueueV(io, is_write, iov, size, off)) {
+      return false;
+    }
+    Submit();
+    Reap();
+    return io.IsDone(size);
+  }
+};
+
+}  // namespace hermes::posix_bdev
+
+#endif  // HERMES_LIBAIO
+
+#endif  // HRUN_TASKS_POSIX_BDEV_INCLUDE_POSIX_BDEV_AIO_QUEUE_H_
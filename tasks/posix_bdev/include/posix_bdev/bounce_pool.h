@@ -0,0 +1,101 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HRUN_TASKS_POSIX_BDEV_INCLUDE_POSIX_BDEV_BOUNCE_POOL_H_
+#define HRUN_TASKS_POSIX_BDEV_INCLUDE_POSIX_BDEV_BOUNCE_POOL_H_
+
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+#include "hermes/hermes_types.h"
+
+namespace hermes::posix_bdev {
+
+/**
+ * Block-aligned buffers for the direct I/O of requests that are not
+ * aligned in memory, offset, or size. Released buffers are kept by size,
+ * up to max_free_ of each, so a steady workload stops allocating.
+ * Not thread-safe: posix_bdev keeps one per priority and lane.
+ * */
+class BouncePool {
+ public:
+  size_t align_ = 4096;
+  size_t max_free_ = 16;
+  std::unordered_map<size_t, std::vector<char*>> free_;
+
+ public:
+  /** Default constructor */
+  BouncePool() = default;
+
+  /** Pools own their buffers */
+  BouncePool(const BouncePool &other) = delete;
+  BouncePool& operator=(const BouncePool &other) = delete;
+
+  /** Destructor */
+  ~BouncePool() {
+    for (auto &free_part : free_) {
+      for (char *buf : free_part.second) {
+        free(buf);
+      }
+    }
+  }
+
+  /** Align buffers to \a align bytes and keep \a max_free of each size */
+  void Init(size_t align, size_t max_free) {
+    align_ = align;
+    max_free_ = max_free;
+  }
+
+  /** Round \a size up to a multiple of the alignment */
+  size_t AlignUp(size_t size) const {
+    return (size + align_ - 1) / align_ * align_;
+  }
+
+  /** Round \a off down to a multiple of the alignment */
+  size_t AlignDown(size_t off) const {
+    return off / align_ * align_;
+  }
+
+  /** Whether a transfer of \a buf can be direct without a bounce buffer */
+  bool IsAligned(const void *buf, size_t size, size_t off) const {
+    return (size_t)buf % align_ == 0 &&
+        size % align_ == 0 && off % align_ == 0;
+  }
+
+  /**
+   * Get an aligned buffer of \a size bytes, a multiple of the alignment.
+   * Returns nullptr if memory is exhausted.
+   * */
+  char* Allocate(size_t size) {
+    auto it = free_.find(size);
+    if (it != free_.end() && !it->second.empty()) {
+      char *buf = it->second.back();
+      it->second.pop_back();
+      return buf;
+    }
+    return reinterpret_cast<char*>(aligned_alloc(align_, size));
+  }
+
+  /** Return a buffer of \a size bytes from Allocate */
+  void Free(char *buf, size_t size) {
+    std::vector<char*> &bufs = free_[size];
+    if (bufs.size() < max_free_) {
+      bufs.emplace_back(buf);
+    } else {
+      free(buf);
+    }
+  }
+};
+
+}  // namespace hermes::posix_bdev
+
+#endif  // HRUN_TASKS_POSIX_BDEV_INCLUDE_POSIX_BDEV_BOUNCE_POOL_H_
@@ -0,0 +1,237 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef HRUN_TASKS_POSIX_BDEV_INCLUDE_POSIX_BDEV_IO_URING_QUEUE_H_
+#define HRUN_TASKS_POSIX_BDEV_INCLUDE_POSIX_BDEV_IO_URING_QUEUE_H_
+
+#ifdef HERMES_IO_URING
+
+#include <liburing.h>
+#include <sys/uio.h>
+#include <cstring>
+#include <vector>
+#include "hermes/hermes_types.h"
+#include "bdev/io_segment.h"
+
+namespace hermes::posix_bdev {
+
+using bdev::AsyncIo;
+
+/**
+ * An io_uring over one file, driven by the polls of the tasks using it.
+ * A task queues an SQE on its first poll and the SQEs queued during a
+ * worker's pass are submitted together by the next poll. Every poll reaps
+ * the completions of all tasks on the ring. Not thread-safe: posix_bdev
+ * keeps one per priority and lane, since each pair is only polled by one
+ * worker at a time.
+ * */
+class UringQueue {
+ public:
+  struct io_uring ring_;
+  bool is_init_ = false;
+  int fd_ = -1;               /**< The file, or its index if registered */
+  bool fixed_file_ = false;   /**< Whether the file is registered */
+  u32 depth_ = 0;             /**< Most requests in flight */
+  u32 inflight_ = 0;          /**< Requests queued and not reaped */
+  std::vector<struct iovec> bufs_;  /**< Registered buffers */
+
+ public:
+  /** Default constructor */
+  UringQueue() = default;
+
+  /** Rings are not copyable */
+  UringQueue(const UringQueue &other) = delete;
+  UringQueue& operator=(const UringQueue &other) = delete;
+
+  /** Destructor */
+  ~UringQueue() {
+    Shutdown();
+  }
+
+  /** Create a ring of \a depth entries over \a fd */
+  bool Init(int fd, u32 depth) {
+    int ret = io_uring_queue_init(depth, &ring_, 0);
+    if (ret < 0) {
+      HELOG(kError, "io_uring_queue_init failed: {}", strerror(-ret));
+      return false;
+    }
+    is_init_ = true;
+    depth_ = depth;
+    fd_ = fd;
+    if (io_uring_register_files(&ring_, &fd, 1) == 0) {
+      fd_ = 0;
+      fixed_file_ = true;
+    }
+    return true;
+  }
+
+  /**
+   * Register \a bufs so transfers inside them skip the per-request page
+   * mapping. Registered memory is pinned and each buffer is at most 1GB.
+   * */
+  bool RegisterBuffers(const std::vector<struct iovec> &bufs) {
+    int ret = io_uring_register_buffers(&ring_, bufs.data(), bufs.size());
+    if (ret < 0) {
+      HELOG(kWarning, "io_uring_register_buffers failed: {}", strerror(-ret));
+      return false;
+    }
+    bufs_ = bufs;
+    return true;
+  }
+
+  /** Tear down the ring */
+  void Shutdown() {
+    if (is_init_) {
+      io_uring_queue_exit(&ring_);
+      is_init_ = false;
+    }
+  }
+
+  /** The registered buffer containing [buf, buf + size), or -1 */
+  int FindBuffer(const char *buf, size_t size) const {
+    for (size_t i = 0; i < bufs_.size(); ++i) {
+      const char *base = reinterpret_cast<const char*>(bufs_[i].iov_base);
+      if (base <= buf && buf + size <= base + bufs_[i].iov_len) {
+        return (int)i;
+      }
+    }
+    return -1;
+  }
+
+  /**
+   * Queue the untransferred part of \a io. It is submitted by the next
+   * Submit. Returns false if the ring is full.
+   * */
+  bool Queue(AsyncIo &io, bool is_write,
+             const char *buf, size_t size, size_t off) {
+    if (inflight_ >= depth_) {
+      return false;
+    }
+    struct io_uring_sqe *sqe = io_uring_get_sqe(&ring_);
+    if (sqe == nullptr) {
+      return false;
+    }
+    char *ptr = const_cast<char*>(buf) + io.done_;
+    unsigned len = (unsigned)(size - io.done_);
+    off_t pos = (off_t)(off + io.done_);
+    int buf_idx = FindBuffer(ptr, len);
+    if (is_write && buf_idx >= 0) {
+      io_uring_prep_write_fixed(sqe, fd_, ptr, len, pos, buf_idx);
+    } else if (is_write) {
+      io_uring_prep_write(sqe, fd_, ptr, len, pos);
+    } else if (buf_idx >= 0) {
+      io_uring_prep_read_fixed(sqe, fd_, ptr, len, pos, buf_idx);
+    } else {
+      io_uring_prep_read(sqe, fd_, ptr, len, pos);
+    }
+    if (fixed_file_) {
+      io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+    }
+    io_uring_sqe_set_data(sqe, &io);
+    io.pending_ = true;
+    ++inflight_;
+    return true;
+  }
+
+  /**
+   * Queue the untransferred part of a vectored \a io of \a size bytes
+   * at \a off. \a iov is advanced past the bytes already transferred and
+   * must stay valid until the request completes.
+   * */
+  bool QueueV(AsyncIo &io, bool is_write, std::vector<struct iovec> &iov,
+              size_t size, size_t off) {
+    if (inflight_ >= depth_) {
+      return false;
+    }
+    struct io_uring_sqe *sqe = io_uring_get_sqe(&ring_);
+    if (sqe == nullptr) {
+      return false;
+    }
+    bdev::SkipTransferred(io, iov, size);
+    off_t pos = (off_t)(off + io.done_);
+    if (is_write) {
+      io_uring_prep_writev(sqe, fd_, iov.data(), (unsigned)iov.size(), pos);
+    } else {
+      io_uring_prep_readv(sqe, fd_, iov.data(), (unsigned)iov.size(), pos);
+    }
+    if (fixed_file_) {
+      io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+    }
+    io_uring_sqe_set_data(sqe, &io);
+    io.pending_ = true;
+    ++inflight_;
+    return true;
+  }
+
+  /** Submit every queued SQE in one system call */
+  void Submit() {
+    if (io_uring_sq_ready(&ring_) == 0) {
+      return;
+    }
+    int ret = io_uring_submit(&ring_);
+    if (ret < 0 && ret != -EAGAIN && ret != -EBUSY) {
+      HELOG(kError, "io_uring_submit failed: {}", strerror(-ret));
+    }
+  }
+
+  /** Complete every request the kernel has finished */
+  void Reap() {
+    struct io_uring_cqe *cqe;
+    while (io_uring_peek_cqe(&ring_, &cqe) == 0) {
+      AsyncIo *io = reinterpret_cast<AsyncIo*>(io_uring_cqe_get_data(cqe));
+      if (cqe->res < 0) {
+        io->err_ = cqe->res;
+      } else if (cqe->res == 0) {
+        io->err_ = -EIO;
+      } else {
+        io->done_ += cqe->res;
+      }
+      io->pending_ = false;
+      --inflight_;
+      io_uring_cqe_seen(&ring_, cqe);
+    }
+  }
+
+  /**
+   * Make progress on \a io. A new or short transfer is queued and left
+   * for the next poll to submit, so the SQEs of a poll pass are batched.
+   * Returns true once the transfer is done.
+   * */
+  bool Poll(AsyncIo &io, bool is_write,
+            const char *buf, size_t size, size_t off) {
+    if (!io.pending_ && !io.IsDone(size) &&
+        Queue(io, is_write, buf, size, off)) {
+      return false;
+    }
+    Submit();
+    Reap();
+    return io.IsDone(size);
+  }
+
+  /** Poll for a vectored transfer of \a size bytes, as with Poll */
+  bool PollV(AsyncIo &io, bool is_write, std::vector<struct iovec> &iov,
+             size_t size, size_t off) {
+    if (!io.pending_ && !io.IsDone(size) &&
+        QueueV(io, is_write, iov, size, off)) {
+      return false;
+    }
+    Submit();
+    Reap();
+    return io.IsDone(size);
+  }
+};
+
+}  // namespace hermes::posix_bdev
+
+#endif  // HERMES_IO_URING
+
+#endif  // HRUN_TASKS_POSIX_BDEV_INCLUDE_POSIX_BDEV_IO_URING_QUEUE_H_
@@ -6,12 +6,18 @@
 #include "hrun/api/hrun_runtime.h"
 #include "posix_bdev/posix_bdev.h"
 #include "hermes/slab_allocator.h"
+#include "hermes/config_manager.h"
+#include "posix_bdev/io_uring_queue.h"
+#include "posix_bdev/aio_queue.h"
+#include "posix_bdev/bounce_pool.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <climits>
+#include <unordered_set>
 #include <unistd.h>
 #include <fcntl.h>
-// #include <libaio.h>
 
 namespace hermes::posix_bdev {
 
@@ -20,6 +26,31 @@ class Server : public TaskLib, public bdev::Server {
   SlabAllocator alloc_;
   int fd_;
   std::string path_;
+  IoEngine io_engine_;
+  bool direct_io_;
+  size_t block_size_;
+  std::vector<BouncePool> bounce_;  /**< Per I/O slot, for direct I/O */
+  hshm::Mutex rmw_lock_;  /**< Guards rmw_blocks_ */
+  std::unordered_set<size_t> rmw_blocks_;  /**< Blocks being read back */
+#ifdef HERMES_IO_URING
+  std::vector<UringQueue> rings_;  /**< Per I/O slot */
+#endif
+#ifdef HERMES_LIBAIO
+  std::vector<AioQueue> aio_queues_;  /**< Per I/O slot */
+#endif
+
+  /** The phases of an IoRun */
+  enum {
+    kIoPlan = 0,      /**< Decide whether the run needs a bounce buffer */
+    kIoLock = 1,      /**< Claim the partly written blocks */
+    kIoHead = 2,      /**< Read the partly written first block */
+    kIoTail = 3,      /**< Read the partly written last block */
+    kIoTransfer = 4,  /**< Transfer the data */
+    kIoDone = 5       /**< The run is complete */
+  };
+
+  /** The priorities bdev I/O runs at: low and high latency */
+  static const u32 kIoGroups = 2;
 
  public:
   /** Construct posix BDEV */
@@ -33,20 +64,438 @@ class Server : public TaskLib, public bdev::Server {
     auto canon = stdfs::weakly_canonical(text).string();
     dev_info.mount_point_ = canon;
     path_ = canon;
-    fd_ = open(dev_info.mount_point_.c_str(),
-               O_TRUNC | O_CREAT | O_RDWR, 0666);
+    // Keep the slabs of recovered blobs when metadata is recovered
+    int flags = O_CREAT | O_RDWR;
+    if (!HERMES_SERVER_CONF.recovery_.enabled_) {
+      flags |= O_TRUNC;
+    }
+    direct_io_ = dev_info.direct_io_;
+    block_size_ = dev_info.block_size_;
+    if (direct_io_) {
+      fd_ = open(dev_info.mount_point_.c_str(), flags | O_DIRECT, 0666);
+      if (fd_ < 0) {
+        HELOG(kWarning, "{} does not support O_DIRECT: using buffered I/O",
+              dev_info.mount_point_);
+        direct_io_ = false;
+      }
+    }
+    if (!direct_io_) {
+      fd_ = open(dev_info.mount_point_.c_str(), flags, 0666);
+    }
     if (fd_ < 0) {
       HELOG(kError, "Failed to open file: {}", dev_info.mount_point_);
     }
-    HILOG(kInfo, "Created {} at {} of size {}",
-          dev_info.dev_name_, dev_info.mount_point_, dev_info.capacity_);
+    if (direct_io_) {
+      InitDirectIo(dev_info);
+    }
+    io_engine_ = dev_info.io_engine_;
+    InitIoEngine(dev_info);
+    HILOG(kInfo, "Created {} at {} of size {} (io engine: {}, direct: {})",
+          dev_info.dev_name_, dev_info.mount_point_, dev_info.capacity_,
+          IoEngineConv::to_str(io_engine_), direct_io_);
     task->SetModuleComplete();
   }
   void MonitorConstruct(u32 mode, ConstructTask *task, RunContext &rctx) {
   }
 
+  /**
+   * Size the file to the device, so the blocks a bounce write reads back
+   * are never past the end, and create the bounce pools of the I/O slots.
+   * */
+  void InitDirectIo(DeviceInfo &dev_info) {
+    struct stat st;
+    if (fstat(fd_, &st) == 0 && (size_t)st.st_size < dev_info.capacity_ &&
+        ftruncate(fd_, (off_t)dev_info.capacity_) < 0) {
+      HELOG(kError, "Could not size {}: {}",
+            dev_info.mount_point_, strerror(errno));
+    }
+    bounce_ = std::vector<BouncePool>(NumIoSlots());
+    for (BouncePool &pool : bounce_) {
+      pool.Init(block_size_, 16);
+    }
+  }
+
+  /** Create the queues of an asynchronous engine, or fall back to sync */
+  void InitIoEngine(DeviceInfo &dev_info) {
+    switch (io_engine_) {
+      case IoEngine::kSync: {
+        return;
+      }
+      case IoEngine::kIoUring: {
+#ifdef HERMES_IO_URING
+        rings_ = std::vector<UringQueue>(NumIoSlots());
+        for (UringQueue &ring : rings_) {
+          if (!ring.Init(fd_, dev_info.io_depth_)) {
+            HELOG(kError, "Could not create io_uring for {}: using sync I/O",
+                  dev_info.dev_name_);
+            rings_.clear();
+            io_engine_ = IoEngine::kSync;
+            return;
+          }
+        }
+        if (dev_info.io_register_bufs_) {
+          std::vector<struct iovec> bufs = GetDataBuffers();
+          for (UringQueue &ring : rings_) {
+            ring.RegisterBuffers(bufs);
+          }
+        }
+        return;
+#else
+        break;
+#endif
+      }
+      case IoEngine::kLibAio: {
+#ifdef HERMES_LIBAIO
+        aio_queues_ = std::vector<AioQueue>(NumIoSlots());
+        for (AioQueue &aio : aio_queues_) {
+          if (!aio.Init(fd_, dev_info.io_depth_)) {
+            HELOG(kError, "Could not create libaio for {}: using sync I/O",
+                  dev_info.dev_name_);
+            aio_queues_.clear();
+            io_engine_ = IoEngine::kSync;
+            return;
+          }
+        }
+        return;
+#else
+        break;
+#endif
+      }
+    }
+    HELOG(kWarning, "{} requests {}, but Hermes was built without it: "
+          "using sync I/O", dev_info.dev_name_,
+          IoEngineConv::to_str(io_engine_));
+    io_engine_ = IoEngine::kSync;
+  }
+
+  /** The number of I/O slots */
+  size_t NumIoSlots() {
+    return kIoGroups * HRUN_QM_RUNTIME->max_lanes_;
+  }
+
+  /**
+   * The I/O slot of \a task. Low- and high-latency lanes with the same id
+   * run on different workers, so each (priority, lane) pair gets its own
+   * engine queue.
+   * */
+  u32 GetIoSlot(Task *task, RunContext &rctx) {
+    u32 group = task->prio_ == TaskPrio::kLowLatency ? 0 : 1;
+    return group * HRUN_QM_RUNTIME->max_lanes_ + rctx.lane_id_;
+  }
+
+  /**
+   * Transfer \a size bytes of \a buf at \a off with the engine of I/O
+   * \a slot, leaving the result in \a io. The sync engine finishes in one
+   * call; asynchronous engines return false until the I/O completes.
+   * */
+  bool Transfer(AsyncIo &io, bool is_write, char *buf,
+                size_t size, size_t off, u32 slot) {
+    switch (io_engine_) {
+#ifdef HERMES_IO_URING
+      case IoEngine::kIoUring: {
+        return rings_[slot].Poll(io, is_write, buf, size, off);
+      }
+#endif
+#ifdef HERMES_LIBAIO
+      case IoEngine::kLibAio: {
+        return aio_queues_[slot].Poll(io, is_write, buf, size, off);
+      }
+#endif
+      default: {
+        while (!io.IsDone(size)) {
+          off64_t pos = (off64_t)(off + io.done_);
+          ssize_t count = is_write ?
+              pwrite64(fd_, buf + io.done_, size - io.done_, pos) :
+              pread64(fd_, buf + io.done_, size - io.done_, pos);
+          if (count < 0 && errno == EINTR) {
+            continue;
+          } else if (count < 0) {
+            io.err_ = -errno;
+          } else if (count == 0) {
+            io.err_ = -EIO;
+          } else {
+            io.done_ += count;
+          }
+        }
+        return true;
+      }
+    }
+  }
+
+  /**
+   * Transfer \a run with one vectored request per pass, leaving the result
+   * in its AsyncIo. Runs of one buffer use Transfer, so they can use the
+   * registered buffers of io_uring. Returns true once the run is done.
+   * */
+  bool TransferV(IoRun &run, bool is_write, u32 slot) {
+    if (run.iov_.size() == 1) {
+      return Transfer(run.io_, is_write,
+                      reinterpret_cast<char*>(run.iov_[0].iov_base),
+                      run.size_, run.off_, slot);
+    }
+    switch (io_engine_) {
+#ifdef HERMES_IO_URING
+      case IoEngine::kIoUring: {
+        return rings_[slot].PollV(
+            run.io_, is_write, run.iov_, run.size_, run.off_);
+      }
+#endif
+#ifdef HERMES_LIBAIO
+      case IoEngine::kLibAio: {
+        return aio_queues_[slot].PollV(
+            run.io_, is_write, run.iov_, run.size_, run.off_);
+      }
+#endif
+      default: {
+        while (!run.io_.IsDone(run.size_)) {
+          bdev::SkipTransferred(run.io_, run.iov_, run.size_);
+          off64_t pos = (off64_t)(run.off_ + run.io_.done_);
+          ssize_t count = is_write ?
+              pwritev64(fd_, run.iov_.data(), (int)run.iov_.size(), pos) :
+              preadv64(fd_, run.iov_.data(), (int)run.iov_.size(), pos);
+          if (count < 0 && errno == EINTR) {
+            continue;
+          } else if (count < 0) {
+            run.io_.err_ = -errno;
+          } else if (count == 0) {
+            run.io_.err_ = -EIO;
+          } else {
+            run.io_.done_ += count;
+          }
+        }
+        return true;
+      }
+    }
+  }
+
+  /** Log a transfer of \a size bytes at \a off that failed or was short */
+  void CheckIo(const AsyncIo &io, bool is_write, size_t size, size_t off) {
+    if (io.err_ || io.done_ < size) {
+      HELOG(kError, "BORG: {} {} of {} bytes at {}: {}",
+            is_write ? "wrote" : "read", io.done_, size, off,
+            strerror(-io.err_));
+    }
+  }
+
+  /** Whether O_DIRECT can transfer \a run in place */
+  bool IsAligned(BouncePool &pool, const IoRun &run) {
+    if (!pool.IsAligned(nullptr, run.size_, run.off_)) {
+      return false;
+    }
+    for (const struct iovec &iov : run.iov_) {
+      if (!pool.IsAligned(iov.iov_base, iov.iov_len, 0)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** Copy the memory of \a run into \a buf, or out of it to scatter */
+  void CopyRun(IoRun &run, char *buf, bool gather) {
+    for (struct iovec &iov : run.iov_) {
+      if (gather) {
+        memcpy(buf, iov.iov_base, iov.iov_len);
+      } else {
+        memcpy(iov.iov_base, buf, iov.iov_len);
+      }
+      buf += iov.iov_len;
+    }
+  }
+
+  /**
+   * Make progress on \a run. With direct I/O, a run that is not
+   * block-aligned goes through a bounce buffer covering its blocks.
+   * Returns true once the run is done.
+   * */
+  bool PollRun(IoRun &run, bool is_write, u32 slot) {
+    if (run.phase_ == kIoDone) {
+      return true;
+    }
+    if (run.phase_ == kIoPlan) {
+      run.phase_ = kIoTransfer;
+      if (direct_io_ && !IsAligned(bounce_[slot], run)) {
+        BouncePool &pool = bounce_[slot];
+        size_t size =
+            pool.AlignUp(run.off_ + run.size_) - pool.AlignDown(run.off_);
+        run.bounce_ = pool.Allocate(size);
+        if (run.bounce_ == nullptr) {
+          // O_DIRECT would reject the unaligned buffer anyway
+          run.io_.err_ = -ENOMEM;
+          CheckIo(run.io_, is_write, size, pool.AlignDown(run.off_));
+          run.phase_ = kIoDone;
+          return true;
+        }
+        run.phase_ = is_write ? kIoLock : kIoTransfer;
+      }
+    }
+    if (run.bounce_) {
+      if (!PollBounce(run, is_write, slot)) {
+        return false;
+      }
+    } else {
+      if (!TransferV(run, is_write, slot)) {
+        return false;
+      }
+      CheckIo(run.io_, is_write, run.size_, run.off_);
+    }
+    run.phase_ = kIoDone;
+    return true;
+  }
+
+  /**
+   * Transfer \a run through its bounce buffer. A write first reads back
+   * the blocks it only partly covers, so their other bytes are kept.
+   * Those blocks are claimed for the whole read-modify-write, so two
+   * writes into one block cannot undo each other. A failed or short
+   * read back fails the run without writing. Returns true once the run
+   * is done.
+   * */
+  bool PollBounce(IoRun &run, bool is_write, u32 slot) {
+    BouncePool &pool = bounce_[slot];
+    size_t off = pool.AlignDown(run.off_);
+    size_t size = pool.AlignUp(run.off_ + run.size_) - off;
+    size_t tail_off = off + size - block_size_;
+    bool head_read = run.off_ != off;
+    bool tail_read = run.off_ + run.size_ != off + size &&
+        !(head_read && tail_off == off);
+    std::vector<size_t> blocks;
+    if (head_read) {
+      blocks.emplace_back(off);
+    }
+    if (tail_read) {
+      blocks.emplace_back(tail_off);
+    }
+    if (run.phase_ == kIoLock) {
+      if (!LockBlocks(blocks)) {
+        return false;
+      }
+      run.phase_ = kIoHead;
+    }
+    if (run.phase_ == kIoHead) {
+      if (head_read) {
+        if (!Transfer(run.io_, false, run.bounce_, block_size_, off, slot)) {
+          return false;
+        }
+        if (!CheckReadBack(run, off)) {
+          EndBounce(run, size, blocks, slot);
+          return true;
+        }
+      }
+      run.phase_ = kIoTail;
+    }
+    if (run.phase_ == kIoTail) {
+      if (tail_read) {
+        if (!Transfer(run.io_, false, run.bounce_ + size - block_size_,
+                      block_size_, tail_off, slot)) {
+          return false;
+        }
+        if (!CheckReadBack(run, tail_off)) {
+          EndBounce(run, size, blocks, slot);
+          return true;
+        }
+      }
+      CopyRun(run, run.bounce_ + run.off_ - off, true);
+      run.phase_ = kIoTransfer;
+    }
+    if (!Transfer(run.io_, is_write, run.bounce_, size, off, slot)) {
+      return false;
+    }
+    CheckIo(run.io_, is_write, size, off);
+    if (!is_write) {
+      CopyRun(run, run.bounce_ + run.off_ - off, false);
+    }
+    EndBounce(run, size, blocks, slot);
+    return true;
+  }
+
+  /**
+   * Check the read back of the block at \a off. On success, reset the
+   * AsyncIo of \a run for the next transfer; otherwise it keeps the error.
+   * */
+  bool CheckReadBack(IoRun &run, size_t off) {
+    CheckIo(run.io_, false, block_size_, off);
+    if (run.io_.err_ || run.io_.done_ < block_size_) {
+      if (!run.io_.err_) {
+        run.io_.err_ = -EIO;
+      }
+      return false;
+    }
+    run.io_ = AsyncIo();
+    return true;
+  }
+
+  /** Release the claimed \a blocks and the bounce buffer of \a run */
+  void EndBounce(IoRun &run, size_t size,
+                 const std::vector<size_t> &blocks, u32 slot) {
+    UnlockBlocks(blocks);
+    bounce_[slot].Free(run.bounce_, size);
+    run.bounce_ = nullptr;
+  }
+
+  /** Claim all of \a blocks for a read-modify-write, or none if any is busy */
+  bool LockBlocks(const std::vector<size_t> &blocks) {
+    if (blocks.empty()) {
+      return true;
+    }
+    hshm::ScopedMutex lock(rmw_lock_, 0);
+    for (size_t block : blocks) {
+      if (rmw_blocks_.find(block) != rmw_blocks_.end()) {
+        return false;
+      }
+    }
+    for (size_t block : blocks) {
+      rmw_blocks_.emplace(block);
+    }
+    return true;
+  }
+
+  /** Release \a blocks claimed by LockBlocks */
+  void UnlockBlocks(const std::vector<size_t> &blocks) {
+    if (blocks.empty()) {
+      return;
+    }
+    hshm::ScopedMutex lock(rmw_lock_, 0);
+    for (size_t block : blocks) {
+      rmw_blocks_.erase(block);
+    }
+  }
+
+#ifdef HERMES_IO_URING
+  /**
+   * The shared-memory segments blob data is staged in, split into the
+   * 1GB pieces io_uring can register.
+   * */
+  std::vector<struct iovec> GetDataBuffers() {
+    QueueManagerInfo &qm = HRUN_CLIENT->server_config_.queue_manager_;
+    std::vector<struct iovec> bufs;
+    for (const std::string &shm_name :
+         {qm.data_shm_name_, qm.rdata_shm_name_}) {
+      hipc::MemoryBackend *backend =
+          HERMES_MEMORY_MANAGER->GetBackend(shm_name);
+      if (backend == nullptr) {
+        continue;
+      }
+      for (size_t off = 0; off < backend->data_size_; off += GIGABYTES(1)) {
+        struct iovec iov;
+        iov.iov_base = backend->data_ + off;
+        iov.iov_len = std::min<size_t>(GIGABYTES(1),
+                                       backend->data_size_ - off);
+        bufs.emplace_back(iov);
+      }
+    }
+    return bufs;
+  }
+#endif
+
   /** Destroy posix bdev */
   void Destruct(DestructTask *task, RunContext &rctx) {
+    bounce_.clear();
+#ifdef HERMES_IO_URING
+    rings_.clear();
+#endif
+#ifdef HERMES_LIBAIO
+    aio_queues_.clear();
+#endif
     task->SetModuleComplete();
   }
   void MonitorDestruct(u32 mode, DestructTask *task, RunContext &rctx) {
@@ -66,61 +515,43 @@ class Server : public TaskLib, public bdev::Server {
   /** Free space from bdev */
   void Free(FreeTask *task, RunContext &rctx) {
     rem_cap_ += alloc_.Free(task->buffers_);
-    score_hist_.Decrement(task->score_);
+    if (task->scores_.empty()) {
+      score_hist_.Decrement(task->score_);
+    }
+    for (float score : task->scores_) {
+      score_hist_.Decrement(score);
+    }
     task->SetModuleComplete();
   }
   void MonitorFree(u32 mode, FreeTask *task, RunContext &rctx) {
   }
 
+  /** Reserve the buffers of recovered blobs */
+  void Reserve(ReserveTask *task, RunContext &rctx) {
+    rem_cap_ -= alloc_.Reserve(task->buffers_);
+    for (float score : task->scores_) {
+      score_hist_.Increment(score);
+    }
+    task->SetModuleComplete();
+  }
+  void MonitorReserve(u32 mode, ReserveTask *task, RunContext &rctx) {
+  }
+
   /** Write to bdev */
   void Write(WriteTask *task, RunContext &rctx) {
-    HILOG(kDebug, "Writing {} bytes to {}", task->size_, path_);
-#ifdef HERMES_LIBAIO
-    switch (task->phase_) {
-      case 0: {
-        int ret = io_setup(1, &task->ctx_);
-        if (ret < 0) {
-          perror("io_setup");
-          HELOG(kError, "Libaio failed for write (1)");
-          task->SetModuleComplete();
-          return;
-        }
-        struct iocb xfer_iocb;
-        struct iocb *iocb_list[1];
-        io_prep_pwrite(&xfer_iocb, fd_, (void*)task->buf_, task->size_, task->disk_off_);
-        xfer_iocb.data = (void*) task->buf_;
-        iocb_list[0] = &xfer_iocb;
-        ret = io_submit(task->ctx_, 1, iocb_list);
-        if (ret != 1) {
-          perror("io_submit");
-          HELOG(kError, "Libaio failed for write (2)");
-          task->SetModuleComplete();
-          return;
-        }
-        task->phase_ = 1;
-      }
-      case 1: {
-        struct io_event events[1];
-        struct timespec timeout{0, 0};
-        int ret = io_getevents(task->ctx_, 1, 1, events, &timeout);
-        if (ret == -EAGAIN) {
-          return;
-        } else if (ret < 0) {
-          perror("io_getevents");
-          HELOG(kError, "Libaio failed for write (3)");
-          task->SetModuleComplete();
-          return;
-        }
-        io_destroy(task->ctx_);
+    if (task->phase_ == 0) {
+      if (!BeginIo(task)) {
+        return;
       }
+      HILOG(kDebug, "Writing {} bytes to {}", task->size_, path_);
+      task->run_ = IoRun(const_cast<char*>(task->buf_),
+                         task->disk_off_, task->size_);
+      task->phase_ = 1;
     }
-#else
-    ssize_t count = pwrite64(fd_, task->buf_, task->size_, (off64_t)task->disk_off_);
-    if (count != task->size_) {
-      HELOG(kError, "BORG: wrote {} bytes, but expected {}: {}",
-            count, task->size_, strerror(errno));
+    if (!PollRun(task->run_, true, GetIoSlot(task, rctx))) {
+      return;
     }
-#endif
+    EndIo(task);
     task->SetModuleComplete();
   }
   void MonitorWrite(u32 mode, WriteTask *task, RunContext &rctx) {
@@ -128,57 +559,75 @@ class Server : public TaskLib, public bdev::Server {
 
   /** Read from bdev */
   void Read(ReadTask *task, RunContext &rctx) {
-    HILOG(kDebug, "Reading {} bytes from {}", task->size_, path_);
-#ifdef HERMES_LIBAIO
-    switch (task->phase_) {
-      case 0: {
-        int ret = io_setup(1, &task->ctx_);
-        if (ret < 0) {
-          perror("io_setup");
-          HELOG(kError, "Libaio failed for write (1)");
-          task->SetModuleComplete();
-          return;
-        }
-        struct iocb xfer_iocb;
-        struct iocb *iocb_list[1];
-        io_prep_pread(&xfer_iocb, fd_, (void*)task->buf_, task->size_, task->disk_off_);
-        xfer_iocb.data = (void*) task->buf_;
-        iocb_list[0] = &xfer_iocb;
-        ret = io_submit(task->ctx_, 1, iocb_list);
-        if (ret != 1) {
-          perror("io_submit");
-          HELOG(kError, "Libaio failed for write (2)");
-          task->SetModuleComplete();
-          return;
-        }
-        task->phase_ = 1;
-      }
-      case 1: {
-        struct io_event events[1];
-        struct timespec timeout{0, 0};
-        int ret = io_getevents(task->ctx_, 1, 1, events, &timeout);
-        if (ret == -EAGAIN) {
-          return;
-        } else if (ret < 0) {
-          perror("io_getevents");
-          HELOG(kError, "Libaio failed for write (3)");
-          task->SetModuleComplete();
-          return;
-        }
-        io_destroy(task->ctx_);
+    if (task->phase_ == 0) {
+      if (!BeginIo(task)) {
+        return;
       }
+      HILOG(kDebug, "Reading {} bytes from {}", task->size_, path_);
+      task->run_ = IoRun(task->buf_, task->disk_off_, task->size_);
+      task->phase_ = 1;
     }
-#else
-    ssize_t count = pread64(fd_, task->buf_, task->size_, (off64_t)task->disk_off_);
-    if (count != task->size_) {
-      HELOG(kError, "BORG: read {} bytes, but expected {}",
-            count, task->size_);
+    if (!PollRun(task->run_, false, GetIoSlot(task, rctx))) {
+      return;
     }
-#endif
+    EndIo(task);
     task->SetModuleComplete();
   }
   void MonitorRead(u32 mode, ReadTask *task, RunContext &rctx) {
   }
+
+  /**
+   * Write many segments. Segments contiguous on the device are merged
+   * into one vectored write, and every run is queued before any is
+   * waited on, so asynchronous engines submit them together.
+   * */
+  void WriteV(WriteVTask *task, RunContext &rctx) {
+    if (task->phase_ == 0) {
+      if (!BeginIo(task)) {
+        return;
+      }
+      bdev::CoalesceSegments(task->segs_, IOV_MAX, task->runs_);
+      HILOG(kDebug, "Writing {} segments in {} runs to {}",
+            task->segs_.size(), task->runs_.size(), path_);
+      task->phase_ = 1;
+    }
+    if (!PollRuns(task->runs_, true, GetIoSlot(task, rctx))) {
+      return;
+    }
+    EndIo(task);
+    task->SetModuleComplete();
+  }
+  void MonitorWriteV(u32 mode, WriteVTask *task, RunContext &rctx) {
+  }
+
+  /** Read many segments, merged as in WriteV */
+  void ReadV(ReadVTask *task, RunContext &rctx) {
+    if (task->phase_ == 0) {
+      if (!BeginIo(task)) {
+        return;
+      }
+      bdev::CoalesceSegments(task->segs_, IOV_MAX, task->runs_);
+      HILOG(kDebug, "Reading {} segments in {} runs from {}",
+            task->segs_.size(), task->runs_.size(), path_);
+      task->phase_ = 1;
+    }
+    if (!PollRuns(task->runs_, false, GetIoSlot(task, rctx))) {
+      return;
+    }
+    EndIo(task);
+    task->SetModuleComplete();
+  }
+  void MonitorReadV(u32 mode, ReadVTask *task, RunContext &rctx) {
+  }
+
+  /** Make progress on every run. Returns true once all are done. */
+  bool PollRuns(std::vector<IoRun> &runs, bool is_write, u32 slot) {
+    bool done = true;
+    for (IoRun &run : runs) {
+      done &= PollRun(run, is_write, slot);
+    }
+    return done;
+  }
  public:
 #include "bdev/bdev_lib_exec.h"
 };
@@ -52,16 +52,36 @@ class Server : public TaskLib, public bdev::Server {
   /** Free space to bdev */
   void Free(FreeTask *task, RunContext &rctx) {
     rem_cap_ += alloc_.Free(task->buffers_);
-    score_hist_.Decrement(task->score_);
+    if (task->scores_.empty()) {
+      score_hist_.Decrement(task->score_);
+    }
+    for (float score : task->scores_) {
+      score_hist_.Decrement(score);
+    }
     task->SetModuleComplete();
   }
   void MonitorFree(u32 mode, FreeTask *task, RunContext &rctx) {
   }
 
+  /** Reserve the buffers of recovered blobs */
+  void Reserve(ReserveTask *task, RunContext &rctx) {
+    rem_cap_ -= alloc_.Reserve(task->buffers_);
+    for (float score : task->scores_) {
+      score_hist_.Increment(score);
+    }
+    task->SetModuleComplete();
+  }
+  void MonitorReserve(u32 mode, ReserveTask *task, RunContext &rctx) {
+  }
+
   /** Write to bdev */
   void Write(WriteTask *task, RunContext &rctx) {
+    if (!BeginIo(task)) {
+      return;
+    }
     HILOG(kDebug, "Writing {} bytes to RAM", task->size_);
     memcpy(mem_ptr_ + task->disk_off_, task->buf_, task->size_);
+    EndIo(task);
     task->SetModuleComplete();
   }
   void MonitorWrite(u32 mode, WriteTask *task, RunContext &rctx) {
@@ -69,12 +89,46 @@ class Server : public TaskLib, public bdev::Server {
 
   /** Read from bdev */
   void Read(ReadTask *task, RunContext &rctx) {
+    if (!BeginIo(task)) {
+      return;
+    }
     HILOG(kDebug, "Reading {} bytes from RAM", task->size_);
     memcpy(task->buf_, mem_ptr_ + task->disk_off_, task->size_);
+    EndIo(task);
     task->SetModuleComplete();
   }
   void MonitorRead(u32 mode, ReadTask *task, RunContext &rctx) {
   }
+
+  /** Write many segments to bdev */
+  void WriteV(WriteVTask *task, RunContext &rctx) {
+    if (!BeginIo(task)) {
+      return;
+    }
+    HILOG(kDebug, "Writing {} segments to RAM", task->segs_.size());
+    for (IoSegment &seg : task->segs_) {
+      memcpy(mem_ptr_ + seg.off_, seg.buf_, seg.size_);
+    }
+    EndIo(task);
+    task->SetModuleComplete();
+  }
+  void MonitorWriteV(u32 mode, WriteVTask *task, RunContext &rctx) {
+  }
+
+  /** Read many segments from bdev */
+  void ReadV(ReadVTask *task, RunContext &rctx) {
+    if (!BeginIo(task)) {
+      return;
+    }
+    HILOG(kDebug, "Reading {} segments from RAM", task->segs_.size());
+    for (IoSegment &seg : task->segs_) {
+      memcpy(seg.buf_, mem_ptr_ + seg.off_, seg.size_);
+    }
+    EndIo(task);
+    task->SetModuleComplete();
+  }
+  void MonitorReadV(u32 mode, ReadVTask *task, RunContext &rctx) {
+  }
  public:
 #include "bdev/bdev_lib_exec.h"
 };
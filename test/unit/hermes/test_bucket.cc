@@ -17,6 +17,7 @@
 #include "hermes/bucket.h"
 #include "data_stager/factory/binary_stager.h"
 #include <mpi.h>
+#include <unordered_set>
 
 TEST_CASE("TestHermesConnect") {
   int rank, nprocs;
@@ -156,6 +157,143 @@ TEST_CASE("TestHermesPutGet") {
   }
 }
 
+TEST_CASE("TestHermesMultiPutGet") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Create a bucket
+  hermes::Context ctx;
+  hermes::Bucket bkt("hello");
+
+  size_t count_per_proc = 64;
+  size_t off = rank * count_per_proc;
+  std::vector<std::string> names;
+  std::vector<hermes::Blob> blobs;
+  for (size_t i = off; i < off + count_per_proc; ++i) {
+    names.emplace_back(std::to_string(i));
+    blobs.emplace_back(KILOBYTES(4) + i);
+    memset(blobs.back().data(), i % 256, blobs.back().size());
+  }
+  bkt.MultiPut(names, blobs, ctx);
+
+  // Get the blobs back in a single batch
+  std::vector<hermes::Blob> blobs2;
+  bkt.MultiGet(names, blobs2, ctx);
+  REQUIRE(blobs2.size() == blobs.size());
+  for (size_t i = 0; i < blobs.size(); ++i) {
+    REQUIRE(blobs[i] == blobs2[i]);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
+TEST_CASE("TestHermesMixedSizePutGet") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Create a bucket
+  hermes::Context ctx;
+  hermes::Bucket bkt("mixed");
+
+  // Interleave small (low-latency) and large (high-latency) bdev writes,
+  // so the same lane of both priorities hits the device at once
+  size_t count_per_proc = 64;
+  size_t off = rank * count_per_proc;
+  size_t proc_count = off + count_per_proc;
+  std::vector<hermes::Blob> blobs;
+  for (size_t i = off; i < proc_count; ++i) {
+    blobs.emplace_back(i % 2 ? MEGABYTES(1) : KILOBYTES(1));
+    memset(blobs.back().data(), i % 256, blobs.back().size());
+    bkt.AsyncPut(std::to_string(i), blobs.back(), ctx);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  HRUN_ADMIN->FlushRoot(DomainId::GetGlobal());
+
+  // Get the blobs back
+  for (size_t i = off; i < proc_count; ++i) {
+    hermes::BlobId blob_id = bkt.GetBlobId(std::to_string(i));
+    hermes::Blob blob;
+    bkt.Get(blob_id, blob, ctx);
+    REQUIRE(blob == blobs[i - off]);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
+TEST_CASE("TestHermesPutBuffer") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Create a bucket
+  hermes::Context ctx;
+  hermes::Bucket bkt("hello");
+
+  size_t count_per_proc = 16;
+  size_t off = rank * count_per_proc;
+  size_t proc_count = off + count_per_proc;
+  for (size_t i = off; i < proc_count; ++i) {
+    // Fill a shared-memory buffer in place and put it
+    hermes::BlobBuffer buf = bkt.AllocateBlobBuffer(MEGABYTES(1));
+    memset(buf.data(), i % 256, buf.size());
+    hermes::BlobId blob_id = bkt.PutBuffer(std::to_string(i), buf, ctx);
+    REQUIRE(buf.IsNull());
+    // Get the blob
+    hermes::Blob blob(MEGABYTES(1));
+    memset(blob.data(), i % 256, blob.size());
+    hermes::Blob blob2;
+    bkt.Get(blob_id, blob2, ctx);
+    REQUIRE(blob == blob2);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
+TEST_CASE("TestHermesGetView") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Create a bucket
+  hermes::Context ctx;
+  hermes::Bucket bkt("hello");
+
+  size_t count_per_proc = 16;
+  size_t off = rank * count_per_proc;
+  size_t proc_count = off + count_per_proc;
+  for (size_t i = off; i < proc_count; ++i) {
+    // Put a blob
+    hermes::Blob blob(MEGABYTES(1));
+    memset(blob.data(), i % 256, blob.size());
+    hermes::BlobId blob_id = bkt.Put(std::to_string(i), blob, ctx);
+    // View the blob in shared memory
+    hermes::BlobBuffer view = bkt.GetView(blob_id, ctx);
+    REQUIRE(view.size() == blob.size());
+    REQUIRE(memcmp(view.data(), blob.data(), blob.size()) == 0);
+    // View the second half of the blob
+    hermes::BlobBuffer part = bkt.PartialGetView(
+        std::to_string(i), blob.size() / 2, blob.size() / 2, ctx);
+    REQUIRE(part.size() == blob.size() / 2);
+    REQUIRE(memcmp(part.data(), blob.data(), part.size()) == 0);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
 TEST_CASE("TestHermesPartialPutGet") {
   int rank, nprocs;
   MPI_Barrier(MPI_COMM_WORLD);
@@ -203,6 +341,42 @@ TEST_CASE("TestHermesPartialPutGet") {
   }
 }
 
+TEST_CASE("TestHermesDedupPutGet") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Create a bucket
+  hermes::Context ctx;
+  ctx.flags_.SetBits(HERMES_BLOB_DEDUP);
+  hermes::Bucket bkt(hshm::Formatter::format("dedup{}", rank), ctx);
+
+  // Put identical blobs, which share their slabs
+  hermes::Blob blob(MEGABYTES(2));
+  memset(blob.data(), rank % 256, blob.size());
+  hermes::BlobId id1 = bkt.Put("dedup1", blob, ctx);
+  hermes::BlobId id2 = bkt.Put("dedup2", blob, ctx);
+  hermes::Blob blob1, blob2;
+  bkt.Get(id1, blob1, ctx);
+  bkt.Get(id2, blob2, ctx);
+  REQUIRE(blob1 == blob);
+  REQUIRE(blob2 == blob);
+
+  // Modifying one blob must not modify the other
+  hermes::Blob part(KILOBYTES(4));
+  memset(part.data(), (rank + 1) % 256, part.size());
+  bkt.PartialPut("dedup2", part, 0, ctx);
+  hermes::Blob blob3, part2(KILOBYTES(4));
+  bkt.Get(id1, blob3, ctx);
+  bkt.PartialGet(id2, part2, 0, ctx);
+  REQUIRE(blob3 == blob);
+  REQUIRE(part2 == part);
+}
+
 TEST_CASE("TestHermesSerializedPutGet") {
   int rank, nprocs;
   MPI_Barrier(MPI_COMM_WORLD);
@@ -295,6 +469,73 @@ TEST_CASE("TestHermesBucketDestroy") {
   }
 }
 
+TEST_CASE("TestHermesBucketClear") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Create a bucket
+  hermes::Context ctx;
+  hermes::Bucket bkt("clear_test" + std::to_string(rank));
+  size_t num_blobs = 1024;
+
+  // Put enough blobs to span several lanes
+  for (size_t i = 0; i < num_blobs; ++i) {
+    hermes::Blob blob(KILOBYTES(4));
+    memset(blob.data(), i % 256, blob.size());
+    bkt.Put(std::to_string(i), blob, ctx);
+  }
+  REQUIRE(bkt.GetContainedBlobIds().size() == num_blobs);
+
+  // Clear the bucket and make sure every blob is gone
+  bkt.Clear();
+  REQUIRE(bkt.GetContainedBlobIds().size() == 0);
+  REQUIRE(bkt.GetSize() == 0);
+  for (size_t i = 0; i < num_blobs; ++i) {
+    REQUIRE(!bkt.ContainsBlob(std::to_string(i)));
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
+TEST_CASE("TestHermesBucketSize") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Every rank grows the same bucket
+  hermes::Context ctx;
+  hermes::Bucket bkt("size_test");
+  size_t count_per_proc = 256;
+  size_t off = rank * count_per_proc;
+  for (size_t i = off; i < off + count_per_proc; ++i) {
+    hermes::Blob blob(KILOBYTES(4));
+    memset(blob.data(), i % 256, blob.size());
+    bkt.Put(std::to_string(i), blob, ctx);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  // An exact read sees every put, however the updates were batched
+  REQUIRE(bkt.GetSize() == nprocs * count_per_proc * KILOBYTES(4));
+  REQUIRE(bkt.GetSize(false) == nprocs * count_per_proc * KILOBYTES(4));
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  // Shrinking is batched the same way
+  for (size_t i = off; i < off + count_per_proc / 2; ++i) {
+    bkt.DestroyBlob(bkt.GetBlobId(std::to_string(i)), ctx);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  REQUIRE(bkt.GetSize() == nprocs * count_per_proc / 2 * KILOBYTES(4));
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
 TEST_CASE("TestHermesReorganizeBlob") {
   int rank, nprocs;
   MPI_Barrier(MPI_COMM_WORLD);
@@ -332,6 +573,87 @@ TEST_CASE("TestHermesReorganizeBlob") {
   MPI_Barrier(MPI_COMM_WORLD);
 }
 
+TEST_CASE("TestHermesBackgroundIoDeferral") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Create a bucket
+  hermes::Context ctx;
+  hermes::Bucket bkt("deferral");
+
+  // Migrate blobs (background I/O) while putting and getting others
+  size_t count_per_proc = 16;
+  size_t off = rank * count_per_proc;
+  size_t proc_count = off + count_per_proc;
+  for (size_t i = off; i < proc_count; ++i) {
+    hermes::Blob blob(MEGABYTES(1));
+    memset(blob.data(), i % 256, blob.size());
+    hermes::BlobId blob_id = bkt.Put(std::to_string(i), blob, ctx);
+    bkt.ReorganizeBlob(blob_id, 0, ctx);
+    hermes::BlobId fg_id = bkt.Put("fg" + std::to_string(i), blob, ctx);
+    hermes::Blob blob2;
+    bkt.Get(fg_id, blob2, ctx);
+    REQUIRE(blob == blob2);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  HRUN_ADMIN->FlushRoot(DomainId::GetGlobal());
+
+  // Every deferred background I/O ran once the runtime was flushed
+  hermes::MetadataTable table = HERMES->CollectMetadataSnapshot();
+  size_t deferred = 0, executed = 0;
+  for (hermes::TargetStats &target : table.target_info_) {
+    deferred += target.bg_deferred_;
+    executed += target.bg_executed_;
+  }
+  REQUIRE(deferred <= executed);
+  if (table.target_info_.size() > 1) {
+    REQUIRE(executed > 0);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
+TEST_CASE("TestHermesReorganizeDuringPartialPut") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Create a bucket
+  hermes::Context ctx;
+  hermes::Bucket bkt("reorg_partial");
+
+  // Move the blob between tiers while other parts of it are overwritten
+  size_t count_per_proc = 16;
+  size_t part_size = KILOBYTES(64);
+  std::string blob_name = "reorg" + std::to_string(rank);
+  hermes::Blob blob(count_per_proc * part_size);
+  memset(blob.data(), 0, blob.size());
+  hermes::BlobId blob_id = bkt.Put(blob_name, blob, ctx);
+  for (size_t i = 0; i < count_per_proc; ++i) {
+    hermes::Blob part(part_size);
+    memset(part.data(), (i + 1) % 256, part.size());
+    memcpy(blob.data() + i * part_size, part.data(), part.size());
+    bkt.ReorganizeBlob(blob_id, (i % 2) ? 1 : 0, ctx);
+    bkt.AsyncPartialPut(blob_id, part, i * part_size, ctx);
+  }
+  HRUN_ADMIN->FlushRoot(DomainId::GetGlobal());
+
+  // No overwrite was lost to a buffer swapped in by the reorganize
+  hermes::Blob blob2;
+  bkt.Get(blob_id, blob2, ctx);
+  REQUIRE(blob.size() == blob2.size());
+  REQUIRE(blob == blob2);
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
 TEST_CASE("TestHermesBucketAppend") {
   int rank, nprocs;
   MPI_Barrier(MPI_COMM_WORLD);
@@ -405,6 +727,54 @@ TEST_CASE("TestHermesBucketAppend1n") {
   MPI_Barrier(MPI_COMM_WORLD);
 }
 
+TEST_CASE("TestHermesBucketAppendConcurrent") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Every rank appends pages to the same bucket, some with leases
+  hermes::Context ctx;
+  hermes::Bucket bkt("append_concurrent_test");
+  size_t page_size = KILOBYTES(4);
+  size_t count_per_proc = 16;
+  if (rank % 2) {
+    bkt.SetAppendLease(4 * page_size);
+  }
+  for (size_t i = 0; i < count_per_proc; ++i) {
+    hermes::Blob blob(page_size);
+    memset(blob.data(), rank % 256, blob.size());
+    bkt.Append(blob, page_size, ctx);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  // No two appends overlap: each page is whole and from one rank
+  if (rank == 0) {
+    std::vector<size_t> pages_per_rank(nprocs, 0);
+    for (size_t page = 0; page < nprocs * count_per_proc; ++page) {
+      std::string blob_name =
+          hermes::adapter::BlobPlacement::CreateBlobName(page).str();
+      hermes::Blob blob;
+      bkt.Get(blob_name, blob, ctx);
+      REQUIRE(blob.size() == page_size);
+      char owner = blob.data()[0];
+      for (size_t i = 0; i < blob.size(); ++i) {
+        REQUIRE(blob.data()[i] == owner);
+      }
+      REQUIRE((size_t)owner < pages_per_rank.size());
+      ++pages_per_rank[owner];
+    }
+    for (size_t count : pages_per_rank) {
+      REQUIRE(count == count_per_proc);
+    }
+    REQUIRE(bkt.GetSize() == nprocs * count_per_proc * page_size);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
 TEST_CASE("TestHermesMultiGetBucket") {
   int rank, nprocs;
   MPI_Barrier(MPI_COMM_WORLD);
@@ -466,6 +836,44 @@ TEST_CASE("TestHermesGetContainedBlobIds") {
   MPI_Barrier(MPI_COMM_WORLD);
 }
 
+TEST_CASE("TestHermesDestroyContainedBlobs") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Create a bucket
+  hermes::Context ctx;
+  hermes::Bucket bkt("destroy_contained" + std::to_string(rank));
+  u32 num_blobs = 1024;
+
+  // Put blobs in the bucket
+  std::vector<hermes::BlobId> put_ids;
+  for (u32 i = 0; i < num_blobs; ++i) {
+    hermes::Blob blob(KILOBYTES(4));
+    memset(blob.data(), i % 256, blob.size());
+    put_ids.emplace_back(bkt.Put(std::to_string(i), blob, ctx));
+  }
+
+  // Destroy every other blob
+  for (u32 i = 0; i < num_blobs; i += 2) {
+    bkt.DestroyBlob(put_ids[i], ctx);
+  }
+
+  // Only the odd blobs remain in the bucket
+  std::vector<hermes::BlobId> blob_ids = bkt.GetContainedBlobIds();
+  REQUIRE(blob_ids.size() == num_blobs / 2);
+  std::unordered_set<hermes::BlobId> remaining(blob_ids.begin(),
+                                               blob_ids.end());
+  for (u32 i = 0; i < num_blobs; ++i) {
+    REQUIRE(remaining.count(put_ids[i]) == i % 2);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
 TEST_CASE("TestHermesDataStager") {
   int rank, nprocs;
   MPI_Barrier(MPI_COMM_WORLD);
@@ -614,10 +1022,165 @@ TEST_CASE("TestHermesCollectMetadata") {
   hermes::MetadataTable table = HERMES->CollectMetadataSnapshot();
   REQUIRE(table.blob_info_.size() == 1024 * nprocs);
   REQUIRE(table.bkt_info_.size() == nprocs);
+  REQUIRE(table.flush_info_.size() >= 1);
   // REQUIRE(table.target_info_.size() >= 4);
   MPI_Barrier(MPI_COMM_WORLD);
 }
 
+TEST_CASE("TestHermesGetBlobsWithTag") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Create a bucket and a tag
+  hermes::Context ctx;
+  hermes::Bucket bkt("tag_index_test" + std::to_string(rank));
+  hermes::Bucket tag("tag_index_label" + std::to_string(rank));
+  hermes::TagId tag_id = tag.GetId();
+  u32 num_blobs = 256;
+
+  // Put a few blobs in the bucket and tag the even ones
+  std::vector<hermes::BlobId> blob_ids;
+  for (int i = 0; i < num_blobs; ++i) {
+    hermes::Blob blob(KILOBYTES(4));
+    memset(blob.data(), i % 256, blob.size());
+    hermes::BlobId blob_id = bkt.Put(std::to_string(i), blob, ctx);
+    if (i % 2 == 0) {
+      bkt.TagBlob(blob_id, tag_id);
+      bkt.TagBlob(blob_id, tag_id);
+    }
+    blob_ids.emplace_back(blob_id);
+  }
+  REQUIRE(bkt.BlobHasTag(blob_ids[0], tag_id));
+  REQUIRE(!bkt.BlobHasTag(blob_ids[1], tag_id));
+  std::vector<hermes::BlobId> tagged = bkt.GetBlobsWithTag(tag_id);
+  REQUIRE(tagged.size() == num_blobs / 2);
+
+  // Destroyed blobs leave the index
+  bkt.DestroyBlob(blob_ids[0], ctx);
+  tagged = bkt.GetBlobsWithTag(tag_id);
+  REQUIRE(tagged.size() == num_blobs / 2 - 1);
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
+TEST_CASE("TestHermesListBlobs") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Create a bucket with directory-like blob names
+  hermes::Context ctx;
+  hermes::Bucket bkt("list_test" + std::to_string(rank));
+  u32 num_dirs = 4;
+  u32 files_per_dir = 64;
+  for (int i = 0; i < num_dirs; ++i) {
+    for (int j = 0; j < files_per_dir; ++j) {
+      hermes::Blob blob(KILOBYTES(4));
+      std::string file = std::to_string(j);
+      std::string name = "dir" + std::to_string(i) + "/file" +
+          std::string(4 - file.size(), '0') + file;
+      bkt.Put(name, blob, ctx);
+    }
+  }
+
+  // List one directory in pages
+  std::vector<hermes::BlobNameEntry> page = bkt.ListBlobs("dir1/", "", 10);
+  REQUIRE(page.size() == 10);
+  REQUIRE(page[0].name_ == "dir1/file0000");
+  REQUIRE(page[9].name_ == "dir1/file0009");
+  page = bkt.ListBlobs("dir1/", page.back().name_, 10);
+  REQUIRE(page[0].name_ == "dir1/file0010");
+  size_t count = 0;
+  std::string last;
+  bkt.ScanBlobs("dir2/", [&](const hermes::BlobNameEntry &entry) {
+    REQUIRE(entry.name_ > last);
+    last = entry.name_;
+    ++count;
+    return true;
+  }, 7);
+  REQUIRE(count == files_per_dir);
+
+  // Renamed and destroyed blobs leave the index
+  hermes::BlobId blob_id = bkt.GetBlobId("dir3/file0000");
+  bkt.RenameBlob(blob_id, "dir4/file0000", ctx);
+  page = bkt.ListBlobs("dir4/");
+  REQUIRE(page.size() == 1);
+  bkt.DestroyBlob(page[0].blob_id_, ctx);
+  REQUIRE(bkt.ListBlobs("dir4/").empty());
+  REQUIRE(bkt.ListBlobs("dir3/").size() == files_per_dir - 1);
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
+TEST_CASE("TestHermesPollMetadataPages") {
+  int rank, nprocs;
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+  // Initialize Hermes on all nodes
+  HERMES->ClientInit();
+
+  // Create a bucket
+  hermes::Context ctx;
+  hermes::Bucket bkt("poll_test" + std::to_string(rank));
+  u32 num_blobs = 1024;
+
+  // Put a few blobs in the bucket
+  for (int i = 0; i < num_blobs; ++i) {
+    hermes::Blob blob(KILOBYTES(4));
+    memset(blob.data(), i % 256, blob.size());
+    bkt.Put("poll_" + std::to_string(i), blob, ctx);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  // Page through the blobs of this bucket
+  hermes::BlobQuery query;
+  query.tag_id_ = bkt.GetId();
+  query.page_size_ = 100;
+  hermes::MetadataCursor cursor;
+  size_t count = 0;
+  while (!cursor.done_) {
+    std::vector<hermes::BlobStat> page =
+        HERMES->PollBlobMetadata(query, cursor);
+    REQUIRE(page.size() <= query.page_size_);
+    for (hermes::BlobStat &stat : page) {
+      REQUIRE(stat.tag_id_ == bkt.GetId());
+      REQUIRE(stat.blob_size_ == KILOBYTES(4));
+    }
+    count += page.size();
+  }
+  REQUIRE(count == num_blobs);
+
+  // Filter by name: poll_1, poll_1x, poll_1xx and poll_1000-poll_1023
+  query.name_prefix_ = "poll_1";
+  cursor = hermes::MetadataCursor();
+  count = 0;
+  while (!cursor.done_) {
+    count += HERMES->PollBlobMetadata(query, cursor).size();
+  }
+  REQUIRE(count == 135);
+
+  // Page through the buckets
+  hermes::TagQuery tag_query;
+  tag_query.name_prefix_ = "poll_test";
+  tag_query.page_size_ = 1;
+  cursor = hermes::MetadataCursor();
+  count = 0;
+  while (!cursor.done_) {
+    count += HERMES->PollTagMetadata(tag_query, cursor).size();
+  }
+  REQUIRE(count == nprocs);
+  MPI_Barrier(MPI_COMM_WORLD);
+}
+
 /*
 TEST_CASE("TestHermesDataPlacement") {
   int rank, nprocs;
@@ -0,0 +1,317 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Distributed under BSD 3-Clause license.                                   *
+ * Copyright by The HDF Group.                                               *
+ * Copyright by the Illinois Institute of Technology.                        *
+ * All rights reserved.                                                      *
+ *                                                                           *
+ * This file is part of Hermes. The full Hermes copyright notice, including  *
+ * terms governing use, modification, and redistribution, is contained in    *
+ * the COPYING file, which can be found at the top directory. If you do not  *
+ * have access to the file, you may request a copy from help@hdfgroup.org.   *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "basic_test.h"
+#include "hermes/hermes_types.h"
+#include "hermes/metadata_log.h"
+#include <cstdlib>
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+
+using hermes::MetadataLog;
+using hermes::LogOp;
+using hermes::BlobId;
+using hermes::TagId;
+using hermes::BlobInfo;
+using hermes::TagInfo;
+
+/** A fresh directory for the log and snapshot of one test */
+static std::string MakeLogDir() {
+  char dir[] = "/tmp/hermes_mdm_log_XXXXXX";
+  REQUIRE(mkdtemp(dir) != nullptr);
+  return dir;
+}
+
+/** Remove the files of a log made in \a dir */
+static void RemoveLogDir(const std::string &dir, const std::string &name) {
+  std::remove((dir + "/" + name + ".log").c_str());
+  std::remove((dir + "/" + name + ".snap").c_str());
+  rmdir(dir.c_str());
+}
+
+/** Read a whole file */
+static std::string ReadBytes(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+}
+
+/** Replace a whole file */
+static void WriteBytes(const std::string &path, const std::string &data) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(data.data(), (std::streamsize)data.size());
+}
+
+/** Replay \a log, collecting the ids of its kPutBlob and kDelBlob records */
+static size_t ReplayIds(MetadataLog &log, std::vector<size_t> &puts,
+                        std::vector<size_t> &dels) {
+  return log.Replay([&](LogOp op, cereal::BinaryInputArchive &ar) {
+    BlobId blob_id;
+    ar(blob_id);
+    if (op == LogOp::kPutBlob) {
+      puts.emplace_back(blob_id.unique_);
+    } else if (op == LogOp::kDelBlob) {
+      dels.emplace_back(blob_id.unique_);
+    }
+  });
+}
+
+TEST_CASE("TestMetadataLogAppendReplay") {
+  std::string dir = MakeLogDir();
+  {
+    MetadataLog log;
+    log.Init(dir, "lane");
+    REQUIRE(log.Snapshot([](MetadataLog::Writer &writer) {}));
+    for (size_t i = 0; i < 16; ++i) {
+      log.Append(LogOp::kPutBlob, BlobId(0, i));
+    }
+    log.Append(LogOp::kDelBlob, BlobId(0, 3));
+    REQUIRE(!log.NeedsSnapshot(1 << 20));
+    REQUIRE(log.NeedsSnapshot(1));
+  }
+
+  // Reopen the files, as a restarted runtime would
+  MetadataLog log;
+  log.Init(dir, "lane");
+  std::vector<size_t> puts, dels;
+  REQUIRE(ReplayIds(log, puts, dels) == 17);
+  REQUIRE(log.gen_ == 1);
+  REQUIRE(puts.size() == 16);
+  for (size_t i = 0; i < 16; ++i) {
+    REQUIRE(puts[i] == i);
+  }
+  REQUIRE(dels == std::vector<size_t>{3});
+  RemoveLogDir(dir, "lane");
+}
+
+TEST_CASE("TestMetadataLogTornRecord") {
+  std::string dir = MakeLogDir();
+  std::string log_path = dir + "/lane.log";
+  size_t last_off;
+  {
+    MetadataLog log;
+    log.Init(dir, "lane");
+    REQUIRE(log.Snapshot([](MetadataLog::Writer &writer) {}));
+    for (size_t i = 0; i < 4; ++i) {
+      last_off = log.log_size_;
+      log.Append(LogOp::kPutBlob, BlobId(0, i));
+    }
+  }
+  std::string full = ReadBytes(log_path);
+  REQUIRE(full.size() > last_off);
+
+  SECTION("Truncated final record") {
+    WriteBytes(log_path, full.substr(0, full.size() - 3));
+  }
+  SECTION("Corrupt final record") {
+    std::string torn = full;
+    torn.back() ^= 0xff;
+    WriteBytes(log_path, torn);
+  }
+  SECTION("Final record cut in its frame") {
+    // The frame of a record is a u32 length and a u64 checksum
+    WriteBytes(log_path, full.substr(0, last_off + 5));
+  }
+
+  // The intact records are replayed and the torn one is dropped
+  MetadataLog log;
+  log.Init(dir, "lane");
+  std::vector<size_t> puts, dels;
+  REQUIRE(ReplayIds(log, puts, dels) == 3);
+  REQUIRE(puts == std::vector<size_t>{0, 1, 2});
+  RemoveLogDir(dir, "lane");
+}
+
+TEST_CASE("TestMetadataLogSnapshotGeneration") {
+  std::string dir = MakeLogDir();
+  std::string log_path = dir + "/lane.log";
+  std::string stale_log;
+  {
+    MetadataLog log;
+    log.Init(dir, "lane");
+    REQUIRE(log.Snapshot([](MetadataLog::Writer &writer) {}));
+    log.Append(LogOp::kPutBlob, BlobId(0, 1));
+    log.Append(LogOp::kPutBlob, BlobId(0, 2));
+    stale_log = ReadBytes(log_path);
+
+    // The snapshot holds the state, and the log restarts after it
+    REQUIRE(log.Snapshot([](MetadataLog::Writer &writer) {
+      writer.Append(LogOp::kPutBlob, BlobId(0, 1));
+      writer.Append(LogOp::kPutBlob, BlobId(0, 2));
+    }));
+    REQUIRE(log.gen_ == 2);
+    log.Append(LogOp::kDelBlob, BlobId(0, 1));
+  }
+
+  SECTION("Snapshot then log") {
+    MetadataLog log;
+    log.Init(dir, "lane");
+    std::vector<size_t> puts, dels;
+    REQUIRE(ReplayIds(log, puts, dels) == 3);
+    REQUIRE(log.gen_ == 2);
+    REQUIRE(puts == std::vector<size_t>{1, 2});
+    REQUIRE(dels == std::vector<size_t>{1});
+  }
+
+  SECTION("Log older than the snapshot") {
+    // A crash between renaming the snapshot and restarting the log
+    WriteBytes(log_path, stale_log);
+    MetadataLog log;
+    log.Init(dir, "lane");
+    std::vector<size_t> puts, dels;
+    REQUIRE(ReplayIds(log, puts, dels) == 2);
+    REQUIRE(log.gen_ == 2);
+    REQUIRE(puts == std::vector<size_t>{1, 2});
+    REQUIRE(dels.empty());
+  }
+  RemoveLogDir(dir, "lane");
+}
+
+/** The tags and blobs rebuilt from a log, as the metadata managers do */
+struct RecoveredMdm {
+  std::unordered_map<TagId, TagInfo> tags_;
+  std::unordered_map<BlobId, BlobInfo> blobs_;
+
+  /** Apply one record */
+  void Apply(LogOp op, cereal::BinaryInputArchive &ar) {
+    TagId tag_id;
+    BlobId blob_id;
+    switch (op) {
+      case LogOp::kPutTag: {
+        std::string url, params;
+        ar(tag_id);
+        ar(tags_[tag_id], url, params);
+        break;
+      }
+      case LogOp::kTagAddBlob: {
+        ar(tag_id, blob_id);
+        tags_[tag_id].blobs_.emplace(blob_id);
+        break;
+      }
+      case LogOp::kTagBlobs: {
+        ar(tag_id, tags_[tag_id].blobs_);
+        break;
+      }
+      case LogOp::kTagSize: {
+        ar(tag_id, tags_[tag_id].internal_size_);
+        break;
+      }
+      case LogOp::kPutBlob: {
+        ar(blob_id);
+        ar(blobs_[blob_id]);
+        break;
+      }
+      case LogOp::kDelBlob: {
+        ar(blob_id);
+        blobs_.erase(blob_id);
+        break;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+
+  /** Replay \a log into this state */
+  void Replay(MetadataLog &log) {
+    log.Replay([this](LogOp op, cereal::BinaryInputArchive &ar) {
+      Apply(op, ar);
+    });
+  }
+
+  /** Check the bucket and blob logged by TestMetadataLogRestartRoundTrip */
+  void Verify(const TagId &tag_id, const BlobId &blob_id) {
+    REQUIRE(tags_.size() == 1);
+    TagInfo &tag = tags_[tag_id];
+    REQUIRE(tag.name_.str() == "bkt");
+    REQUIRE(tag.internal_size_ == MEGABYTES(1));
+    REQUIRE(tag.blobs_.size() == 1);
+    REQUIRE(tag.blobs_.contains(blob_id));
+    REQUIRE(blobs_.size() == 1);
+    BlobInfo &blob = blobs_[blob_id];
+    REQUIRE(blob.name_.str() == "blob");
+    REQUIRE(blob.tag_id_ == tag_id);
+    REQUIRE(blob.blob_size_ == MEGABYTES(1));
+    REQUIRE(blob.buffers_.size() == 1);
+    REQUIRE(blob.buffers_[0].t_off_ == 4096);
+    REQUIRE(blob.buffers_[0].t_size_ == MEGABYTES(1));
+  }
+};
+
+TEST_CASE("TestMetadataLogRestartRoundTrip") {
+  std::string dir = MakeLogDir();
+  TagId tag_id(0, 1);
+  BlobId blob_id(0, 2);
+  {
+    MetadataLog log;
+    log.Init(dir, "lane");
+    REQUIRE(log.Snapshot([](MetadataLog::Writer &writer) {}));
+    TagInfo tag;
+    tag.tag_id_ = tag_id;
+    tag.name_ = hshm::charbuf("bkt");
+    tag.internal_size_ = 0;
+    tag.page_size_ = 0;
+    tag.owner_ = true;
+    log.Append(LogOp::kPutTag, tag_id, tag, std::string(), std::string());
+    BlobInfo blob;
+    blob.tag_id_ = tag_id;
+    blob.blob_id_ = blob_id;
+    blob.name_ = hshm::charbuf("blob");
+    hermes::BufferInfo buf;
+    buf.t_off_ = 4096;
+    buf.t_size_ = MEGABYTES(1);
+    blob.buffers_.emplace_back(buf);
+    blob.blob_size_ = MEGABYTES(1);
+    blob.max_blob_size_ = MEGABYTES(1);
+    log.Append(LogOp::kPutBlob, blob_id, blob);
+    log.Append(LogOp::kTagAddBlob, tag_id, blob_id);
+    log.Append(LogOp::kTagSize, tag_id, (size_t)MEGABYTES(1));
+
+    // A blob that was destroyed before the restart is not recovered
+    log.Append(LogOp::kPutBlob, BlobId(0, 3), blob);
+    log.Append(LogOp::kDelBlob, BlobId(0, 3));
+  }
+
+  // First restart: recover from the log
+  RecoveredMdm mdm;
+  {
+    MetadataLog log;
+    log.Init(dir, "lane");
+    mdm.Replay(log);
+    mdm.Verify(tag_id, blob_id);
+
+    // Snapshot the recovered state, as recovery does
+    REQUIRE(log.Snapshot([&](MetadataLog::Writer &writer) {
+      for (auto &tag_part : mdm.tags_) {
+        writer.Append(LogOp::kPutTag, tag_part.first, tag_part.second,
+                      std::string(), std::string());
+        writer.Append(LogOp::kTagBlobs, tag_part.first,
+                      tag_part.second.blobs_);
+        writer.Append(LogOp::kTagSize, tag_part.first,
+                      tag_part.second.internal_size_);
+      }
+      for (auto &blob_part : mdm.blobs_) {
+        writer.Append(LogOp::kPutBlob, blob_part.first, blob_part.second);
+      }
+    }));
+  }
+
+  // Second restart: recover from the snapshot
+  RecoveredMdm mdm2;
+  MetadataLog log;
+  log.Init(dir, "lane");
+  mdm2.Replay(log);
+  REQUIRE(log.gen_ == 2);
+  mdm2.Verify(tag_id, blob_id);
+  RemoveLogDir(dir, "lane");
+}
@@ -27,6 +27,11 @@ using hermes::BlobInfo;
 using hermes::TargetStats;
 using hermes::TagInfo;
 using hermes::MetadataTable;
+using hermes::MetadataCursor;
+using hermes::BlobQuery;
+using hermes::BlobStat;
+using hermes::TagQuery;
+using hermes::TagStat;
 using hermes::Hermes;
 using hrun::UniqueId;
 
@@ -91,7 +96,9 @@ void BindTargetStats(py::module &m) {
       .def_readonly("max_cap", &TargetStats::max_cap_)
       .def_readonly("bandwidth", &TargetStats::bandwidth_)
       .def_readonly("latency", &TargetStats::latency_)
-      .def_readonly("score", &TargetStats::score_);
+      .def_readonly("score", &TargetStats::score_)
+      .def_readonly("bg_deferred", &TargetStats::bg_deferred_)
+      .def_readonly("bg_executed", &TargetStats::bg_executed_);
 }
 
 void BindTagInfo(py::module &m) {
@@ -99,7 +106,8 @@ void BindTagInfo(py::module &m) {
       .def(py::init<>())
       .def_readonly("tag_id", &TagInfo::tag_id_)
       .def("get_name", &TagInfo::GetName)
-      .def_readonly("blobs", &TagInfo::blobs_)
+      .def_property_readonly(
+          "blobs", [](const TagInfo &self) { return self.blobs_.ids(); })
       .def_readonly("traits", &TagInfo::traits_)
       .def_readonly("internal_size", &TagInfo::internal_size_)
       .def_readonly("page_size", &TagInfo::page_size_)
@@ -114,13 +122,69 @@ void BindMetadataTable(py::module &m) {
       .def_readonly("bkt_info", &MetadataTable::bkt_info_);
 }
 
+void BindMetadataCursor(py::module &m) {
+  py::class_<MetadataCursor>(m, "MetadataCursor")
+      .def(py::init<>())
+      .def_readonly("node_id", &MetadataCursor::node_id_)
+      .def_readonly("lane", &MetadataCursor::lane_)
+      .def_readonly("slot", &MetadataCursor::slot_)
+      .def_readonly("done", &MetadataCursor::done_);
+}
+
+void BindBlobQuery(py::module &m) {
+  py::class_<BlobQuery>(m, "BlobQuery")
+      .def(py::init<>())
+      .def_readwrite("tag_id", &BlobQuery::tag_id_)
+      .def_readwrite("tgt_id", &BlobQuery::tgt_id_)
+      .def_readwrite("min_score", &BlobQuery::min_score_)
+      .def_readwrite("dirty_only", &BlobQuery::dirty_only_)
+      .def_readwrite("name_prefix", &BlobQuery::name_prefix_)
+      .def_readwrite("page_size", &BlobQuery::page_size_);
+}
+
+void BindBlobStat(py::module &m) {
+  py::class_<BlobStat>(m, "BlobStat")
+      .def(py::init<>())
+      .def_readonly("blob_id", &BlobStat::blob_id_)
+      .def_readonly("tag_id", &BlobStat::tag_id_)
+      .def_readonly("tgt_id", &BlobStat::tgt_id_)
+      .def_readonly("blob_size", &BlobStat::blob_size_)
+      .def_readonly("score", &BlobStat::score_)
+      .def_readonly("user_score", &BlobStat::user_score_)
+      .def_readonly("access_freq", &BlobStat::access_freq_)
+      .def_readonly("num_buffers", &BlobStat::num_buffers_)
+      .def_readonly("mod_count", &BlobStat::mod_count_)
+      .def_readonly("last_flush", &BlobStat::last_flush_);
+}
+
+void BindTagQuery(py::module &m) {
+  py::class_<TagQuery>(m, "TagQuery")
+      .def(py::init<>())
+      .def_readwrite("min_size", &TagQuery::min_size_)
+      .def_readwrite("name_prefix", &TagQuery::name_prefix_)
+      .def_readwrite("page_size", &TagQuery::page_size_);
+}
+
+void BindTagStat(py::module &m) {
+  py::class_<TagStat>(m, "TagStat")
+      .def(py::init<>())
+      .def_readonly("tag_id", &TagStat::tag_id_)
+      .def_readonly("internal_size", &TagStat::internal_size_)
+      .def_readonly("page_size", &TagStat::page_size_)
+      .def_readonly("num_blobs", &TagStat::num_blobs_)
+      .def_readonly("flags", &TagStat::flags_)
+      .def_readonly("owner", &TagStat::owner_);
+}
+
 void BindHermes(py::module &m) {
   py::class_<Hermes>(m, "Hermes")
       .def(py::init<>())
       .def("ClientInit", &Hermes::ClientInit)
       .def("IsInitialized", &Hermes::IsInitialized)
       .def("GetTagId", &Hermes::GetTagId)
-      .def("CollectMetadataSnapshot", &Hermes::CollectMetadataSnapshot);
+      .def("CollectMetadataSnapshot", &Hermes::CollectMetadataSnapshot)
+      .def("PollBlobMetadata", &Hermes::PollBlobMetadata)
+      .def("PollTagMetadata", &Hermes::PollTagMetadata);
   m.def("TRANSPARENT_HERMES", &TRANSPARENT_HERMES_FUN);
 }
 
@@ -134,5 +198,10 @@ PYBIND11_MODULE(py_hermes, m) {
   BindTargetStats(m);
   BindTagInfo(m);
   BindMetadataTable(m);
+  BindMetadataCursor(m);
+  BindBlobQuery(m);
+  BindBlobStat(m);
+  BindTagQuery(m);
+  BindTagStat(m);
   BindHermes(m);
 }
@@ -1,5 +1,5 @@
 
-from py_hermes import Hermes, TRANSPARENT_HERMES
+from py_hermes import Hermes, TRANSPARENT_HERMES, MetadataCursor, BlobQuery, TagQuery
 class MetadataSnapshot:
     def __init__(self):
         TRANSPARENT_HERMES()
@@ -66,6 +66,49 @@ class MetadataSnapshot:
                 tag_info['blobs'] = tag_to_blob[tag_info['id']]
             self.tag_info.append(tag_info)
 
+    def poll_blobs(self, tag_id=None, tgt_id=None, min_score=0,
+                   dirty_only=False, name_prefix='', page_size=1024):
+        """Yield pages of blob summaries, filtered by the servers"""
+        query = BlobQuery()
+        if tag_id is not None:
+            query.tag_id = tag_id
+        if tgt_id is not None:
+            query.tgt_id = tgt_id
+        query.min_score = min_score
+        query.dirty_only = dirty_only
+        query.name_prefix = name_prefix
+        query.page_size = page_size
+        cursor = MetadataCursor()
+        while not cursor.done:
+            page = self.hermes.PollBlobMetadata(query, cursor)
+            yield [{
+                'id': self.unique(blob.blob_id),
+                'mdm_node': int(blob.blob_id.node_id),
+                'tag_id': self.unique(blob.tag_id),
+                'target_id': self.unique(blob.tgt_id),
+                'size': int(blob.blob_size),
+                'score': float(blob.score),
+                'access_frequency': int(blob.access_freq),
+                'dirty': blob.last_flush > 0 and
+                         blob.mod_count > blob.last_flush,
+            } for blob in page]
+
+    def poll_tags(self, min_size=0, name_prefix='', page_size=1024):
+        """Yield pages of tag summaries, filtered by the servers"""
+        query = TagQuery()
+        query.min_size = min_size
+        query.name_prefix = name_prefix
+        query.page_size = page_size
+        cursor = MetadataCursor()
+        while not cursor.done:
+            page = self.hermes.PollTagMetadata(query, cursor)
+            yield [{
+                'id': self.unique(tag.tag_id),
+                'mdm_node': int(tag.tag_id.node_id),
+                'size': int(tag.internal_size),
+                'num_blobs': int(tag.num_blobs),
+            } for tag in page]
+
 # mdm = MetadataSnapshot()
 # mdm.collect()
 # print('Done')